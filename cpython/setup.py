@@ -32,6 +32,7 @@ setup(
     license = 'AGPL',
     packages=['topologic'],
     package_dir={'': '.'},
+    package_data={'topologic': list(copy_dir('include'))},
     install_requires=[
         'cppyy>=1.3.0'
     ]
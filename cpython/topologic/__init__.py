@@ -27,6 +27,10 @@ headers = [
 "Attribute.h",
 "AttributeManager.h",
 "Bitwise.h",
+"BooleanCache.h",
+"BooleanOptions.h",
+"BooleanSession.h",
+"BoundingBoxCache.h",
 "Cell.h",
 "CellComplex.h",
 "CellComplexFactory.h",
@@ -45,20 +49,29 @@ headers = [
 "Geometry.h",
 "GlobalCluster.h",
 "Graph.h",
+"GraphCentrality.h",
+"GraphIndex.h",
 "InstanceGUIDManager.h",
 "IntAttribute.h",
 "Line.h",
 "ListAttribute.h",
+"NavigationScratch.h",
 "NurbsCurve.h",
 "NurbsSurface.h",
 "PlanarSurface.h",
+"ProgressToken.h",
+"ShapeValidityCache.h",
 "Shell.h",
 "ShellFactory.h",
 "StringAttribute.h",
 "Surface.h",
 "TopologicalQuery.h",
 "Topology.h",
+"TopologyAllocator.h",
 "TopologyFactory.h",
+"TopologyFilter.h",
+"TopologyMap.h",
+"TopologySet.h",
 "TopologyFactoryManager.h",
 "Utilities.h",
 "Utilities.h",
@@ -74,20 +87,26 @@ headers = [
 "Utilities/WireUtility.h",
 "Vertex.h",
 "VertexFactory.h",
+"VertexGrid.h",
 "Wire.h",
 "WireFactory.h"
 ]
 
 
 system = platform.system()
+base_dir = os.path.dirname(os.path.realpath(__file__))
+# The headers shipped with this module carry inline extensions to TopologicCore
+# and take precedence over the ones installed alongside the library.
+bundled_inc = os.path.join(base_dir, "include")
 if system != 'Windows':
     if (os.path.isdir("/usr/local/include/opencascade")):
         cppyy.add_include_path("/usr/local/include/opencascade")
     elif (os.path.isdir("/usr/include/opencascade")):
         cppyy.add_include_path("/usr/include/opencascade")
-    base_dir = os.path.dirname(os.path.realpath(__file__))
 
-    if (os.path.isdir("/usr/local/include/TopologicCore")):
+    if (os.path.isdir(bundled_inc)):
+        topologic_inc = bundled_inc
+    elif (os.path.isdir("/usr/local/include/TopologicCore")):
         topologic_inc = "/usr/local/include/TopologicCore"
     elif (os.path.isdir("/usr/include/TopologicCore")):
         topologic_inc = "/usr/include/TopologicCore"
@@ -95,7 +114,10 @@ if system != 'Windows':
         cppyy.add_library_path("/usr/local/lib")
 else:
     win_prefix = "E:/Documents/Projects/TopologicFinal/topologic"
-    topologic_inc = "{}/TopologicCore/include".format( win_prefix )
+    if (os.path.isdir(bundled_inc)):
+        topologic_inc = bundled_inc
+    else:
+        topologic_inc = "{}/TopologicCore/include".format( win_prefix )
     opencascade_prefix = "C:/OpenCASCADE-7.4.0-vc14-64"
     cppyy.add_include_path("{}/opencascade-7.4.0/inc".format(opencascade_prefix))
     cppyy.add_library_path("{}/output/x64/Release".format(win_prefix))
@@ -109,6 +131,16 @@ for header in headers:
 
 cppyy.load_library("TopologicCore")
 
+# Topologies hash and compare by the identity of their TShape, as Topology::IsSame does,
+# so that they can be put in Python sets and used as dictionary keys.
+def _pythonize_topologies(klass, name):
+    if hasattr(klass, "IsSame") and hasattr(klass, "GetOcctShape"):
+        klass.__hash__ = lambda self: _hash_occt_shape(self.GetOcctShape())
+        klass.__eq__ = lambda self, other: isinstance(other, Topology) and self.IsSame(other)
+        klass.__ne__ = lambda self, other: not (isinstance(other, Topology) and self.IsSame(other))
+
+cppyy.py.add_pythonization(_pythonize_topologies, "TopologicCore")
+
 from cppyy.gbl import TopologicCore
 from cppyy.gbl import TopologicUtilities
 Aperture = TopologicCore.Aperture
@@ -116,11 +148,15 @@ ApertureFactory = TopologicCore.ApertureFactory
 Attribute = TopologicCore.Attribute
 AttributeManager = TopologicCore.AttributeManager
 #Bitwise = TopologicCore.Bitwise
+BooleanCache = TopologicCore.BooleanCache
+BooleanOptions = TopologicCore.BooleanOptions
+BooleanSession = TopologicCore.BooleanSession
 Cell = TopologicCore.Cell
 CellComplex = TopologicCore.CellComplex
 CellComplexFactory = TopologicCore.CellComplexFactory
 CellFactory = TopologicCore.CellFactory
 CellUtility = TopologicUtilities.CellUtility
+CentralityOptions = TopologicCore.CentralityOptions
 Cluster = TopologicCore.Cluster
 ClusterFactory = TopologicCore.ClusterFactory
 ContentManager = TopologicCore.ContentManager
@@ -136,6 +172,8 @@ FaceFactory = TopologicCore.FaceFactory
 FaceUtility = TopologicUtilities.FaceUtility
 Geometry = TopologicCore.Geometry
 Graph = TopologicCore.Graph
+GraphCentrality = TopologicCore.GraphCentrality
+GraphIndex = TopologicCore.GraphIndex
 InstanceGUIDManager = TopologicCore.InstanceGUIDManager
 IntAttribute = TopologicCore.IntAttribute
 Line = TopologicCore.Line
@@ -143,6 +181,8 @@ ListAttribute = TopologicCore.ListAttribute
 NurbsCurve = TopologicCore.NurbsCurve
 NurbsSurface = TopologicCore.NurbsSurface
 PlanarSurface = TopologicCore.PlanarSurface
+ProgressToken = TopologicCore.ProgressToken
+ShapeValidityCache = TopologicCore.ShapeValidityCache
 Shell = TopologicCore.Shell
 ShellFactory = TopologicCore.ShellFactory
 ShellUtility = TopologicUtilities.ShellUtility
@@ -150,18 +190,25 @@ StringAttribute = TopologicCore.StringAttribute
 Surface = TopologicCore.Surface
 TopologicalQuery = TopologicCore.TopologicalQuery
 Topology = TopologicCore.Topology
+TopologyArena = TopologicCore.TopologyArena
 TopologyFactory = TopologicCore.TopologyFactory
 TopologyFactoryManager = TopologicCore.TopologyFactoryManager
+TopologyFilter = TopologicCore.TopologyFilter
+TopologyMap = TopologicCore.TopologyMap
+TopologySet = TopologicCore.TopologySet
 TopologyUtility = TopologicUtilities.TopologyUtility
 TransformationMatrix2D = TopologicUtilities.TransformationMatrix2D
 Vector = TopologicUtilities.Vector
 Vertex = TopologicCore.Vertex
 VertexFactory = TopologicCore.VertexFactory
+VertexGrid = TopologicCore.VertexGrid
 VertexUtility = TopologicUtilities.VertexUtility
 Wire = TopologicCore.Wire
 WireFactory = TopologicCore.WireFactory
 WireUtility = TopologicUtilities.WireUtility
 
+_hash_occt_shape = TopologicCore.TopologyHasher.Hash
+
 # Define structs to retrieve int, double, and string values
 # Create an Integer Structure
 cppyy.cppdef("""
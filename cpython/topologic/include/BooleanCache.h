@@ -0,0 +1,514 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+#include "BooleanOptions.h"
+
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Builder.hxx>
+#include <Standard_Version.hxx>
+#include <TopoDS_Shape.hxx>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <list>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// Least-recently-used cache of boolean results, keyed by the geometric content of both operands, the operation and
+	/// its options. Each entry holds the result shape and the images of the operands' sub-shapes in it, as pairs of
+	/// indices in the order of TopExp::MapShapes (those of the second operand follow those of the first), so that the
+	/// dictionaries of later, geometrically identical operands can be reattached to a copy of the result.
+	/// Entries evicted from memory can be kept in a directory as BREP files; the files are read and written outside the
+	/// lock, and only the most recent ones written by this process are kept.
+	/// </summary>
+	class BooleanCache
+	{
+	public:
+		typedef std::vector<std::pair<int, int>> ImageIndices;
+
+		static BooleanCache& GetInstance()
+		{
+			static BooleanCache instance;
+			return instance;
+		}
+
+		/// <summary>
+		/// Returns the key of a boolean: the SHA-256 digest of the BREP content of the operands, the operation and the
+		/// options. Operands built the same way hash the same regardless of their TShapes, dictionaries and meshes, since
+		/// the BREP is written without triangulations. The BREP text is hashed as it is written, without being kept in
+		/// memory; at 256 bits, a hit is taken as a match.
+		/// </summary>
+		/// <param name="rkOcctShapeA"></param>
+		/// <param name="rkOcctShapeB"></param>
+		/// <param name="kOperationType"></param>
+		/// <param name="rkOptions"></param>
+		/// <returns></returns>
+		static std::string Key(
+			const TopoDS_Shape& rkOcctShapeA,
+			const TopoDS_Shape& rkOcctShapeB,
+			const BooleanOperationType kOperationType,
+			const BooleanOptions& rkOptions)
+		{
+			HashBuffer hashBuffer;
+			std::ostream contentStream(&hashBuffer);
+			contentStream << std::setprecision(17);
+			WriteContent(rkOcctShapeA, contentStream);
+			contentStream << "\n#\n";
+			WriteContent(rkOcctShapeB, contentStream);
+			contentStream << "\n#\n" << (int)kOperationType
+				<< " " << rkOptions.fuzzyValue
+				<< " " << (int)rkOptions.glue
+				<< " " << rkOptions.useOBB
+				<< " " << rkOptions.nonDestructive
+				<< " " << rkOptions.broadPhase
+				<< " " << rkOptions.fixValidOperands;
+			contentStream.flush();
+
+			uint32_t digest[8];
+			hashBuffer.Finish(digest);
+			std::ostringstream keyStream;
+			keyStream << std::hex << std::setfill('0');
+			for (const uint32_t kWord : digest)
+			{
+				keyStream << std::setw(8) << kWord;
+			}
+			return keyStream.str();
+		}
+
+		/// <summary>
+		/// Finds a result in memory, then on disk. A null result means that the boolean returned nothing.
+		/// </summary>
+		/// <param name="rkKey"></param>
+		/// <param name="rOcctResult"></param>
+		/// <param name="rImageIndices"></param>
+		/// <returns>True if the key was found</returns>
+		bool Find(const std::string& rkKey, TopoDS_Shape& rOcctResult, ImageIndices& rImageIndices)
+		{
+			std::string diskDirectory;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				auto entryIterator = m_entries.find(rkKey);
+				if (entryIterator != m_entries.end())
+				{
+					m_keys.splice(m_keys.begin(), m_keys, entryIterator->second.keyIterator);
+					rOcctResult = entryIterator->second.occtResult;
+					rImageIndices = entryIterator->second.imageIndices;
+					return true;
+				}
+				diskDirectory = m_diskDirectory;
+			}
+
+			if (diskDirectory.empty() || !ReadEntry(diskDirectory, rkKey, rOcctResult, rImageIndices))
+			{
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			AddEntry(rkKey, rOcctResult, rImageIndices);
+			return true;
+		}
+
+		/// <summary>
+		/// Adds a copy of a result, evicting the least recently used entries beyond the capacity, so that later edits of
+		/// the caller's shape do not reach the cache.
+		/// </summary>
+		/// <param name="rkKey"></param>
+		/// <param name="rkOcctResult"></param>
+		/// <param name="rkImageIndices"></param>
+		void Add(const std::string& rkKey, const TopoDS_Shape& rkOcctResult, const ImageIndices& rkImageIndices)
+		{
+			// The copy keeps the sub-shapes in the same order, so the image indices still apply.
+			TopoDS_Shape occtResult;
+			if (!rkOcctResult.IsNull())
+			{
+				occtResult = BRepBuilderAPI_Copy(rkOcctResult).Shape();
+			}
+
+			std::string diskDirectory;
+			std::list<std::string> evictedDiskKeys;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (!AddEntry(rkKey, occtResult, rkImageIndices) || m_diskDirectory.empty() || m_diskKeys.count(rkKey) != 0)
+				{
+					return;
+				}
+				diskDirectory = m_diskDirectory;
+				m_diskKeys.insert(rkKey);
+				m_diskKeyOrder.push_back(rkKey);
+				while (m_diskKeyOrder.size() > m_diskCapacity)
+				{
+					m_diskKeys.erase(m_diskKeyOrder.front());
+					evictedDiskKeys.push_back(m_diskKeyOrder.front());
+					m_diskKeyOrder.pop_front();
+				}
+			}
+
+			WriteEntry(diskDirectory, rkKey, occtResult, rkImageIndices);
+			for (const std::string& rkEvictedKey : evictedDiskKeys)
+			{
+				RemoveEntry(diskDirectory, rkEvictedKey);
+			}
+		}
+
+		/// <summary>
+		/// Sets the maximum number of results kept in memory.
+		/// </summary>
+		/// <param name="kCapacity"></param>
+		void SetCapacity(const size_t kCapacity)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_capacity = kCapacity;
+			Evict();
+		}
+
+		/// <summary>
+		/// Sets the directory where the results are also written, and read from on a miss in memory.
+		/// An empty path disables the disk tier.
+		/// </summary>
+		/// <param name="rkDirectory">An existing directory</param>
+		void SetDiskDirectory(const std::string& rkDirectory)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_diskDirectory = rkDirectory;
+			m_diskKeys.clear();
+			m_diskKeyOrder.clear();
+		}
+
+		/// <summary>
+		/// Sets the maximum number of results written to the disk directory by this process. Beyond it, the oldest files
+		/// written are deleted; files left by other processes are not counted.
+		/// </summary>
+		/// <param name="kDiskCapacity"></param>
+		void SetDiskCapacity(const size_t kDiskCapacity)
+		{
+			std::list<std::string> evictedDiskKeys;
+			std::string diskDirectory;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_diskCapacity = kDiskCapacity;
+				while (m_diskKeyOrder.size() > m_diskCapacity)
+				{
+					m_diskKeys.erase(m_diskKeyOrder.front());
+					evictedDiskKeys.push_back(m_diskKeyOrder.front());
+					m_diskKeyOrder.pop_front();
+				}
+				diskDirectory = m_diskDirectory;
+			}
+
+			for (const std::string& rkEvictedKey : evictedDiskKeys)
+			{
+				RemoveEntry(diskDirectory, rkEvictedKey);
+			}
+		}
+
+		/// <summary>
+		/// Empties the memory tier. The files on disk are left as they are.
+		/// </summary>
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_entries.clear();
+			m_keys.clear();
+		}
+
+		size_t Size()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_entries.size();
+		}
+
+	protected:
+		struct Entry
+		{
+			TopoDS_Shape occtResult;
+			ImageIndices imageIndices;
+			std::list<std::string>::iterator keyIterator;
+		};
+
+		/// <summary>
+		/// Writes a shape in the BREP format without its triangulations, which depend on how it was last displayed or
+		/// meshed rather than on its geometry.
+		/// </summary>
+		static void WriteContent(const TopoDS_Shape& rkOcctShape, std::ostream& rContentStream)
+		{
+#if OCC_VERSION_HEX >= 0x070600
+			BRepTools::Write(rkOcctShape, rContentStream, Standard_False, Standard_False, TopTools_FormatVersion_CURRENT);
+#else
+			// Older versions always write the triangulations: write a copy without them, which shares the geometry.
+			BRepTools::Write(rkOcctShape.IsNull() ? rkOcctShape : BRepBuilderAPI_Copy(rkOcctShape, Standard_False, Standard_False).Shape(), rContentStream);
+#endif
+		}
+
+		/// <summary>
+		/// Output buffer computing the SHA-256 digest (FIPS 180-4) of the characters written to it.
+		/// </summary>
+		class HashBuffer : public std::streambuf
+		{
+		public:
+			HashBuffer()
+				: m_numOfBlockBytes(0)
+				, m_numOfBytes(0)
+			{
+				static const uint32_t kInitialState[8] = {
+					0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+				std::copy(kInitialState, kInitialState + 8, m_state);
+			}
+
+			/// <summary>
+			/// Pads the message and returns the digest. No character may be added afterwards.
+			/// </summary>
+			/// <param name="rDigest"></param>
+			void Finish(uint32_t rDigest[8])
+			{
+				const uint64_t kNumOfBits = m_numOfBytes * 8;
+				Add((char)0x80);
+				while (m_numOfBlockBytes != 56)
+				{
+					Add((char)0);
+				}
+				for (int i = 7; i >= 0; --i)
+				{
+					Add((char)(kNumOfBits >> (8 * i)));
+				}
+				std::copy(m_state, m_state + 8, rDigest);
+			}
+
+		protected:
+			virtual int_type overflow(int_type character) override
+			{
+				if (!traits_type::eq_int_type(character, traits_type::eof()))
+				{
+					Add(traits_type::to_char_type(character));
+				}
+				return traits_type::not_eof(character);
+			}
+
+			virtual std::streamsize xsputn(const char* kpCharacters, std::streamsize numOfCharacters) override
+			{
+				for (std::streamsize i = 0; i < numOfCharacters; ++i)
+				{
+					Add(kpCharacters[i]);
+				}
+				return numOfCharacters;
+			}
+
+			void Add(const char kCharacter)
+			{
+				m_block[m_numOfBlockBytes++] = (unsigned char)kCharacter;
+				++m_numOfBytes;
+				if (m_numOfBlockBytes == 64)
+				{
+					Compress();
+					m_numOfBlockBytes = 0;
+				}
+			}
+
+			static uint32_t RotateRight(const uint32_t kWord, const int kNumOfBits)
+			{
+				return (kWord >> kNumOfBits) | (kWord << (32 - kNumOfBits));
+			}
+
+			void Compress()
+			{
+				static const uint32_t kRoundConstants[64] = {
+					0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+					0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+					0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+					0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+					0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+					0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+					0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+					0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+
+				uint32_t schedule[64];
+				for (int i = 0; i < 16; ++i)
+				{
+					schedule[i] = ((uint32_t)m_block[4 * i] << 24) | ((uint32_t)m_block[4 * i + 1] << 16)
+						| ((uint32_t)m_block[4 * i + 2] << 8) | (uint32_t)m_block[4 * i + 3];
+				}
+				for (int i = 16; i < 64; ++i)
+				{
+					const uint32_t kSigma0 = RotateRight(schedule[i - 15], 7) ^ RotateRight(schedule[i - 15], 18) ^ (schedule[i - 15] >> 3);
+					const uint32_t kSigma1 = RotateRight(schedule[i - 2], 17) ^ RotateRight(schedule[i - 2], 19) ^ (schedule[i - 2] >> 10);
+					schedule[i] = schedule[i - 16] + kSigma0 + schedule[i - 7] + kSigma1;
+				}
+
+				uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+				uint32_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+				for (int i = 0; i < 64; ++i)
+				{
+					const uint32_t kTemporary1 = h + (RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25))
+						+ ((e & f) ^ (~e & g)) + kRoundConstants[i] + schedule[i];
+					const uint32_t kTemporary2 = (RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22))
+						+ ((a & b) ^ (a & c) ^ (b & c));
+					h = g;
+					g = f;
+					f = e;
+					e = d + kTemporary1;
+					d = c;
+					c = b;
+					b = a;
+					a = kTemporary1 + kTemporary2;
+				}
+				m_state[0] += a;
+				m_state[1] += b;
+				m_state[2] += c;
+				m_state[3] += d;
+				m_state[4] += e;
+				m_state[5] += f;
+				m_state[6] += g;
+				m_state[7] += h;
+			}
+
+			uint32_t m_state[8];
+			unsigned char m_block[64];
+			int m_numOfBlockBytes;
+			uint64_t m_numOfBytes;
+		};
+
+		BooleanCache()
+			: m_capacity(256)
+			, m_diskCapacity(4096)
+		{
+		}
+
+		/// <summary>
+		/// Adds an entry to the memory tier, or marks an existing one as recently used.
+		/// </summary>
+		/// <returns>True if the entry is new</returns>
+		bool AddEntry(const std::string& rkKey, const TopoDS_Shape& rkOcctResult, const ImageIndices& rkImageIndices)
+		{
+			auto entryIterator = m_entries.find(rkKey);
+			if (entryIterator != m_entries.end())
+			{
+				m_keys.splice(m_keys.begin(), m_keys, entryIterator->second.keyIterator);
+				return false;
+			}
+
+			m_keys.push_front(rkKey);
+			Entry& rEntry = m_entries[rkKey];
+			rEntry.occtResult = rkOcctResult;
+			rEntry.imageIndices = rkImageIndices;
+			rEntry.keyIterator = m_keys.begin();
+			Evict();
+			return true;
+		}
+
+		void Evict()
+		{
+			while (m_entries.size() > m_capacity)
+			{
+				m_entries.erase(m_keys.back());
+				m_keys.pop_back();
+			}
+		}
+
+		static std::string EntryPath(const std::string& rkDirectory, const std::string& rkKey, const std::string& rkExtension)
+		{
+			return rkDirectory + "/" + rkKey + rkExtension;
+		}
+
+		/// <summary>
+		/// Writes the BREP file, then the images file under a temporary name renamed at the end, so that a reader never
+		/// sees an entry whose images file is incomplete.
+		/// </summary>
+		static void WriteEntry(const std::string& rkDirectory, const std::string& rkKey, const TopoDS_Shape& rkOcctResult, const ImageIndices& rkImageIndices)
+		{
+			if (!rkOcctResult.IsNull() && !BRepTools::Write(rkOcctResult, EntryPath(rkDirectory, rkKey, ".brep").c_str()))
+			{
+				return;
+			}
+
+			const std::string kTemporaryPath = EntryPath(rkDirectory, rkKey, ".images.tmp");
+			{
+				std::ofstream imagesStream(kTemporaryPath);
+				if (!imagesStream)
+				{
+					return;
+				}
+
+				imagesStream << (rkOcctResult.IsNull() ? 0 : 1) << " " << rkImageIndices.size() << "\n";
+				for (const std::pair<int, int>& rkImageIndex : rkImageIndices)
+				{
+					imagesStream << rkImageIndex.first << " " << rkImageIndex.second << "\n";
+				}
+			}
+			std::rename(kTemporaryPath.c_str(), EntryPath(rkDirectory, rkKey, ".images").c_str());
+		}
+
+		static void RemoveEntry(const std::string& rkDirectory, const std::string& rkKey)
+		{
+			std::remove(EntryPath(rkDirectory, rkKey, ".images").c_str());
+			std::remove(EntryPath(rkDirectory, rkKey, ".brep").c_str());
+		}
+
+		static bool ReadEntry(const std::string& rkDirectory, const std::string& rkKey, TopoDS_Shape& rOcctResult, ImageIndices& rImageIndices)
+		{
+			std::ifstream imagesStream(EntryPath(rkDirectory, rkKey, ".images"));
+			int hasResult = 0;
+			size_t numOfImageIndices = 0;
+			if (!(imagesStream >> hasResult >> numOfImageIndices))
+			{
+				return false;
+			}
+
+			rOcctResult.Nullify();
+			if (hasResult != 0)
+			{
+				BRep_Builder occtBuilder;
+				if (!BRepTools::Read(rOcctResult, EntryPath(rkDirectory, rkKey, ".brep").c_str(), occtBuilder))
+				{
+					return false;
+				}
+			}
+
+			rImageIndices.clear();
+			rImageIndices.reserve(numOfImageIndices);
+			std::pair<int, int> imageIndex;
+			while (rImageIndices.size() < numOfImageIndices && imagesStream >> imageIndex.first >> imageIndex.second)
+			{
+				rImageIndices.push_back(imageIndex);
+			}
+			return rImageIndices.size() == numOfImageIndices;
+		}
+
+		std::mutex m_mutex;
+		size_t m_capacity;
+		size_t m_diskCapacity;
+		std::string m_diskDirectory;
+		std::list<std::string> m_keys;
+		std::unordered_map<std::string, Entry> m_entries;
+		std::list<std::string> m_diskKeyOrder;
+		std::unordered_set<std::string> m_diskKeys;
+	};
+}
@@ -0,0 +1,119 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+#include "ProgressToken.h"
+
+#include <BOPAlgo_GlueEnum.hxx>
+
+namespace TopologicCore
+{
+	enum BooleanOperationType
+	{
+		BOOLEAN_DIFFERENCE,
+		BOOLEAN_IMPOSE,
+		BOOLEAN_IMPRINT,
+		BOOLEAN_INTERSECT,
+		BOOLEAN_MERGE,
+		BOOLEAN_SLICE,
+		BOOLEAN_UNION,
+		BOOLEAN_XOR
+	};
+
+	/// <summary>
+	/// Settings passed to the OCCT boolean algorithms. The defaults are OCCT's own defaults.
+	/// </summary>
+	struct BooleanOptions
+	{
+		BooleanOptions()
+			: runParallel(false)
+			, fuzzyValue(0.0)
+			, glue(BOPAlgo_GlueOff)
+			, useOBB(false)
+			, nonDestructive(false)
+			, broadPhase(false)
+			, useCache(false)
+			, fixValidOperands(true)
+		{
+		}
+
+		/// <summary>
+		/// Applies the options to a BOPAlgo_Builder or a BRepAlgoAPI_BuilderAlgo (e.g. BOPAlgo_CellsBuilder,
+		/// BRepAlgoAPI_BooleanOperation). Must be called before Perform().
+		/// </summary>
+		/// <param name="rOcctAlgorithm"></param>
+		template <class OcctAlgorithm>
+		void Apply(OcctAlgorithm& rOcctAlgorithm) const
+		{
+			rOcctAlgorithm.SetRunParallel(runParallel);
+			rOcctAlgorithm.SetFuzzyValue(fuzzyValue);
+			rOcctAlgorithm.SetGlue(glue);
+			rOcctAlgorithm.SetUseOBB(useOBB);
+			rOcctAlgorithm.SetNonDestructive(nonDestructive);
+		}
+
+		/// <summary>
+		/// Runs the intersection and building phases on the OCCT thread pool.
+		/// </summary>
+		bool runParallel;
+
+		/// <summary>
+		/// Additional tolerance used to treat nearly coincident sub-shapes as coincident.
+		/// </summary>
+		double fuzzyValue;
+
+		/// <summary>
+		/// Gluing mode for operands sharing coincident (BOPAlgo_GlueShift) or identical (BOPAlgo_GlueFull) sub-shapes.
+		/// </summary>
+		BOPAlgo_GlueEnum glue;
+
+		/// <summary>
+		/// Filters the interfering pairs with oriented bounding boxes in addition to axis-aligned ones.
+		/// </summary>
+		bool useOBB;
+
+		/// <summary>
+		/// Leaves the operands untouched, copying the sub-shapes that would otherwise be modified.
+		/// </summary>
+		bool nonDestructive;
+
+		/// <summary>
+		/// Before a boolean involving a Cluster, compares the bounding boxes of the members of each operand with those
+		/// of the other operand and leaves the disjoint members out of the intersection. They are added back to the result
+		/// unchanged (or dropped, if the operation discards them), so they are not merged with each other either.
+		/// </summary>
+		bool broadPhase;
+
+		/// <summary>
+		/// Looks the result up in the BooleanCache before running the boolean, and adds it afterwards.
+		/// </summary>
+		bool useCache;
+
+		/// <summary>
+		/// Heals every operand before the boolean, as the plain booleans do; this is the default. If false, the operands
+		/// that the ShapeValidityCache finds valid are passed to OCCT as they are.
+		/// </summary>
+		bool fixValidOperands;
+
+		/// <summary>
+		/// Reports the progress of the intersection and building phases and stops them when cancelled, in which case
+		/// the boolean throws. Null by default.
+		/// </summary>
+		ProgressToken::Ptr progressToken;
+	};
+}
@@ -0,0 +1,231 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+#include "Topology.h"
+#include "BooleanOptions.h"
+
+#include <BOPAlgo_CellsBuilder.hxx>
+#include <Standard_Failure.hxx>
+#include <TopTools_DataMapOfShapeShape.hxx>
+#include <TopTools_ListOfShape.hxx>
+
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// Runs the intersection phase of a boolean between two topologies once, then derives any number of results
+	/// from the shared split by selecting its parts. E.g. Union, Difference and Intersect of the same operands
+	/// cost roughly one boolean.
+	/// </summary>
+	class BooleanSession
+	{
+	public:
+		typedef std::shared_ptr<BooleanSession> Ptr;
+
+	public:
+		BooleanSession(const Topology::Ptr& kpTopologyA, const Topology::Ptr& kpTopologyB, const BooleanOptions& rkOptions = BooleanOptions())
+			: m_pTopologyA(kpTopologyA)
+			, m_pTopologyB(kpTopologyB)
+			, m_hasMaterials(false)
+		{
+			if (kpTopologyA == nullptr || kpTopologyB == nullptr)
+			{
+				throw std::runtime_error("A boolean session needs two topologies.");
+			}
+
+			try
+			{
+				m_pTopologyA->NonRegularBooleanOperation(
+					m_pTopologyB, rkOptions, m_occtCellsBuilder,
+					m_occtArgumentsA, m_occtArgumentsB,
+					m_occtMapFaceToFixedFaceA, m_occtMapFaceToFixedFaceB);
+			}
+			catch (Standard_Failure& e)
+			{
+				throw std::runtime_error(e.GetMessageString());
+			}
+
+			for (TopTools_ListIteratorOfListOfShape occtArgumentIterator(m_occtArgumentsA); occtArgumentIterator.More(); occtArgumentIterator.Next())
+			{
+				m_occtArguments.push_back(occtArgumentIterator.Value());
+			}
+			for (TopTools_ListIteratorOfListOfShape occtArgumentIterator(m_occtArgumentsB); occtArgumentIterator.More(); occtArgumentIterator.Next())
+			{
+				m_occtArguments.push_back(occtArgumentIterator.Value());
+			}
+		}
+
+		Topology::Ptr Difference(const bool kTransferDictionary = false) { return Perform(BOOLEAN_DIFFERENCE, kTransferDictionary); }
+
+		Topology::Ptr Impose(const bool kTransferDictionary = false) { return Perform(BOOLEAN_IMPOSE, kTransferDictionary); }
+
+		Topology::Ptr Imprint(const bool kTransferDictionary = false) { return Perform(BOOLEAN_IMPRINT, kTransferDictionary); }
+
+		Topology::Ptr Intersect(const bool kTransferDictionary = false) { return Perform(BOOLEAN_INTERSECT, kTransferDictionary); }
+
+		Topology::Ptr Merge(const bool kTransferDictionary = false) { return Perform(BOOLEAN_MERGE, kTransferDictionary); }
+
+		Topology::Ptr Slice(const bool kTransferDictionary = false) { return Perform(BOOLEAN_SLICE, kTransferDictionary); }
+
+		Topology::Ptr Union(const bool kTransferDictionary = false) { return Perform(BOOLEAN_UNION, kTransferDictionary); }
+
+		Topology::Ptr XOR(const bool kTransferDictionary = false) { return Perform(BOOLEAN_XOR, kTransferDictionary); }
+
+		/// <summary>
+		/// Selects the result of an operation on the shared split.
+		/// </summary>
+		/// <param name="kOperationType"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		Topology::Ptr Perform(const BooleanOperationType kOperationType, const bool kTransferDictionary = false)
+		{
+			ClearSelection();
+			try
+			{
+				Topology::SelectBooleanResult(kOperationType, m_occtArgumentsA, m_occtArgumentsB, m_occtCellsBuilder);
+			}
+			catch (Standard_Failure& e)
+			{
+				throw std::runtime_error(e.GetMessageString());
+			}
+			return MakeResult(kOperationType, kTransferDictionary);
+		}
+
+		/// <summary>
+		/// The arguments the operands were decomposed into, those of A first. Their indices are used by AddToSelection.
+		/// </summary>
+		/// <param name="rArguments"></param>
+		void Arguments(std::list<Topology::Ptr>& rArguments) const
+		{
+			for (const TopoDS_Shape& rkOcctArgument : m_occtArguments)
+			{
+				rArguments.push_back(Topology::ByOcctShape(rkOcctArgument, ""));
+			}
+		}
+
+		int NumOfArgumentsA() const
+		{
+			return m_occtArgumentsA.Extent();
+		}
+
+		/// <summary>
+		/// Removes all the parts from the selection.
+		/// </summary>
+		void ClearSelection()
+		{
+			m_occtCellsBuilder.RemoveAllFromResult();
+		}
+
+		/// <summary>
+		/// Adds to the selection the parts inside all the arguments in rkTakeIndices and outside all the arguments
+		/// in rkAvoidIndices. Parts added with the same non-zero material are fused when the selection is made.
+		/// </summary>
+		/// <param name="rkTakeIndices"></param>
+		/// <param name="rkAvoidIndices"></param>
+		/// <param name="kMaterial"></param>
+		void AddToSelection(const std::list<int>& rkTakeIndices, const std::list<int>& rkAvoidIndices, const int kMaterial = 0)
+		{
+			TopTools_ListOfShape occtListToTake;
+			TopTools_ListOfShape occtListToAvoid;
+			for (const int kIndex : rkTakeIndices)
+			{
+				occtListToTake.Append(Argument(kIndex));
+			}
+			for (const int kIndex : rkAvoidIndices)
+			{
+				occtListToAvoid.Append(Argument(kIndex));
+			}
+			m_occtCellsBuilder.AddToResult(occtListToTake, occtListToAvoid, kMaterial);
+			m_hasMaterials = m_hasMaterials || kMaterial != 0;
+		}
+
+		/// <summary>
+		/// Makes a topology from the current selection.
+		/// </summary>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		Topology::Ptr Selection(const bool kTransferDictionary = false)
+		{
+			try
+			{
+				if (m_hasMaterials)
+				{
+					m_occtCellsBuilder.RemoveInternalBoundaries();
+				}
+				m_occtCellsBuilder.MakeContainers();
+			}
+			catch (Standard_Failure& e)
+			{
+				throw std::runtime_error(e.GetMessageString());
+			}
+			m_hasMaterials = false;
+			// A selection can keep parts of both operands, so both dictionaries are transferred, as for Merge.
+			return MakeResult(BOOLEAN_MERGE, kTransferDictionary);
+		}
+
+	protected:
+		const TopoDS_Shape& Argument(const int kIndex) const
+		{
+			if (kIndex < 0 || kIndex >= (int)m_occtArguments.size())
+			{
+				throw std::runtime_error("The argument index is out of range.");
+			}
+			return m_occtArguments[kIndex];
+		}
+
+		/// <summary>
+		/// Makes a topology from the result of the cells builder, transferring the dictionaries as Topology's booleans do:
+		/// those of the sub-shapes through the history, then those of the operands themselves.
+		/// </summary>
+		/// <param name="kOperationType"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		Topology::Ptr MakeResult(const BooleanOperationType kOperationType, const bool kTransferDictionary)
+		{
+			TopoDS_Shape occtResultShape = m_occtCellsBuilder.Shape();
+			if (occtResultShape.IsNull())
+			{
+				return nullptr;
+			}
+
+			TopoDS_Shape occtPostprocessedShape = m_pTopologyA->PostprocessBooleanResult(occtResultShape);
+			if (kTransferDictionary)
+			{
+				Topology::TransferDictionaries(m_occtCellsBuilder, m_pTopologyA->GetOcctShape(), m_occtMapFaceToFixedFaceA, occtPostprocessedShape);
+				Topology::TransferDictionaries(m_occtCellsBuilder, m_pTopologyB->GetOcctShape(), m_occtMapFaceToFixedFaceB, occtPostprocessedShape);
+				m_pTopologyA->TransferOperandDictionaries(m_pTopologyB, kOperationType, occtPostprocessedShape);
+			}
+			return Topology::ByOcctShape(occtPostprocessedShape, "");
+		}
+
+		Topology::Ptr m_pTopologyA;
+		Topology::Ptr m_pTopologyB;
+		BOPAlgo_CellsBuilder m_occtCellsBuilder;
+		TopTools_ListOfShape m_occtArgumentsA;
+		TopTools_ListOfShape m_occtArgumentsB;
+		TopTools_DataMapOfShapeShape m_occtMapFaceToFixedFaceA;
+		TopTools_DataMapOfShapeShape m_occtMapFaceToFixedFaceB;
+		std::vector<TopoDS_Shape> m_occtArguments;
+		bool m_hasMaterials;
+	};
+}
@@ -0,0 +1,145 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+
+#include <BRepBndLib.hxx>
+#include <Bnd_Box.hxx>
+#include <Bnd_OBB.hxx>
+#include <NCollection_DataMap.hxx>
+#include <TopTools_ShapeMapHasher.hxx>
+#include <TopoDS_Shape.hxx>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// Per-thread cache of the axis-aligned and oriented bounding boxes of shapes, keyed by TShape and location.
+	/// Boxes are only cached while a Scope is open on the thread, and the cache is emptied when the outermost Scope
+	/// closes: OCCT enlarges tolerances in place, so a box may not outlive the operation that computed it.
+	/// Within a Scope, the cache holds on to the shapes it has seen, so an entry can never be matched by another shape.
+	/// </summary>
+	class BoundingBoxCache
+	{
+	public:
+		static BoundingBoxCache& GetThreadInstance()
+		{
+			static thread_local BoundingBoxCache instance;
+			return instance;
+		}
+
+		/// <summary>
+		/// Enables the cache of the current thread for the lifetime of the object.
+		/// </summary>
+		class Scope
+		{
+		public:
+			Scope()
+				: m_rCache(BoundingBoxCache::GetThreadInstance())
+			{
+				++m_rCache.m_numOfScopes;
+			}
+
+			~Scope()
+			{
+				if (--m_rCache.m_numOfScopes == 0)
+				{
+					m_rCache.Clear();
+				}
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		protected:
+			BoundingBoxCache& m_rCache;
+		};
+
+		/// <summary>
+		/// Returns the axis-aligned bounding box of a shape, including its tolerance.
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		/// <returns></returns>
+		Bnd_Box AxisAlignedBox(const TopoDS_Shape& rkOcctShape)
+		{
+			const Bnd_Box* kpOcctBox = m_occtAxisAlignedBoxes.Seek(rkOcctShape);
+			if (kpOcctBox != nullptr)
+			{
+				return *kpOcctBox;
+			}
+
+			Bnd_Box occtBox;
+			BRepBndLib::Add(rkOcctShape, occtBox);
+			if (m_numOfScopes == 0)
+			{
+				return occtBox;
+			}
+			if (m_occtAxisAlignedBoxes.Extent() >= MAX_NUM_OF_ENTRIES)
+			{
+				m_occtAxisAlignedBoxes.Clear();
+			}
+			m_occtAxisAlignedBoxes.Bind(rkOcctShape, occtBox);
+			return occtBox;
+		}
+
+		/// <summary>
+		/// Returns the oriented bounding box of a shape, including its tolerance.
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		/// <returns></returns>
+		Bnd_OBB OrientedBox(const TopoDS_Shape& rkOcctShape)
+		{
+			const Bnd_OBB* kpOcctBox = m_occtOrientedBoxes.Seek(rkOcctShape);
+			if (kpOcctBox != nullptr)
+			{
+				return *kpOcctBox;
+			}
+
+			Bnd_OBB occtBox;
+			BRepBndLib::AddOBB(rkOcctShape, occtBox);
+			if (m_numOfScopes == 0)
+			{
+				return occtBox;
+			}
+			if (m_occtOrientedBoxes.Extent() >= MAX_NUM_OF_ENTRIES)
+			{
+				m_occtOrientedBoxes.Clear();
+			}
+			m_occtOrientedBoxes.Bind(rkOcctShape, occtBox);
+			return occtBox;
+		}
+
+		void Clear()
+		{
+			m_occtAxisAlignedBoxes.Clear();
+			m_occtOrientedBoxes.Clear();
+		}
+
+	protected:
+		static const int MAX_NUM_OF_ENTRIES = 4096;
+
+		BoundingBoxCache()
+			: m_numOfScopes(0)
+		{
+		}
+
+		int m_numOfScopes;
+
+		NCollection_DataMap<TopoDS_Shape, Bnd_Box, TopTools_ShapeMapHasher> m_occtAxisAlignedBoxes;
+		NCollection_DataMap<TopoDS_Shape, Bnd_OBB, TopTools_ShapeMapHasher> m_occtOrientedBoxes;
+	};
+}
@@ -234,4 +234,10 @@ namespace TopologicCore
 		/// </summary>
 		TopoDS_CompSolid m_occtCompSolid;
 	};
+
+	template <>
+	inline std::shared_ptr<CellComplex> AllocateTopology<CellComplex>(const TopoDS_Shape& rkOcctShape)
+	{
+		return TopologicalQuery::Downcast<CellComplex>(Topology::ByOcctShape(rkOcctShape, ""));
+	}
 }
@@ -19,9 +19,52 @@
 #include "Utilities.h"
 #include "Vertex.h"
 #include "Edge.h"
-
+#include "Face.h"
+#include "Aperture.h"
+#include "ProgressToken.h"
+#include "GraphIndex.h"
+#include "GraphCentrality.h"
+#include "VertexGrid.h"
+#include "AttributeManager.h"
+#include "DoubleAttribute.h"
+#include "IntAttribute.h"
+#include "Utilities/CellUtility.h"
+#include "Utilities/FaceUtility.h"
+
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRepClass3d_SolidClassifier.hxx>
+#include <BRepClass_FaceClassifier.hxx>
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <Precision.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp.hxx>
+#include <TopoDS.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopTools_ListIteratorOfListOfShape.hxx>
+#include <TopTools_MapIteratorOfMapOfShape.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <list>
 #include <chrono>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace TopologicCore
 {
@@ -39,6 +82,11 @@ namespace TopologicCore
 	public:
 		typedef std::shared_ptr<Graph> Ptr;
 
+		/// <summary>
+		/// Receives a path as the ids of its vertices in Index(), from start to end. Returns false to stop the enumeration.
+		/// </summary>
+		typedef std::function<bool(const std::vector<int>&)> PathCallback;
+
 	public:
 		static Graph::Ptr ByVerticesEdges(const std::list<Vertex::Ptr>& rkVertices, const std::list<Edge::Ptr>& rkEdges);
 
@@ -52,6 +100,32 @@ namespace TopologicCore
 			const bool useFaceInternalVertex,
 			const double kTolerance);
 
+		/// <summary>
+		/// Builds a graph from a topology as ByTopology does, with the work per element done in parallel on the OCCT thread
+		/// pool. The cells of a cell complex, or the faces of a shell, are connected through the faces, or edges, they share,
+		/// found from an incidence map computed once for the whole topology. Other topologies are left to ByTopology.
+		/// </summary>
+		/// <param name="kpTopology"></param>
+		/// <param name="kDirect"></param>
+		/// <param name="kViaSharedTopologies"></param>
+		/// <param name="kViaSharedApertures"></param>
+		/// <param name="kToExteriorTopologies"></param>
+		/// <param name="kToExteriorApertures"></param>
+		/// <param name="kUseFaceInternalVertex"></param>
+		/// <param name="kTolerance"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns></returns>
+		static Graph::Ptr ByTopology(
+			const TopologicCore::Topology::Ptr& kpTopology,
+			const bool kDirect,
+			const bool kViaSharedTopologies,
+			const bool kViaSharedApertures,
+			const bool kToExteriorTopologies,
+			const bool kToExteriorApertures,
+			const bool kUseFaceInternalVertex,
+			const double kTolerance,
+			const ProgressToken::Ptr& kpProgressToken);
+
 		Graph(const std::list<Vertex::Ptr>& rkVertices, const std::list<Edge::Ptr>& rkEdges);
 
 		TOPOLOGIC_API Graph(const Graph* rkAnotherGraph);
@@ -141,6 +215,154 @@ namespace TopologicCore
 			const std::string& rkVertexKey,
 			const std::string& rkEdgeKey) const;
 
+		/// <summary>
+		/// Finds all the simple paths between two vertices. Stops early, returning the paths found so far,
+		/// once the token is cancelled or its time limit is reached.
+		/// </summary>
+		/// <param name="kpStartVertex"></param>
+		/// <param name="kpEndVertex"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <param name="rPaths"></param>
+		void AllPaths(
+			const Vertex::Ptr& kpStartVertex,
+			const Vertex::Ptr& kpEndVertex,
+			const ProgressToken::Ptr& kpProgressToken,
+			std::list<std::shared_ptr<Wire>>& rPaths) const;
+
+		/// <summary>
+		/// Enumerates the simple paths between two vertices of Index() by an iterative depth-first search, passing each one
+		/// to a callback as soon as it is found. In parallel, the branches through each neighbour of the start vertex are
+		/// searched on the OCCT thread pool and their paths are queued, in no particular order; the callback is still only
+		/// called on the calling thread, so it may call back into Python. Stops early once the callback returns false, the
+		/// maximum number of paths is reached or the token is cancelled.
+		/// </summary>
+		/// <param name="kStartVertexId"></param>
+		/// <param name="kEndVertexId"></param>
+		/// <param name="kMaxLength">The maximum number of edges of a path. 0 for no limit.</param>
+		/// <param name="kMaxNumOfPaths">0 for no limit</param>
+		/// <param name="kRunsParallel"></param>
+		/// <param name="rkCallback"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns>The number of paths passed to the callback</returns>
+		int AllPaths(
+			const int kStartVertexId,
+			const int kEndVertexId,
+			const int kMaxLength,
+			const int kMaxNumOfPaths,
+			const bool kRunsParallel,
+			const PathCallback& rkCallback,
+			const ProgressToken::Ptr& kpProgressToken = nullptr) const;
+
+		/// <summary>
+		/// Collects the simple paths between two vertices of Index() as the ids of their vertices.
+		/// </summary>
+		/// <param name="kStartVertexId"></param>
+		/// <param name="kEndVertexId"></param>
+		/// <param name="kMaxLength">The maximum number of edges of a path. 0 for no limit.</param>
+		/// <param name="kMaxNumOfPaths">0 for no limit</param>
+		/// <param name="kRunsParallel"></param>
+		/// <param name="rPaths"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		void AllPaths(
+			const int kStartVertexId,
+			const int kEndVertexId,
+			const int kMaxLength,
+			const int kMaxNumOfPaths,
+			const bool kRunsParallel,
+			std::vector<std::vector<int>>& rPaths,
+			const ProgressToken::Ptr& kpProgressToken = nullptr) const;
+
+		/// <summary>
+		/// Materializes a path given as the ids of its vertices in Index() as a wire.
+		/// </summary>
+		/// <param name="rkPathVertexIds"></param>
+		/// <returns></returns>
+		std::shared_ptr<Wire> Path(const std::vector<int>& rkPathVertexIds) const;
+
+		/// <summary>
+		/// Finds the shortest path between two vertices with Dijkstra's algorithm or A*, throwing if the token is cancelled.
+		/// </summary>
+		/// <param name="kpStartVertex"></param>
+		/// <param name="kpEndVertex"></param>
+		/// <param name="rkVertexKey"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <param name="kUsesAStar">Guides the search with the Euclidean distance to the end vertex</param>
+		/// <returns></returns>
+		std::shared_ptr<Wire> ShortestPath(
+			const Vertex::Ptr& kpStartVertex,
+			const Vertex::Ptr& kpEndVertex,
+			const std::string& rkVertexKey,
+			const std::string& rkEdgeKey,
+			const ProgressToken::Ptr& kpProgressToken,
+			const bool kUsesAStar = false) const;
+
+		/// <summary>
+		/// Finds the shortest path between two vertices of Index() with Dijkstra's algorithm or A*. The costs are those of
+		/// ComputeCost, resolved once per call, and cached in the index when they do not depend on dictionaries. Negative
+		/// costs throw. With A*, the Euclidean distance to the end vertex is scaled by the lowest cost per unit length of
+		/// the edges, so the path found is still a shortest one.
+		/// </summary>
+		/// <param name="kStartVertexId"></param>
+		/// <param name="kEndVertexId"></param>
+		/// <param name="rkVertexKey"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <param name="kUsesAStar"></param>
+		/// <param name="rPathVertexIds">The ids of the vertices of the path, from start to end</param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns>The cost of the path, or -1 if the vertices are not connected</returns>
+		double ShortestPath(
+			const int kStartVertexId,
+			const int kEndVertexId,
+			const std::string& rkVertexKey,
+			const std::string& rkEdgeKey,
+			const bool kUsesAStar,
+			std::vector<int>& rPathVertexIds,
+			const ProgressToken::Ptr& kpProgressToken = nullptr) const;
+
+		/// <summary>
+		/// Searches the shortest paths from each source vertex of Index(), in parallel on the OCCT thread pool.
+		/// The searches are breadth-first if kIsTopological is true, or use the costs of ComputeCost otherwise.
+		/// </summary>
+		/// <param name="rkSourceVertexIds">All the vertices if empty</param>
+		/// <param name="rkVertexKey"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <param name="kIsTopological">Counts the edges, ignoring the keys</param>
+		/// <param name="kMaxDistance">The vertices further than this are not reached. Negative for no limit.</param>
+		/// <param name="rTrees">One sparse tree per source, in the order of the sources</param>
+		/// <param name="kpProgressToken">May be null</param>
+		void ShortestPathTrees(
+			const std::vector<int>& rkSourceVertexIds,
+			const std::string& rkVertexKey,
+			const std::string& rkEdgeKey,
+			const bool kIsTopological,
+			const double kMaxDistance,
+			std::vector<GraphIndex::ShortestPathTree>& rTrees,
+			const ProgressToken::Ptr& kpProgressToken = nullptr) const;
+
+		/// <summary>
+		/// Computes the dense matrices of the distances from each source vertex of Index() to every vertex, and of the
+		/// predecessors of every vertex on a shortest path from the source. Unreached vertices have a distance and a
+		/// predecessor of -1; the sources have a predecessor of -1.
+		/// </summary>
+		/// <param name="rkSourceVertexIds">All the vertices if empty</param>
+		/// <param name="rkVertexKey"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <param name="kIsTopological">Counts the edges, ignoring the keys</param>
+		/// <param name="kMaxDistance">The vertices further than this are not reached. Negative for no limit.</param>
+		/// <param name="rDistances">One row per source, one column per vertex</param>
+		/// <param name="rPredecessorIds">One row per source, one column per vertex</param>
+		/// <param name="kpProgressToken">May be null</param>
+		void DistanceMatrix(
+			const std::vector<int>& rkSourceVertexIds,
+			const std::string& rkVertexKey,
+			const std::string& rkEdgeKey,
+			const bool kIsTopological,
+			const double kMaxDistance,
+			std::vector<std::vector<double>>& rDistances,
+			std::vector<std::vector<int>>& rPredecessorIds,
+			const ProgressToken::Ptr& kpProgressToken = nullptr) const;
+
 		TOPOLOGIC_API void ShortestPaths(
 			const Vertex::Ptr& kpStartVertex,
 			const Vertex::Ptr& kpEndVertex,
@@ -159,6 +381,103 @@ namespace TopologicCore
 			const int kTimeLimitInSeconds,
 			std::list<std::shared_ptr<Wire>>& rPaths) const;
 
+		/// <summary>
+		/// Finds all the shortest paths between two vertices, with the costs of ComputeCost, as wires.
+		/// </summary>
+		/// <param name="kpStartVertex"></param>
+		/// <param name="kpEndVertex"></param>
+		/// <param name="rkVertexKey"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <param name="rPaths"></param>
+		void ShortestPaths(
+			const Vertex::Ptr& kpStartVertex,
+			const Vertex::Ptr& kpEndVertex,
+			const std::string& rkVertexKey,
+			const std::string& rkEdgeKey,
+			const ProgressToken::Ptr& kpProgressToken,
+			std::list<std::shared_ptr<Wire>>& rPaths) const;
+
+		/// <summary>
+		/// Enumerates the shortest paths between two vertices of Index(), all of the same cost, and passes each one to a
+		/// callback as the ids of its vertices. A single search records every predecessor of each vertex on a shortest
+		/// path; the paths are then read off backwards from the end vertex, so the time taken is linear in their total size.
+		/// </summary>
+		/// <param name="kStartVertexId"></param>
+		/// <param name="kEndVertexId"></param>
+		/// <param name="rkVertexKey"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <param name="kMaxNumOfPaths">0 for no limit</param>
+		/// <param name="rkCallback"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns>The cost of the paths, or -1 if the vertices are not connected</returns>
+		double ShortestPaths(
+			const int kStartVertexId,
+			const int kEndVertexId,
+			const std::string& rkVertexKey,
+			const std::string& rkEdgeKey,
+			const int kMaxNumOfPaths,
+			const PathCallback& rkCallback,
+			const ProgressToken::Ptr& kpProgressToken = nullptr) const;
+
+		/// <summary>
+		/// Collects the shortest paths between two vertices of Index() as the ids of their vertices.
+		/// </summary>
+		/// <param name="kStartVertexId"></param>
+		/// <param name="kEndVertexId"></param>
+		/// <param name="rkVertexKey"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <param name="kMaxNumOfPaths">0 for no limit</param>
+		/// <param name="rPaths"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns>The cost of the paths, or -1 if the vertices are not connected</returns>
+		double ShortestPaths(
+			const int kStartVertexId,
+			const int kEndVertexId,
+			const std::string& rkVertexKey,
+			const std::string& rkEdgeKey,
+			const int kMaxNumOfPaths,
+			std::vector<std::vector<int>>& rPaths,
+			const ProgressToken::Ptr& kpProgressToken = nullptr) const;
+
+		/// <summary>
+		/// Counts the shortest paths between two vertices of Index() without enumerating them, in time linear in the
+		/// size of the graph. The count is exact up to 2^53.
+		/// </summary>
+		/// <param name="kStartVertexId"></param>
+		/// <param name="kEndVertexId"></param>
+		/// <param name="rkVertexKey"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <returns>0 if the vertices are not connected</returns>
+		double NumOfShortestPaths(
+			const int kStartVertexId,
+			const int kEndVertexId,
+			const std::string& rkVertexKey,
+			const std::string& rkEdgeKey) const;
+
+		/// <summary>
+		/// Finds the k shortest loopless paths between two vertices of Index() with Yen's algorithm, by increasing cost.
+		/// Each path after the first deviates from one found before at a spur vertex, from which a shortest path is
+		/// searched with the vertices of the common root and the edges already taken from the spur vertex left out.
+		/// </summary>
+		/// <param name="kStartVertexId"></param>
+		/// <param name="kEndVertexId"></param>
+		/// <param name="rkVertexKey"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <param name="kNumOfPaths"></param>
+		/// <param name="rPaths">Fewer than kNumOfPaths if there are no more</param>
+		/// <param name="rCosts">The costs of the paths</param>
+		/// <param name="kpProgressToken">May be null</param>
+		void KShortestPaths(
+			const int kStartVertexId,
+			const int kEndVertexId,
+			const std::string& rkVertexKey,
+			const std::string& rkEdgeKey,
+			const int kNumOfPaths,
+			std::vector<std::vector<int>>& rPaths,
+			std::vector<double>& rCosts,
+			const ProgressToken::Ptr& kpProgressToken = nullptr) const;
+
 		TOPOLOGIC_API int Diameter() const;
 
 		TOPOLOGIC_API int TopologicalDistance(const std::shared_ptr<Vertex>& kpStartVertex, const std::shared_ptr<Vertex>& kpEndVertex, const double kTolerance = 0.0001) const;
@@ -167,6 +486,46 @@ namespace TopologicCore
 
 		TOPOLOGIC_API int Eccentricity(const std::shared_ptr<Vertex>& kpVertex) const;
 
+		/// <summary>
+		/// Returns the largest eccentricity over the connected components. The exact diameter is found with iFUB, which
+		/// searches in parallel from the vertices furthest from a central vertex until the bounds meet, and is often
+		/// near-linear in time. The approximate one is the lower bound of a double sweep.
+		/// </summary>
+		/// <param name="kIsApproximate"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns></returns>
+		int Diameter(const bool kIsApproximate, const ProgressToken::Ptr& kpProgressToken = nullptr) const;
+
+		/// <summary>
+		/// Returns the number of edges between a vertex of Index() and the vertex furthest from it in its component.
+		/// </summary>
+		/// <param name="kVertexId"></param>
+		/// <returns></returns>
+		int Eccentricity(const int kVertexId) const;
+
+		/// <summary>
+		/// Computes the eccentricity of every vertex of Index(), in parallel on the OCCT thread pool.
+		/// </summary>
+		/// <param name="rEccentricities">One per vertex id</param>
+		/// <param name="kpProgressToken">May be null</param>
+		void Eccentricities(std::vector<int>& rEccentricities, const ProgressToken::Ptr& kpProgressToken = nullptr) const;
+
+		/// <summary>
+		/// Computes a centrality measure (betweenness, closeness or integration) for every vertex of Index().
+		/// </summary>
+		/// <param name="kType"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="rValues">One per vertex id</param>
+		void Centrality(const CentralityType kType, const CentralityOptions& rkOptions, std::vector<double>& rValues) const;
+
+		/// <summary>
+		/// Computes a centrality measure for every vertex and stores it in the vertex's dictionary as a DoubleAttribute.
+		/// </summary>
+		/// <param name="kType"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="rkDictionaryKey"></param>
+		void Centrality(const CentralityType kType, const CentralityOptions& rkOptions, const std::string& rkDictionaryKey) const;
+
 		TOPOLOGIC_API bool IsErdoesGallai(const std::list<int>& rkSequence) const;
 
 		TOPOLOGIC_API void RemoveVertices(const std::list<Vertex::Ptr>& rkVertices);
@@ -180,6 +539,66 @@ namespace TopologicCore
 
 		void IncidentEdges(const std::shared_ptr<Vertex>& kpVertex, const double kTolerance, std::list<std::shared_ptr<TopologicCore::Edge>>& rEdges) const;
 
+		/// <summary>
+		/// Returns the compressed sparse row index of the graph, built on first use and rebuilt once the graph has changed.
+		/// Each call checks the index against a fingerprint of the graph in linear time; it is the only method that does.
+		/// The index is an explicit snapshot: the ids are positions in the graph dictionary, which is ordered by TShape,
+		/// so an edit of the graph may renumber them. The queries by id (Degree, AdjacentIds, TopologicalDistance,
+		/// EdgeIndex, ContainsEdge, IncidentEdgeIndices) are on the index, so callers running many of them hold on to it.
+		/// </summary>
+		/// <returns></returns>
+		GraphIndex::Ptr Index() const;
+
+		/// <summary>
+		/// Discards the index and the vertex grid, so that they are rebuilt on next use. The grid is only checked against
+		/// the number of vertices, so an edit of the graph other than AddVertices(rkVertices, kTolerance, rGraphVertices)
+		/// that removes as many vertices as it adds must be followed by Reindex().
+		/// </summary>
+		void Reindex() const;
+
+		/// <summary>
+		/// Returns the id in Index() of the vertex of the graph coincident with a vertex, or -1 if there is none.
+		/// This calls Index(), so it takes linear time; VertexId(kpIndex, ...) takes an index already at hand.
+		/// </summary>
+		/// <param name="kpVertex"></param>
+		/// <param name="kTolerance"></param>
+		/// <returns></returns>
+		int VertexId(const Vertex::Ptr& kpVertex, const double kTolerance = 0.0001) const
+		{
+			return VertexId(Index(), kpVertex, kTolerance);
+		}
+
+		/// <summary>
+		/// Returns the id in an index of the graph of the vertex of the graph coincident with a vertex, or -1 if there is
+		/// none. Coincident vertices are looked up in the hash grid of the vertices, in constant expected time.
+		/// </summary>
+		/// <param name="kpIndex">An index returned by Index()</param>
+		/// <param name="kpVertex"></param>
+		/// <param name="kTolerance"></param>
+		/// <returns></returns>
+		int VertexId(const GraphIndex::Ptr& kpIndex, const Vertex::Ptr& kpVertex, const double kTolerance = 0.0001) const;
+
+		/// <summary>
+		/// Lists the ids in Index() of the vertices within a tolerance of a point.
+		/// </summary>
+		/// <param name="kX"></param>
+		/// <param name="kY"></param>
+		/// <param name="kZ"></param>
+		/// <param name="kTolerance"></param>
+		/// <param name="rVertexIds"></param>
+		void VertexIdsAtCoordinates(const double kX, const double kY, const double kZ, const double kTolerance, std::vector<int>& rVertexIds) const;
+
+		/// <summary>
+		/// Adds the vertices that are not coincident with a vertex of the graph (or with one added before them), looking
+		/// them up in the vertex grid, which is kept up to date, so adding n vertices one at a time takes O(n) expected
+		/// time once the grid is built. The grid is edited with the registry locked, but, as with the other edits of a
+		/// graph, the graph must not be queried from another thread meanwhile.
+		/// </summary>
+		/// <param name="rkVertices"></param>
+		/// <param name="kTolerance"></param>
+		/// <param name="rGraphVertices">For each vertex, the vertex of the graph it was merged with, or itself</param>
+		void AddVertices(const std::list<Vertex::Ptr>& rkVertices, const double kTolerance, std::list<Vertex::Ptr>& rGraphVertices);
+
 	protected:
 
 		typedef std::map<TopoDS_Vertex, TopTools_MapOfShape, OcctShapeComparator> GraphMap;
@@ -242,6 +661,57 @@ namespace TopologicCore
 			const bool kUseFaceInternalVertex,
 			const double kTolerance);
 
+		/// <summary>
+		/// Builds the graph of the elements of a shape, e.g. its cells, connected directly and through the sub-shapes they
+		/// share, e.g. their faces. The vertices of the elements and sub-shapes are made in parallel, then merged within the
+		/// tolerance; the edges between them are made serially, since making an edge edits the TShapes of its vertices.
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		/// <param name="kOcctElementType"></param>
+		/// <param name="kOcctSharedType"></param>
+		/// <param name="kDirect"></param>
+		/// <param name="kViaSharedTopologies"></param>
+		/// <param name="kViaSharedApertures"></param>
+		/// <param name="kToExteriorTopologies"></param>
+		/// <param name="kToExteriorApertures"></param>
+		/// <param name="kUseFaceInternalVertex"></param>
+		/// <param name="kTolerance"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns></returns>
+		static Graph::Ptr ByIncidence(
+			const TopoDS_Shape& rkOcctShape,
+			const TopAbs_ShapeEnum kOcctElementType,
+			const TopAbs_ShapeEnum kOcctSharedType,
+			const bool kDirect,
+			const bool kViaSharedTopologies,
+			const bool kViaSharedApertures,
+			const bool kToExteriorTopologies,
+			const bool kToExteriorApertures,
+			const bool kUseFaceInternalVertex,
+			const double kTolerance,
+			const ProgressToken::Ptr& kpProgressToken);
+
+		/// <summary>
+		/// Returns the vertex standing for a shape in a graph: an internal vertex for a solid, and for a face if
+		/// kUseFaceInternalVertex is true, or else the centre of mass. Thread-safe, so it returns a null vertex when the
+		/// centre of mass is not internal and the search for an internal vertex is left to OcctGraphVertex.
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		/// <param name="kUseFaceInternalVertex"></param>
+		/// <param name="kTolerance"></param>
+		/// <returns></returns>
+		static TopoDS_Vertex OcctCentralVertex(const TopoDS_Shape& rkOcctShape, const bool kUseFaceInternalVertex, const double kTolerance);
+
+		/// <summary>
+		/// Returns the vertex standing for a shape in a graph, as CellUtility::InternalVertex or FaceUtility::InternalVertex
+		/// would, if OcctCentralVertex did not find it. Not thread-safe.
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		/// <param name="kUseFaceInternalVertex"></param>
+		/// <param name="kTolerance"></param>
+		/// <returns></returns>
+		static TopoDS_Vertex OcctGraphVertex(const TopoDS_Shape& rkOcctShape, const bool kUseFaceInternalVertex, const double kTolerance);
+
 		std::shared_ptr<Wire> ConstructPath(const std::list<Vertex::Ptr>& rkPathVertices) const;
 
 		std::shared_ptr<Wire> ConstructPath(
@@ -250,6 +720,288 @@ namespace TopologicCore
 			const int kTimeLimitInSeconds,
 			const std::chrono::system_clock::time_point& rkStartingTime) const;
 
+		/// <summary>
+		/// An index and the fingerprint of the graph it was built from.
+		/// </summary>
+		struct IndexEntry
+		{
+			GraphIndex::Ptr pIndex;
+			uint64_t fingerprint;
+			uint64_t lastUse;
+		};
+
+		/// <summary>
+		/// A vertex grid and the number of vertices of the graph it holds.
+		/// </summary>
+		struct GridEntry
+		{
+			VertexGrid::Ptr pGrid;
+			size_t numOfVertices;
+		};
+
+		/// <summary>
+		/// The indices of the graphs, keyed by graph. Graph is compiled, so the entries cannot be dropped when a graph is
+		/// destroyed: they are checked against the fingerprint of their graph before use, and the least recently used one
+		/// is evicted beyond MAX_NUM_OF_INDICES. An index holds on to the TShapes of its graph, so another graph allocated
+		/// at the same address can only match it if it has the same vertices, adjacencies and edges.
+		/// </summary>
+		struct IndexRegistry
+		{
+			IndexRegistry()
+				: useCount(0)
+			{
+			}
+
+			std::mutex mutex;
+			std::map<const Graph*, IndexEntry> indices;
+			std::map<const Graph*, GridEntry> grids;
+			uint64_t useCount;
+		};
+
+		static IndexRegistry& GetIndexRegistry()
+		{
+			static IndexRegistry registry;
+			return registry;
+		}
+
+		/// <summary>
+		/// Returns a hash of the TShapes of the vertices, of their adjacent vertices and of the edges of the graph,
+		/// independent of their order.
+		/// </summary>
+		/// <returns></returns>
+		uint64_t Fingerprint() const;
+
+		/// <summary>
+		/// The splitmix64 finalizer, which the fingerprints sum over the TShapes.
+		/// </summary>
+		/// <param name="value"></param>
+		/// <returns></returns>
+		static uint64_t Mix(uint64_t value)
+		{
+			value += 0x9e3779b97f4a7c15ULL;
+			value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+			return value ^ (value >> 31);
+		}
+
+		/// <summary>
+		/// The state shared by the branches of a path enumeration. If kIsQueued is true, the branches queue their paths
+		/// and Deliver() passes them to the callback on the thread calling it.
+		/// </summary>
+		struct PathEnumeration
+		{
+			PathEnumeration(const PathCallback& rkCallback, const int kMaxNumOfPaths, const bool kIsQueued, const ProgressToken::Ptr& kpProgressToken)
+				: rkCallback(rkCallback)
+				, kMaxNumOfPaths(kMaxNumOfPaths)
+				, kIsQueued(kIsQueued)
+				, kpProgressToken(kpProgressToken)
+				, numOfPaths(0)
+				, numOfQueuedPaths(0)
+				, isStopped(false)
+				, isFinished(false)
+			{
+			}
+
+			/// <summary>
+			/// Passes a path to the callback, or queues it, waiting while the queue is full. Returns false once the
+			/// enumeration is stopped.
+			/// </summary>
+			bool Report(const std::vector<int>& rkPath)
+			{
+				if (!kIsQueued)
+				{
+					if (isStopped)
+					{
+						return false;
+					}
+					++numOfPaths;
+					if (!rkCallback(rkPath) || (kMaxNumOfPaths > 0 && numOfPaths >= kMaxNumOfPaths))
+					{
+						isStopped = true;
+					}
+					return !isStopped;
+				}
+
+				std::unique_lock<std::mutex> lock(mutex);
+				queueCondition.wait(lock, [this] { return isStopped || queuedPaths.size() < MAX_NUM_OF_QUEUED_PATHS; });
+				if (isStopped)
+				{
+					return false;
+				}
+				queuedPaths.push_back(rkPath);
+				++numOfQueuedPaths;
+				if (kMaxNumOfPaths > 0 && numOfQueuedPaths >= kMaxNumOfPaths)
+				{
+					isStopped = true;
+				}
+				queueCondition.notify_all();
+				return !isStopped;
+			}
+
+			/// <summary>
+			/// Passes the queued paths to the callback until Finish() is called and the queue is empty.
+			/// </summary>
+			void Deliver()
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				while (true)
+				{
+					queueCondition.wait(lock, [this] { return !queuedPaths.empty() || isFinished; });
+					if (queuedPaths.empty())
+					{
+						return;
+					}
+					const std::vector<int> kPath(std::move(queuedPaths.front()));
+					queuedPaths.pop_front();
+					queueCondition.notify_all();
+
+					lock.unlock();
+					const bool kContinues = rkCallback(kPath);
+					lock.lock();
+					++numOfPaths;
+					if (!kContinues)
+					{
+						isStopped = true;
+						queuedPaths.clear();
+						queueCondition.notify_all();
+					}
+				}
+			}
+
+			/// <summary>
+			/// Stops the branches and drops the queued paths, e.g. when the callback has thrown.
+			/// </summary>
+			void Stop()
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isStopped = true;
+				queuedPaths.clear();
+				queueCondition.notify_all();
+			}
+
+			/// <summary>
+			/// Called once all the branches have returned.
+			/// </summary>
+			void Finish()
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isFinished = true;
+				queueCondition.notify_all();
+			}
+
+			static const size_t MAX_NUM_OF_QUEUED_PATHS = 4096;
+
+			const PathCallback& rkCallback;
+			const int kMaxNumOfPaths;
+			const bool kIsQueued;
+			const ProgressToken::Ptr& kpProgressToken;
+			std::mutex mutex;
+			std::condition_variable queueCondition;
+			std::deque<std::vector<int>> queuedPaths;
+			int numOfPaths;
+			int numOfQueuedPaths;
+			std::atomic<bool> isStopped;
+			bool isFinished;
+		};
+
+		/// <summary>
+		/// Extends a path prefix to the end vertex in all the simple ways, with an explicit stack and a bitset of the
+		/// vertices on the path.
+		/// </summary>
+		/// <param name="rkIndex"></param>
+		/// <param name="kEndVertexId"></param>
+		/// <param name="kMaxLength"></param>
+		/// <param name="path">The prefix, which is not backtracked over</param>
+		/// <param name="rEnumeration"></param>
+		static void EnumeratePaths(const GraphIndex& rkIndex, const int kEndVertexId, const int kMaxLength, std::vector<int> path, PathEnumeration& rEnumeration);
+
+		/// <summary>
+		/// Returns the hash grid of the vertices of the graph, rebuilt if the number of vertices has changed or if its
+		/// cells are too small or much too large for the tolerance. The check takes constant time: AddVertices() keeps the
+		/// grid up to date, and the other edits must be followed by Reindex() if they leave the number unchanged.
+		/// </summary>
+		/// <param name="kTolerance"></param>
+		/// <returns></returns>
+		VertexGrid::Ptr Grid(const double kTolerance) const;
+
+		/// <summary>
+		/// Returns the entry of the hash grid of the vertices of the graph as Grid() does, with the mutex of the registry
+		/// already held.
+		/// </summary>
+		/// <param name="kTolerance"></param>
+		/// <param name="rRegistry"></param>
+		/// <returns></returns>
+		GridEntry& LockedGrid(const double kTolerance, IndexRegistry& rRegistry) const;
+
+		/// <summary>
+		/// Returns the costs of the edges of an index for a pair of keys. Only the costs that do not depend on
+		/// dictionaries (no vertex key, and no edge key or "distance"/"length") are cached in the index; those read from
+		/// attributes are computed on every call, so that edits of the dictionaries are always seen. Throws if a cost is
+		/// negative, since the searches would then return wrong paths.
+		/// </summary>
+		/// <param name="rkIndex"></param>
+		/// <param name="rkVertexKey"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <returns></returns>
+		GraphIndex::EdgeWeights::Ptr ResolveEdgeWeights(const GraphIndex& rkIndex, const std::string& rkVertexKey, const std::string& rkEdgeKey) const;
+
+		/// <summary>
+		/// Returns the cost of the edge of a slot of an index as ComputeEdgeCost does, but finds the edge in the index:
+		/// 1 with no key, the distance between the vertices for "distance" or "length", or the edge's numerical
+		/// attribute, 1 if it has none. Other cases are left to ComputeEdgeCost.
+		/// </summary>
+		/// <param name="rkIndex"></param>
+		/// <param name="kVertexId"></param>
+		/// <param name="kSlot"></param>
+		/// <param name="rkEdgeKey"></param>
+		/// <returns></returns>
+		double ComputeEdgeCost(const GraphIndex& rkIndex, const int kVertexId, const int kSlot, const std::string& rkEdgeKey) const;
+
+		/// <summary>
+		/// Finds a shortest path between two vertices of an index with Dijkstra's algorithm, or A* if the heuristic scale
+		/// is positive, leaving out some vertices and slots of Targets(). Thread-safe; the scratch arrays are kept per thread.
+		/// </summary>
+		/// <param name="rkIndex"></param>
+		/// <param name="rkEdgeWeights"></param>
+		/// <param name="kStartVertexId"></param>
+		/// <param name="kEndVertexId"></param>
+		/// <param name="kHeuristicScale">The factor of the Euclidean distance to the end vertex. 0 for Dijkstra's algorithm.</param>
+		/// <param name="kpIsBannedVertex">May be null</param>
+		/// <param name="kpIsBannedSlot">May be null</param>
+		/// <param name="rPathVertexIds"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns>The cost of the path, or -1 if there is none</returns>
+		static double SearchPath(
+			const GraphIndex& rkIndex,
+			const GraphIndex::EdgeWeights& rkEdgeWeights,
+			const int kStartVertexId,
+			const int kEndVertexId,
+			const double kHeuristicScale,
+			const std::vector<bool>* kpIsBannedVertex,
+			const std::vector<bool>* kpIsBannedSlot,
+			std::vector<int>& rPathVertexIds,
+			const ProgressToken::Ptr& kpProgressToken);
+
+		/// <summary>
+		/// Computes the exact diameter of the component of a central vertex with iFUB (Crescenzi et al., 2013): the
+		/// eccentricities of the vertices at distance i from the centre bound the diameter from below, and 2(i - 1)
+		/// bounds it from above once they have all been computed.
+		/// </summary>
+		/// <param name="rkIndex"></param>
+		/// <param name="kCentreId"></param>
+		/// <param name="kLowerBound">A known lower bound, e.g. from a double sweep</param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns></returns>
+		static int FringeDiameter(const GraphIndex& rkIndex, const int kCentreId, const int kLowerBound, const ProgressToken::Ptr& kpProgressToken);
+
+		/// <summary>
+		/// Makes a path wire from vertex ids.
+		/// </summary>
+		/// <param name="rkIndex"></param>
+		/// <param name="rkPathIds"></param>
+		/// <returns></returns>
+		std::shared_ptr<Wire> ConstructPath(const GraphIndex& rkIndex, const std::vector<int>& rkPathIds) const;
+
 		bool IsDegreeSequence(const std::list<int>& rkSequence) const;
 
 		TopoDS_Vertex GetCoincidentVertex(const TopoDS_Vertex& rkVertex, const double kTolerance) const;
@@ -261,7 +1013,1275 @@ namespace TopologicCore
 		TopoDS_Edge FindEdge(const TopoDS_Vertex& rkVertex1, const TopoDS_Vertex& rkVertex2, const double kTolerance = 0.0001) const;
 		static bool IsCoincident(const TopoDS_Vertex& rkVertex1, const TopoDS_Vertex& rkVertex2, const double kTolerance = 0.0001);
 
+		static const size_t MAX_NUM_OF_INDICES = 256;
+
 		GraphMap m_graphDictionary;
 		TopTools_MapOfShape m_occtEdges;
 	};
+
+	inline Graph::Ptr Graph::ByTopology(
+		const TopologicCore::Topology::Ptr& kpTopology,
+		const bool kDirect,
+		const bool kViaSharedTopologies,
+		const bool kViaSharedApertures,
+		const bool kToExteriorTopologies,
+		const bool kToExteriorApertures,
+		const bool kUseFaceInternalVertex,
+		const double kTolerance,
+		const ProgressToken::Ptr& kpProgressToken)
+	{
+		switch (kpTopology->GetType())
+		{
+		case TOPOLOGY_CELLCOMPLEX:
+			return ByIncidence(kpTopology->GetOcctShape(), TopAbs_SOLID, TopAbs_FACE,
+				kDirect, kViaSharedTopologies, kViaSharedApertures, kToExteriorTopologies, kToExteriorApertures, kUseFaceInternalVertex, kTolerance, kpProgressToken);
+		case TOPOLOGY_SHELL:
+			return ByIncidence(kpTopology->GetOcctShape(), TopAbs_FACE, TopAbs_EDGE,
+				kDirect, kViaSharedTopologies, kViaSharedApertures, kToExteriorTopologies, kToExteriorApertures, kUseFaceInternalVertex, kTolerance, kpProgressToken);
+		default:
+			return ByTopology(kpTopology, kDirect, kViaSharedTopologies, kViaSharedApertures, kToExteriorTopologies, kToExteriorApertures, kUseFaceInternalVertex, kTolerance);
+		}
+	}
+
+	inline Graph::Ptr Graph::ByIncidence(
+		const TopoDS_Shape& rkOcctShape,
+		const TopAbs_ShapeEnum kOcctElementType,
+		const TopAbs_ShapeEnum kOcctSharedType,
+		const bool kDirect,
+		const bool kViaSharedTopologies,
+		const bool kViaSharedApertures,
+		const bool kToExteriorTopologies,
+		const bool kToExteriorApertures,
+		const bool kUseFaceInternalVertex,
+		const double kTolerance,
+		const ProgressToken::Ptr& kpProgressToken)
+	{
+		// 1. Map each shared sub-shape to the elements it bounds, once, instead of navigating upwards from each of them.
+		TopTools_IndexedMapOfShape occtElements;
+		TopExp::MapShapes(rkOcctShape, kOcctElementType, occtElements);
+		TopTools_IndexedDataMapOfShapeListOfShape occtSharedShapesToElements;
+		TopExp::MapShapesAndUniqueAncestors(rkOcctShape, kOcctSharedType, kOcctElementType, occtSharedShapesToElements);
+		const int kNumOfElements = occtElements.Extent();
+		const int kNumOfSharedShapes = occtSharedShapesToElements.Extent();
+		std::vector<std::vector<int>> elementIndices(kNumOfSharedShapes);
+		for (int i = 0; i < kNumOfSharedShapes; ++i)
+		{
+			for (TopTools_ListIteratorOfListOfShape occtElementIterator(occtSharedShapesToElements(i + 1)); occtElementIterator.More(); occtElementIterator.Next())
+			{
+				elementIndices[i].push_back(occtElements.FindIndex(occtElementIterator.Value()) - 1);
+			}
+		}
+
+		// 2. Find the vertices of the elements, and of the sub-shapes connected through, in parallel.
+		std::vector<TopoDS_Vertex> occtElementVertices(kNumOfElements);
+		std::vector<TopoDS_Vertex> occtSharedVertices(kNumOfSharedShapes);
+		OSD_Parallel::For(0, kNumOfElements + kNumOfSharedShapes, [&](const int i)
+		{
+			if (kpProgressToken != nullptr && kpProgressToken->IsCancelled())
+			{
+				return;
+			}
+
+			const int kSharedIndex = i - kNumOfElements;
+			if (kSharedIndex >= 0 &&
+				!(elementIndices[kSharedIndex].size() > 1 && kViaSharedTopologies) &&
+				!(elementIndices[kSharedIndex].size() == 1 && kToExteriorTopologies))
+			{
+				return;
+			}
+
+			try
+			{
+				TopoDS_Vertex& rOcctVertex = kSharedIndex < 0 ? occtElementVertices[i] : occtSharedVertices[kSharedIndex];
+				rOcctVertex = OcctCentralVertex(kSharedIndex < 0 ? occtElements(i + 1) : occtSharedShapesToElements.FindKey(kSharedIndex + 1), kUseFaceInternalVertex, kTolerance);
+			}
+			catch (Standard_Failure&)
+			{
+				// Retried below, where the failure is reported.
+			}
+		});
+		ProgressToken::ThrowIfCancelled(kpProgressToken);
+
+		// 3. Merge the vertices into the graph, and list the pairs of vertices to connect.
+		Graph::Ptr pGraph = std::make_shared<Graph>(std::list<Vertex::Ptr>(), std::list<TopologicCore::Edge::Ptr>());
+		VertexGrid grid(2.0 * std::max(kTolerance, Precision::Confusion()));
+		auto addVertex = [&](const TopoDS_Vertex& rkOcctVertex, const TopoDS_Shape& rkOcctOriginShape)
+		{
+			const int kGridIndex = grid.FindNearest(BRep_Tool::Pnt(rkOcctVertex), kTolerance);
+			if (kGridIndex >= 0)
+			{
+				return kGridIndex;
+			}
+			pGraph->m_graphDictionary.insert(std::make_pair(rkOcctVertex, TopTools_MapOfShape()));
+			AttributeManager::GetInstance().CopyAttributes(rkOcctOriginShape, rkOcctVertex);
+			return grid.Add(rkOcctVertex);
+		};
+
+		std::vector<int> elementGridIndices(kNumOfElements);
+		for (int i = 0; i < kNumOfElements; ++i)
+		{
+			if (occtElementVertices[i].IsNull())
+			{
+				occtElementVertices[i] = OcctGraphVertex(occtElements(i + 1), kUseFaceInternalVertex, kTolerance);
+			}
+			elementGridIndices[i] = addVertex(occtElementVertices[i], occtElements(i + 1));
+		}
+
+		std::set<std::pair<int, int>> gridIndexPairs;
+		auto addEdge = [&](const int kGridIndex1, const int kGridIndex2)
+		{
+			if (kGridIndex1 != kGridIndex2)
+			{
+				gridIndexPairs.insert(std::make_pair(std::min(kGridIndex1, kGridIndex2), std::max(kGridIndex1, kGridIndex2)));
+			}
+		};
+
+		for (int i = 0; i < kNumOfSharedShapes; ++i)
+		{
+			ProgressToken::ThrowIfCancelled(kpProgressToken);
+			const std::vector<int>& rkElementIndices = elementIndices[i];
+			const bool kIsShared = rkElementIndices.size() > 1;
+			if (kDirect && kIsShared)
+			{
+				for (size_t j = 0; j < rkElementIndices.size(); ++j)
+				{
+					for (size_t k = j + 1; k < rkElementIndices.size(); ++k)
+					{
+						addEdge(elementGridIndices[rkElementIndices[j]], elementGridIndices[rkElementIndices[k]]);
+					}
+				}
+			}
+
+			const TopoDS_Shape& rkOcctSharedShape = occtSharedShapesToElements.FindKey(i + 1);
+			if (kIsShared ? kViaSharedTopologies : kToExteriorTopologies)
+			{
+				if (occtSharedVertices[i].IsNull())
+				{
+					occtSharedVertices[i] = OcctGraphVertex(rkOcctSharedShape, kUseFaceInternalVertex, kTolerance);
+				}
+				const int kSharedGridIndex = addVertex(occtSharedVertices[i], rkOcctSharedShape);
+				for (const int kElementIndex : rkElementIndices)
+				{
+					addEdge(elementGridIndices[kElementIndex], kSharedGridIndex);
+				}
+			}
+
+			if (kIsShared ? kViaSharedApertures : kToExteriorApertures)
+			{
+				std::list<Aperture::Ptr> apertures;
+				TopologicCore::Topology::Apertures(rkOcctSharedShape, apertures);
+				for (const Aperture::Ptr& kpAperture : apertures)
+				{
+					const TopoDS_Shape& rkOcctApertureShape = kpAperture->Topology()->GetOcctShape();
+					TopoDS_Vertex occtApertureVertex = OcctCentralVertex(rkOcctApertureShape, kUseFaceInternalVertex, kTolerance);
+					if (occtApertureVertex.IsNull())
+					{
+						occtApertureVertex = OcctGraphVertex(rkOcctApertureShape, kUseFaceInternalVertex, kTolerance);
+					}
+					const int kApertureGridIndex = addVertex(occtApertureVertex, rkOcctApertureShape);
+					for (const int kElementIndex : rkElementIndices)
+					{
+						addEdge(elementGridIndices[kElementIndex], kApertureGridIndex);
+					}
+				}
+			}
+		}
+
+		// 4. Make the edges and add them to the adjacency. This is serial: BRepBuilderAPI_MakeEdge records the parameters
+		// of its vertices on the new curve in their TShapes, which the edges of the same element share.
+		for (const std::pair<int, int>& rkGridIndexPair : gridIndexPairs)
+		{
+			const TopoDS_Vertex& rkOcctVertex1 = grid.OcctVertex(rkGridIndexPair.first);
+			const TopoDS_Vertex& rkOcctVertex2 = grid.OcctVertex(rkGridIndexPair.second);
+			BRepBuilderAPI_MakeEdge occtMakeEdge(rkOcctVertex1, rkOcctVertex2);
+			if (!occtMakeEdge.IsDone())
+			{
+				continue;
+			}
+			pGraph->m_graphDictionary[rkOcctVertex1].Add(rkOcctVertex2);
+			pGraph->m_graphDictionary[rkOcctVertex2].Add(rkOcctVertex1);
+			pGraph->m_occtEdges.Add(occtMakeEdge.Edge());
+		}
+		return pGraph;
+	}
+
+	inline TopoDS_Vertex Graph::OcctCentralVertex(const TopoDS_Shape& rkOcctShape, const bool kUseFaceInternalVertex, const double kTolerance)
+	{
+		const TopoDS_Vertex kOcctCentreOfMass = TopologicCore::Topology::CenterOfMass(rkOcctShape);
+		const gp_Pnt kOcctCentre = BRep_Tool::Pnt(kOcctCentreOfMass);
+		if (rkOcctShape.ShapeType() == TopAbs_SOLID)
+		{
+			BRepClass3d_SolidClassifier occtSolidClassifier(rkOcctShape, kOcctCentre, kTolerance);
+			return occtSolidClassifier.State() == TopAbs_IN ? kOcctCentreOfMass : TopoDS_Vertex();
+		}
+		if (rkOcctShape.ShapeType() == TopAbs_FACE && kUseFaceInternalVertex)
+		{
+			BRepClass_FaceClassifier occtFaceClassifier(TopoDS::Face(rkOcctShape), kOcctCentre, kTolerance);
+			return occtFaceClassifier.State() == TopAbs_IN ? kOcctCentreOfMass : TopoDS_Vertex();
+		}
+		return kOcctCentreOfMass;
+	}
+
+	inline TopoDS_Vertex Graph::OcctGraphVertex(const TopoDS_Shape& rkOcctShape, const bool kUseFaceInternalVertex, const double kTolerance)
+	{
+		if (rkOcctShape.ShapeType() == TopAbs_SOLID)
+		{
+			return TopologicUtilities::CellUtility::InternalVertex(TopoDS::Solid(rkOcctShape), kTolerance)->GetOcctVertex();
+		}
+		if (rkOcctShape.ShapeType() == TopAbs_FACE && kUseFaceInternalVertex)
+		{
+			return TopologicUtilities::FaceUtility::InternalVertex(std::make_shared<Face>(TopoDS::Face(rkOcctShape)), kTolerance)->GetOcctVertex();
+		}
+		return TopologicCore::Topology::CenterOfMass(rkOcctShape);
+	}
+
+	inline GraphIndex::Ptr Graph::Index() const
+	{
+		const uint64_t kFingerprint = Fingerprint();
+		IndexRegistry& rRegistry = GetIndexRegistry();
+		{
+			std::lock_guard<std::mutex> lock(rRegistry.mutex);
+			auto indexIterator = rRegistry.indices.find(this);
+			if (indexIterator != rRegistry.indices.end() && indexIterator->second.fingerprint == kFingerprint)
+			{
+				indexIterator->second.lastUse = ++rRegistry.useCount;
+				return indexIterator->second.pIndex;
+			}
+		}
+
+		// Edges whose endpoints are not themselves vertices of the graph are matched as FindEdge does, within 0.0001.
+		// The grid is only fetched for the first such endpoint.
+		VertexGrid::Ptr pGrid;
+		GraphIndex::Ptr pIndex = std::make_shared<GraphIndex>(m_graphDictionary, m_occtEdges, [this, &pGrid](const TopoDS_Vertex& rkOcctVertex)
+		{
+			if (pGrid == nullptr)
+			{
+				pGrid = Grid(0.0001);
+			}
+			const int kGridIndex = pGrid->FindNearest(BRep_Tool::Pnt(rkOcctVertex), 0.0001);
+			return kGridIndex < 0 ? TopoDS_Vertex() : pGrid->OcctVertex(kGridIndex);
+		});
+		std::lock_guard<std::mutex> lock(rRegistry.mutex);
+		if (rRegistry.indices.size() >= MAX_NUM_OF_INDICES && rRegistry.indices.find(this) == rRegistry.indices.end())
+		{
+			auto leastRecentlyUsedIterator = std::min_element(rRegistry.indices.begin(), rRegistry.indices.end(),
+				[](const std::pair<const Graph* const, IndexEntry>& rkPair1, const std::pair<const Graph* const, IndexEntry>& rkPair2)
+				{
+					return rkPair1.second.lastUse < rkPair2.second.lastUse;
+				});
+			rRegistry.indices.erase(leastRecentlyUsedIterator);
+		}
+		IndexEntry& rEntry = rRegistry.indices[this];
+		rEntry.pIndex = pIndex;
+		rEntry.fingerprint = kFingerprint;
+		rEntry.lastUse = ++rRegistry.useCount;
+		return pIndex;
+	}
+
+	inline void Graph::Reindex() const
+	{
+		IndexRegistry& rRegistry = GetIndexRegistry();
+		std::lock_guard<std::mutex> lock(rRegistry.mutex);
+		rRegistry.indices.erase(this);
+		rRegistry.grids.erase(this);
+	}
+
+	inline VertexGrid::Ptr Graph::Grid(const double kTolerance) const
+	{
+		IndexRegistry& rRegistry = GetIndexRegistry();
+		std::lock_guard<std::mutex> lock(rRegistry.mutex);
+		return LockedGrid(kTolerance, rRegistry).pGrid;
+	}
+
+	inline Graph::GridEntry& Graph::LockedGrid(const double kTolerance, IndexRegistry& rRegistry) const
+	{
+		auto gridIterator = rRegistry.grids.find(this);
+		if (gridIterator != rRegistry.grids.end() && gridIterator->second.numOfVertices == m_graphDictionary.size())
+		{
+			const double kCellSize = gridIterator->second.pGrid->CellSize();
+			if (kTolerance <= kCellSize && 16.0 * kTolerance >= kCellSize)
+			{
+				return gridIterator->second;
+			}
+		}
+
+		VertexGrid::Ptr pGrid = std::make_shared<VertexGrid>(2.0 * std::max(kTolerance, Precision::Confusion()));
+		for (const auto& rkDictionaryPair : m_graphDictionary)
+		{
+			pGrid->Add(rkDictionaryPair.first);
+		}
+		if (rRegistry.grids.size() >= MAX_NUM_OF_INDICES && gridIterator == rRegistry.grids.end())
+		{
+			rRegistry.grids.clear();
+		}
+		GridEntry& rEntry = rRegistry.grids[this];
+		rEntry.pGrid = pGrid;
+		rEntry.numOfVertices = m_graphDictionary.size();
+		return rEntry;
+	}
+
+	inline uint64_t Graph::Fingerprint() const
+	{
+		// Each TShape is mixed and the results are summed, so the order does not matter.
+		uint64_t fingerprint = Mix(m_graphDictionary.size()) + Mix(~(uint64_t)m_occtEdges.Extent());
+		for (const auto& rkDictionaryPair : m_graphDictionary)
+		{
+			const uint64_t kVertexHash = Mix((uint64_t)(size_t)rkDictionaryPair.first.TShape().get());
+			fingerprint += kVertexHash;
+			for (TopTools_MapIteratorOfMapOfShape occtAdjacentIterator(rkDictionaryPair.second); occtAdjacentIterator.More(); occtAdjacentIterator.Next())
+			{
+				fingerprint += Mix(kVertexHash ^ (uint64_t)(size_t)occtAdjacentIterator.Key().TShape().get());
+			}
+		}
+		for (TopTools_MapIteratorOfMapOfShape occtEdgeIterator(m_occtEdges); occtEdgeIterator.More(); occtEdgeIterator.Next())
+		{
+			fingerprint += Mix(Mix((uint64_t)(size_t)occtEdgeIterator.Key().TShape().get()));
+		}
+		return fingerprint;
+	}
+
+	inline int Graph::VertexId(const GraphIndex::Ptr& kpIndex, const Vertex::Ptr& kpVertex, const double kTolerance) const
+	{
+		const int kId = kpIndex->Id(kpVertex->GetOcctVertex());
+		if (kId >= 0)
+		{
+			return kId;
+		}
+
+		VertexGrid::Ptr pGrid = Grid(kTolerance);
+		const int kGridIndex = pGrid->FindNearest(BRep_Tool::Pnt(kpVertex->GetOcctVertex()), kTolerance);
+		return kGridIndex < 0 ? -1 : kpIndex->Id(pGrid->OcctVertex(kGridIndex));
+	}
+
+	inline void Graph::VertexIdsAtCoordinates(const double kX, const double kY, const double kZ, const double kTolerance, std::vector<int>& rVertexIds) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		VertexGrid::Ptr pGrid = Grid(kTolerance);
+		std::vector<int> gridIndices;
+		pGrid->FindAll(gp_Pnt(kX, kY, kZ), kTolerance, gridIndices);
+		for (const int kGridIndex : gridIndices)
+		{
+			rVertexIds.push_back(pIndex->Id(pGrid->OcctVertex(kGridIndex)));
+		}
+	}
+
+	inline void Graph::AddVertices(const std::list<Vertex::Ptr>& rkVertices, const double kTolerance, std::list<Vertex::Ptr>& rGraphVertices)
+	{
+		IndexRegistry& rRegistry = GetIndexRegistry();
+		std::lock_guard<std::mutex> lock(rRegistry.mutex);
+		GridEntry& rGridEntry = LockedGrid(kTolerance, rRegistry);
+		const VertexGrid::Ptr& rkGrid = rGridEntry.pGrid;
+		for (const Vertex::Ptr& kpVertex : rkVertices)
+		{
+			const TopoDS_Vertex& rkOcctVertex = kpVertex->GetOcctVertex();
+			const int kGridIndex = rkGrid->FindNearest(BRep_Tool::Pnt(rkOcctVertex), kTolerance);
+			if (kGridIndex >= 0)
+			{
+				rGraphVertices.push_back(std::make_shared<Vertex>(rkGrid->OcctVertex(kGridIndex)));
+				continue;
+			}
+
+			m_graphDictionary.insert(std::make_pair(rkOcctVertex, TopTools_MapOfShape()));
+			rkGrid->Add(rkOcctVertex);
+			rGridEntry.numOfVertices = m_graphDictionary.size();
+			rGraphVertices.push_back(kpVertex);
+		}
+	}
+
+	inline std::shared_ptr<Wire> Graph::ConstructPath(const GraphIndex& rkIndex, const std::vector<int>& rkPathIds) const
+	{
+		std::list<Vertex::Ptr> pathVertices;
+		for (const int kId : rkPathIds)
+		{
+			pathVertices.push_back(std::make_shared<Vertex>(rkIndex.OcctVertex(kId)));
+		}
+		return ConstructPath(pathVertices);
+	}
+
+	inline std::shared_ptr<Wire> Graph::Path(const std::vector<int>& rkPathVertexIds) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		for (const int kId : rkPathVertexIds)
+		{
+			if (kId < 0 || kId >= pIndex->NumOfVertices())
+			{
+				throw std::runtime_error("The vertex id is out of range.");
+			}
+		}
+		return ConstructPath(*pIndex, rkPathVertexIds);
+	}
+
+	inline void Graph::AllPaths(
+		const Vertex::Ptr& kpStartVertex,
+		const Vertex::Ptr& kpEndVertex,
+		const ProgressToken::Ptr& kpProgressToken,
+		std::list<std::shared_ptr<Wire>>& rPaths) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		const int kStartIndex = VertexId(pIndex, kpStartVertex);
+		const int kEndIndex = VertexId(pIndex, kpEndVertex);
+		if (kStartIndex < 0 || kEndIndex < 0)
+		{
+			return;
+		}
+
+		AllPaths(kStartIndex, kEndIndex, 0, 0, false, [&](const std::vector<int>& rkPath)
+		{
+			rPaths.push_back(ConstructPath(*pIndex, rkPath));
+			return true;
+		}, kpProgressToken);
+	}
+
+	inline int Graph::AllPaths(
+		const int kStartVertexId,
+		const int kEndVertexId,
+		const int kMaxLength,
+		const int kMaxNumOfPaths,
+		const bool kRunsParallel,
+		const PathCallback& rkCallback,
+		const ProgressToken::Ptr& kpProgressToken) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		if (kStartVertexId < 0 || kStartVertexId >= pIndex->NumOfVertices() || kEndVertexId < 0 || kEndVertexId >= pIndex->NumOfVertices())
+		{
+			throw std::runtime_error("The vertex id is out of range.");
+		}
+
+		if (!kRunsParallel || kStartVertexId == kEndVertexId)
+		{
+			PathEnumeration enumeration(rkCallback, kMaxNumOfPaths, false, kpProgressToken);
+			EnumeratePaths(*pIndex, kEndVertexId, kMaxLength, std::vector<int>(1, kStartVertexId), enumeration);
+			return enumeration.numOfPaths;
+		}
+
+		// The branches run on the thread pool from a search thread, while this thread delivers their paths.
+		PathEnumeration enumeration(rkCallback, kMaxNumOfPaths, true, kpProgressToken);
+		const int* kpFirstHops = pIndex->NeighboursBegin(kStartVertexId);
+		std::exception_ptr pSearchException;
+		std::thread searchThread([&]()
+		{
+			try
+			{
+				OSD_Parallel::For(0, pIndex->Degree(kStartVertexId), [&](const int i)
+				{
+					std::vector<int> prefix(1, kStartVertexId);
+					prefix.push_back(kpFirstHops[i]);
+					EnumeratePaths(*pIndex, kEndVertexId, kMaxLength, prefix, enumeration);
+				});
+			}
+			catch (...)
+			{
+				pSearchException = std::current_exception();
+			}
+			enumeration.Finish();
+		});
+
+		try
+		{
+			enumeration.Deliver();
+		}
+		catch (...)
+		{
+			enumeration.Stop();
+			searchThread.join();
+			throw;
+		}
+		searchThread.join();
+		if (pSearchException != nullptr)
+		{
+			std::rethrow_exception(pSearchException);
+		}
+		return enumeration.numOfPaths;
+	}
+
+	inline void Graph::AllPaths(
+		const int kStartVertexId,
+		const int kEndVertexId,
+		const int kMaxLength,
+		const int kMaxNumOfPaths,
+		const bool kRunsParallel,
+		std::vector<std::vector<int>>& rPaths,
+		const ProgressToken::Ptr& kpProgressToken) const
+	{
+		AllPaths(kStartVertexId, kEndVertexId, kMaxLength, kMaxNumOfPaths, kRunsParallel, [&](const std::vector<int>& rkPath)
+		{
+			rPaths.push_back(rkPath);
+			return true;
+		}, kpProgressToken);
+	}
+
+	inline void Graph::EnumeratePaths(const GraphIndex& rkIndex, const int kEndVertexId, const int kMaxLength, std::vector<int> path, PathEnumeration& rEnumeration)
+	{
+		if (rEnumeration.isStopped || (kMaxLength > 0 && (int)path.size() - 1 > kMaxLength))
+		{
+			return;
+		}
+		if (path.back() == kEndVertexId)
+		{
+			rEnumeration.Report(path);
+			return;
+		}
+
+		std::vector<uint64_t> onPathBits((rkIndex.NumOfVertices() + 63) / 64, 0);
+		for (const int kId : path)
+		{
+			onPathBits[kId >> 6] |= 1ULL << (kId & 63);
+		}
+
+		// One entry per vertex above the prefix: the next of its neighbours to visit. The vertices on the stack are
+		// never the end vertex, whose paths are reported without pushing it.
+		std::vector<int> nextNeighbours(1, 0);
+		size_t numOfSteps = 0;
+		while (!nextNeighbours.empty())
+		{
+			if ((++numOfSteps & 0x3ff) == 0)
+			{
+				if (rEnumeration.kpProgressToken != nullptr && rEnumeration.kpProgressToken->IsCancelled())
+				{
+					rEnumeration.isStopped = true;
+				}
+				if (rEnumeration.isStopped)
+				{
+					return;
+				}
+			}
+
+			const int kVertexId = path.back();
+			int& rNextNeighbour = nextNeighbours.back();
+			if (rNextNeighbour == rkIndex.Degree(kVertexId))
+			{
+				onPathBits[kVertexId >> 6] &= ~(1ULL << (kVertexId & 63));
+				path.pop_back();
+				nextNeighbours.pop_back();
+				continue;
+			}
+
+			const int kNeighbourId = rkIndex.NeighboursBegin(kVertexId)[rNextNeighbour++];
+			if ((onPathBits[kNeighbourId >> 6] >> (kNeighbourId & 63)) & 1ULL)
+			{
+				continue;
+			}
+
+			// With the neighbour, the path has path.size() edges.
+			if (kMaxLength > 0 && (int)path.size() > kMaxLength)
+			{
+				continue;
+			}
+			if (kNeighbourId == kEndVertexId)
+			{
+				path.push_back(kNeighbourId);
+				const bool kContinues = rEnumeration.Report(path);
+				path.pop_back();
+				if (!kContinues)
+				{
+					return;
+				}
+				continue;
+			}
+			if (kMaxLength > 0 && (int)path.size() >= kMaxLength)
+			{
+				continue;
+			}
+
+			onPathBits[kNeighbourId >> 6] |= 1ULL << (kNeighbourId & 63);
+			path.push_back(kNeighbourId);
+			nextNeighbours.push_back(0);
+		}
+	}
+
+	inline GraphIndex::EdgeWeights::Ptr Graph::ResolveEdgeWeights(const GraphIndex& rkIndex, const std::string& rkVertexKey, const std::string& rkEdgeKey) const
+	{
+		std::string upperCaseEdgeKey(rkEdgeKey);
+		std::transform(upperCaseEdgeKey.begin(), upperCaseEdgeKey.end(), upperCaseEdgeKey.begin(), ::toupper);
+		const bool kIsCached = rkVertexKey.empty() && (rkEdgeKey.empty() || upperCaseEdgeKey == "DISTANCE" || upperCaseEdgeKey == "LENGTH");
+		const std::string kKey = rkVertexKey + '\n' + rkEdgeKey;
+		if (kIsCached)
+		{
+			GraphIndex::EdgeWeights::Ptr pEdgeWeights = rkIndex.FindEdgeWeights(kKey);
+			if (pEdgeWeights != nullptr)
+			{
+				return pEdgeWeights;
+			}
+		}
+
+		std::shared_ptr<GraphIndex::EdgeWeights> pNewEdgeWeights = std::make_shared<GraphIndex::EdgeWeights>();
+		pNewEdgeWeights->values.reserve(rkIndex.Targets().size());
+		pNewEdgeWeights->minCostPerLength = std::numeric_limits<double>::max();
+		for (int i = 0; i < rkIndex.NumOfVertices(); ++i)
+		{
+			for (int slot = rkIndex.Offsets()[i]; slot < rkIndex.Offsets()[i + 1]; ++slot)
+			{
+				// As ComputeCost: the cost of the target vertex plus that of the edge.
+				const int kNeighbourId = rkIndex.Targets()[slot];
+				const double kVertexCost = ComputeVertexCost(rkIndex.OcctVertex(kNeighbourId), rkVertexKey);
+				const double kEdgeCost = ComputeEdgeCost(rkIndex, i, slot, rkEdgeKey);
+				const double kCost = (kVertexCost == std::numeric_limits<double>::max() || kEdgeCost == std::numeric_limits<double>::max()) ?
+					std::numeric_limits<double>::max() : kVertexCost + kEdgeCost;
+				if (kCost < 0.0)
+				{
+					throw std::runtime_error("The cost of an edge is negative.");
+				}
+				const double kLength = rkIndex.OcctPoint(i).Distance(rkIndex.OcctPoint(kNeighbourId));
+				if (kLength > Precision::Confusion())
+				{
+					pNewEdgeWeights->minCostPerLength = std::min(pNewEdgeWeights->minCostPerLength, kCost / kLength);
+				}
+				pNewEdgeWeights->values.push_back(kCost);
+			}
+		}
+		if (pNewEdgeWeights->minCostPerLength == std::numeric_limits<double>::max())
+		{
+			pNewEdgeWeights->minCostPerLength = 0.0;
+		}
+
+		if (kIsCached)
+		{
+			rkIndex.AddEdgeWeights(kKey, pNewEdgeWeights);
+		}
+		return pNewEdgeWeights;
+	}
+
+	inline double Graph::ComputeEdgeCost(const GraphIndex& rkIndex, const int kVertexId, const int kSlot, const std::string& rkEdgeKey) const
+	{
+		const int kNeighbourId = rkIndex.Targets()[kSlot];
+		const int kEdgeIndex = rkIndex.SlotEdgeIndex(kSlot);
+		if (kEdgeIndex < 0)
+		{
+			return ComputeEdgeCost(rkIndex.OcctVertex(kVertexId), rkIndex.OcctVertex(kNeighbourId), rkEdgeKey);
+		}
+		if (rkEdgeKey.empty())
+		{
+			return 1.0;
+		}
+
+		std::string upperCaseEdgeKey(rkEdgeKey);
+		std::transform(upperCaseEdgeKey.begin(), upperCaseEdgeKey.end(), upperCaseEdgeKey.begin(), ::toupper);
+		if (upperCaseEdgeKey == "DISTANCE" || upperCaseEdgeKey == "LENGTH")
+		{
+			return rkIndex.OcctPoint(kVertexId).Distance(rkIndex.OcctPoint(kNeighbourId));
+		}
+
+		std::shared_ptr<Attribute> pAttribute = AttributeManager::GetInstance().Find(rkIndex.OcctEdge(kEdgeIndex), rkEdgeKey);
+		if (pAttribute == nullptr)
+		{
+			return 1.0;
+		}
+		std::shared_ptr<DoubleAttribute> pDoubleAttribute = std::dynamic_pointer_cast<DoubleAttribute>(pAttribute);
+		if (pDoubleAttribute != nullptr)
+		{
+			return pDoubleAttribute->DoubleValue();
+		}
+		std::shared_ptr<IntAttribute> pIntAttribute = std::dynamic_pointer_cast<IntAttribute>(pAttribute);
+		if (pIntAttribute != nullptr)
+		{
+			return (double)pIntAttribute->IntValue();
+		}
+		return ComputeEdgeCost(rkIndex.OcctVertex(kVertexId), rkIndex.OcctVertex(kNeighbourId), rkEdgeKey);
+	}
+
+	inline std::shared_ptr<Wire> Graph::ShortestPath(
+		const Vertex::Ptr& kpStartVertex,
+		const Vertex::Ptr& kpEndVertex,
+		const std::string& rkVertexKey,
+		const std::string& rkEdgeKey,
+		const ProgressToken::Ptr& kpProgressToken,
+		const bool kUsesAStar) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		const int kStartIndex = VertexId(pIndex, kpStartVertex);
+		const int kEndIndex = VertexId(pIndex, kpEndVertex);
+		if (kStartIndex < 0 || kEndIndex < 0)
+		{
+			return nullptr;
+		}
+
+		std::vector<int> path;
+		if (ShortestPath(kStartIndex, kEndIndex, rkVertexKey, rkEdgeKey, kUsesAStar, path, kpProgressToken) < 0.0)
+		{
+			return nullptr;
+		}
+		return ConstructPath(*pIndex, path);
+	}
+
+	inline double Graph::ShortestPath(
+		const int kStartVertexId,
+		const int kEndVertexId,
+		const std::string& rkVertexKey,
+		const std::string& rkEdgeKey,
+		const bool kUsesAStar,
+		std::vector<int>& rPathVertexIds,
+		const ProgressToken::Ptr& kpProgressToken) const
+	{
+		rPathVertexIds.clear();
+		GraphIndex::Ptr pIndex = Index();
+		if (kStartVertexId < 0 || kStartVertexId >= pIndex->NumOfVertices() || kEndVertexId < 0 || kEndVertexId >= pIndex->NumOfVertices())
+		{
+			throw std::runtime_error("The vertex id is out of range.");
+		}
+
+		GraphIndex::EdgeWeights::Ptr pEdgeWeights = ResolveEdgeWeights(*pIndex, rkVertexKey, rkEdgeKey);
+		const double kHeuristicScale = kUsesAStar ? pEdgeWeights->minCostPerLength : 0.0;
+		return SearchPath(*pIndex, *pEdgeWeights, kStartVertexId, kEndVertexId, kHeuristicScale, nullptr, nullptr, rPathVertexIds, kpProgressToken);
+	}
+
+	inline double Graph::SearchPath(
+		const GraphIndex& rkIndex,
+		const GraphIndex::EdgeWeights& rkEdgeWeights,
+		const int kStartVertexId,
+		const int kEndVertexId,
+		const double kHeuristicScale,
+		const std::vector<bool>* kpIsBannedVertex,
+		const std::vector<bool>* kpIsBannedSlot,
+		std::vector<int>& rPathVertexIds,
+		const ProgressToken::Ptr& kpProgressToken)
+	{
+		rPathVertexIds.clear();
+		const std::vector<int>& rkOffsets = rkIndex.Offsets();
+		const std::vector<int>& rkTargets = rkIndex.Targets();
+		const gp_Pnt& rkOcctEndPoint = rkIndex.OcctPoint(kEndVertexId);
+
+		static thread_local std::vector<double> distances;
+		static thread_local std::vector<int> previousIndices;
+		static thread_local std::vector<bool> isSettled;
+		if (distances.size() != (size_t)rkIndex.NumOfVertices())
+		{
+			distances.assign(rkIndex.NumOfVertices(), std::numeric_limits<double>::max());
+			previousIndices.assign(rkIndex.NumOfVertices(), -1);
+			isSettled.assign(rkIndex.NumOfVertices(), false);
+		}
+
+		// Items are (cost so far + heuristic, vertex). With a zero heuristic this is Dijkstra's algorithm.
+		typedef std::pair<double, int> QueueItem;
+		std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+		// The vertices given a distance, to reset the scratch arrays.
+		std::vector<int> reachedIndices(1, kStartVertexId);
+		distances[kStartVertexId] = 0.0;
+		queue.push(QueueItem(kHeuristicScale * rkIndex.OcctPoint(kStartVertexId).Distance(rkOcctEndPoint), kStartVertexId));
+		bool isCancelled = false;
+		size_t numOfSteps = 0;
+		while (!queue.empty())
+		{
+			if ((++numOfSteps & 0x3ff) == 0 && kpProgressToken != nullptr && kpProgressToken->IsCancelled())
+			{
+				isCancelled = true;
+				break;
+			}
+
+			const int kVertexIndex = queue.top().second;
+			queue.pop();
+			if (isSettled[kVertexIndex])
+			{
+				continue;
+			}
+			isSettled[kVertexIndex] = true;
+			if (kVertexIndex == kEndVertexId)
+			{
+				break;
+			}
+
+			for (int slot = rkOffsets[kVertexIndex]; slot < rkOffsets[kVertexIndex + 1]; ++slot)
+			{
+				const int kNeighbourIndex = rkTargets[slot];
+				if ((kpIsBannedVertex != nullptr && (*kpIsBannedVertex)[kNeighbourIndex]) || (kpIsBannedSlot != nullptr && (*kpIsBannedSlot)[slot]))
+				{
+					continue;
+				}
+				const double kDistance = distances[kVertexIndex] + rkEdgeWeights.values[slot];
+				if (!isSettled[kNeighbourIndex] && kDistance < distances[kNeighbourIndex])
+				{
+					if (distances[kNeighbourIndex] == std::numeric_limits<double>::max())
+					{
+						reachedIndices.push_back(kNeighbourIndex);
+					}
+					distances[kNeighbourIndex] = kDistance;
+					previousIndices[kNeighbourIndex] = kVertexIndex;
+					const double kHeuristic = kHeuristicScale == 0.0 ? 0.0 : kHeuristicScale * rkIndex.OcctPoint(kNeighbourIndex).Distance(rkOcctEndPoint);
+					queue.push(QueueItem(kDistance + kHeuristic, kNeighbourIndex));
+				}
+			}
+		}
+
+		double cost = -1.0;
+		if (!isCancelled && (kStartVertexId == kEndVertexId || previousIndices[kEndVertexId] >= 0))
+		{
+			for (int vertexIndex = kEndVertexId; vertexIndex >= 0; vertexIndex = previousIndices[vertexIndex])
+			{
+				rPathVertexIds.push_back(vertexIndex);
+			}
+			std::reverse(rPathVertexIds.begin(), rPathVertexIds.end());
+			cost = distances[kEndVertexId];
+		}
+
+		for (const int kVertexIndex : reachedIndices)
+		{
+			distances[kVertexIndex] = std::numeric_limits<double>::max();
+			previousIndices[kVertexIndex] = -1;
+			isSettled[kVertexIndex] = false;
+		}
+		if (isCancelled)
+		{
+			ProgressToken::ThrowIfCancelled(kpProgressToken);
+		}
+		return cost;
+	}
+
+	inline void Graph::ShortestPaths(
+		const Vertex::Ptr& kpStartVertex,
+		const Vertex::Ptr& kpEndVertex,
+		const std::string& rkVertexKey,
+		const std::string& rkEdgeKey,
+		const ProgressToken::Ptr& kpProgressToken,
+		std::list<std::shared_ptr<Wire>>& rPaths) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		const int kStartIndex = VertexId(pIndex, kpStartVertex);
+		const int kEndIndex = VertexId(pIndex, kpEndVertex);
+		if (kStartIndex < 0 || kEndIndex < 0)
+		{
+			return;
+		}
+
+		ShortestPaths(kStartIndex, kEndIndex, rkVertexKey, rkEdgeKey, 0, [&](const std::vector<int>& rkPath)
+		{
+			rPaths.push_back(ConstructPath(*pIndex, rkPath));
+			return true;
+		}, kpProgressToken);
+	}
+
+	inline double Graph::ShortestPaths(
+		const int kStartVertexId,
+		const int kEndVertexId,
+		const std::string& rkVertexKey,
+		const std::string& rkEdgeKey,
+		const int kMaxNumOfPaths,
+		const PathCallback& rkCallback,
+		const ProgressToken::Ptr& kpProgressToken) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		if (kStartVertexId < 0 || kStartVertexId >= pIndex->NumOfVertices() || kEndVertexId < 0 || kEndVertexId >= pIndex->NumOfVertices())
+		{
+			throw std::runtime_error("The vertex id is out of range.");
+		}
+
+		GraphIndex::EdgeWeights::Ptr pEdgeWeights = ResolveEdgeWeights(*pIndex, rkVertexKey, rkEdgeKey);
+		GraphIndex::ShortestPathDag dag;
+		pIndex->SearchDag(kStartVertexId, kEndVertexId, pEdgeWeights.get(), dag);
+		if (dag.vertexIds.back() != kEndVertexId)
+		{
+			return -1.0;
+		}
+
+		// Depth-first search backwards from the end vertex, with an explicit stack of (position in the graph, next
+		// predecessor to visit). Every vertex but the source has a predecessor, so every branch ends in a path.
+		const int kEndPosition = (int)dag.vertexIds.size() - 1;
+		std::vector<int> positions(1, kEndPosition);
+		std::vector<int> nextPredecessors(1, dag.predecessorOffsets[kEndPosition]);
+		std::vector<int> path;
+		int numOfPaths = 0;
+		size_t numOfSteps = 0;
+		while (!positions.empty())
+		{
+			if ((++numOfSteps & 0x3ff) == 0)
+			{
+				ProgressToken::ThrowIfCancelled(kpProgressToken);
+			}
+
+			const int kPosition = positions.back();
+			if (kPosition == 0)
+			{
+				path.clear();
+				for (auto positionIterator = positions.rbegin(); positionIterator != positions.rend(); ++positionIterator)
+				{
+					path.push_back(dag.vertexIds[*positionIterator]);
+				}
+				++numOfPaths;
+				if (!rkCallback(path) || (kMaxNumOfPaths > 0 && numOfPaths >= kMaxNumOfPaths))
+				{
+					break;
+				}
+				positions.pop_back();
+				nextPredecessors.pop_back();
+				continue;
+			}
+
+			int& rNextPredecessor = nextPredecessors.back();
+			if (rNextPredecessor == dag.predecessorOffsets[kPosition + 1])
+			{
+				positions.pop_back();
+				nextPredecessors.pop_back();
+				continue;
+			}
+			const int kPredecessorPosition = dag.predecessorPositions[rNextPredecessor++];
+			positions.push_back(kPredecessorPosition);
+			nextPredecessors.push_back(dag.predecessorOffsets[kPredecessorPosition]);
+		}
+		return dag.distances.back();
+	}
+
+	inline double Graph::ShortestPaths(
+		const int kStartVertexId,
+		const int kEndVertexId,
+		const std::string& rkVertexKey,
+		const std::string& rkEdgeKey,
+		const int kMaxNumOfPaths,
+		std::vector<std::vector<int>>& rPaths,
+		const ProgressToken::Ptr& kpProgressToken) const
+	{
+		return ShortestPaths(kStartVertexId, kEndVertexId, rkVertexKey, rkEdgeKey, kMaxNumOfPaths, [&](const std::vector<int>& rkPath)
+		{
+			rPaths.push_back(rkPath);
+			return true;
+		}, kpProgressToken);
+	}
+
+	inline double Graph::NumOfShortestPaths(
+		const int kStartVertexId,
+		const int kEndVertexId,
+		const std::string& rkVertexKey,
+		const std::string& rkEdgeKey) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		if (kStartVertexId < 0 || kStartVertexId >= pIndex->NumOfVertices() || kEndVertexId < 0 || kEndVertexId >= pIndex->NumOfVertices())
+		{
+			throw std::runtime_error("The vertex id is out of range.");
+		}
+
+		GraphIndex::EdgeWeights::Ptr pEdgeWeights = ResolveEdgeWeights(*pIndex, rkVertexKey, rkEdgeKey);
+		GraphIndex::ShortestPathDag dag;
+		pIndex->SearchDag(kStartVertexId, kEndVertexId, pEdgeWeights.get(), dag);
+		if (dag.vertexIds.back() != kEndVertexId)
+		{
+			return 0.0;
+		}
+
+		// The predecessors come first in the order of the graph.
+		std::vector<double> numOfPaths(dag.vertexIds.size(), 0.0);
+		numOfPaths[0] = 1.0;
+		for (size_t position = 1; position < dag.vertexIds.size(); ++position)
+		{
+			for (int i = dag.predecessorOffsets[position]; i < dag.predecessorOffsets[position + 1]; ++i)
+			{
+				numOfPaths[position] += numOfPaths[dag.predecessorPositions[i]];
+			}
+		}
+		return numOfPaths.back();
+	}
+
+	inline void Graph::KShortestPaths(
+		const int kStartVertexId,
+		const int kEndVertexId,
+		const std::string& rkVertexKey,
+		const std::string& rkEdgeKey,
+		const int kNumOfPaths,
+		std::vector<std::vector<int>>& rPaths,
+		std::vector<double>& rCosts,
+		const ProgressToken::Ptr& kpProgressToken) const
+	{
+		rPaths.clear();
+		rCosts.clear();
+		GraphIndex::Ptr pIndex = Index();
+		if (kStartVertexId < 0 || kStartVertexId >= pIndex->NumOfVertices() || kEndVertexId < 0 || kEndVertexId >= pIndex->NumOfVertices())
+		{
+			throw std::runtime_error("The vertex id is out of range.");
+		}
+		if (kNumOfPaths <= 0)
+		{
+			return;
+		}
+
+		GraphIndex::EdgeWeights::Ptr pEdgeWeights = ResolveEdgeWeights(*pIndex, rkVertexKey, rkEdgeKey);
+		std::vector<int> path;
+		const double kCost = SearchPath(*pIndex, *pEdgeWeights, kStartVertexId, kEndVertexId, 0.0, nullptr, nullptr, path, kpProgressToken);
+		if (kCost < 0.0)
+		{
+			return;
+		}
+		rPaths.push_back(path);
+		rCosts.push_back(kCost);
+
+		// The candidates are ordered by cost, then by their vertices so that ties are broken the same way every time.
+		typedef std::pair<double, std::vector<int>> Candidate;
+		std::set<Candidate> candidates;
+		std::set<std::vector<int>> foundPaths;
+		foundPaths.insert(path);
+		std::vector<bool> isBannedVertex(pIndex->NumOfVertices(), false);
+		std::vector<bool> isBannedSlot(pIndex->Targets().size(), false);
+		std::vector<int> bannedSlots;
+		std::vector<int> spurPath;
+		while ((int)rPaths.size() < kNumOfPaths)
+		{
+			const std::vector<int> kPreviousPath = rPaths.back();
+			double rootCost = 0.0;
+			for (size_t i = 0; i + 1 < kPreviousPath.size(); ++i)
+			{
+				ProgressToken::ThrowIfCancelled(kpProgressToken);
+				const int kSpurId = kPreviousPath[i];
+				if (i > 0)
+				{
+					rootCost += pEdgeWeights->values[pIndex->Slot(kPreviousPath[i - 1], kSpurId)];
+					isBannedVertex[kPreviousPath[i - 1]] = true;
+				}
+
+				// The paths found so far with the same root leave the spur vertex through edges that must not be taken again.
+				for (const std::vector<int>& rkPath : rPaths)
+				{
+					if (rkPath.size() > i + 1 && std::equal(kPreviousPath.begin(), kPreviousPath.begin() + i + 1, rkPath.begin()))
+					{
+						const int kSlot = pIndex->Slot(kSpurId, rkPath[i + 1]);
+						if (!isBannedSlot[kSlot])
+						{
+							isBannedSlot[kSlot] = true;
+							bannedSlots.push_back(kSlot);
+						}
+					}
+				}
+
+				const double kSpurCost = SearchPath(*pIndex, *pEdgeWeights, kSpurId, kEndVertexId, 0.0, &isBannedVertex, &isBannedSlot, spurPath, kpProgressToken);
+				for (const int kSlot : bannedSlots)
+				{
+					isBannedSlot[kSlot] = false;
+				}
+				bannedSlots.clear();
+				if (kSpurCost < 0.0)
+				{
+					continue;
+				}
+
+				std::vector<int> candidatePath(kPreviousPath.begin(), kPreviousPath.begin() + i);
+				candidatePath.insert(candidatePath.end(), spurPath.begin(), spurPath.end());
+				if (foundPaths.insert(candidatePath).second)
+				{
+					candidates.insert(Candidate(rootCost + kSpurCost, candidatePath));
+				}
+			}
+			for (const int kId : kPreviousPath)
+			{
+				isBannedVertex[kId] = false;
+			}
+
+			if (candidates.empty())
+			{
+				break;
+			}
+			rPaths.push_back(candidates.begin()->second);
+			rCosts.push_back(candidates.begin()->first);
+			candidates.erase(candidates.begin());
+		}
+	}
+
+	inline void Graph::ShortestPathTrees(
+		const std::vector<int>& rkSourceVertexIds,
+		const std::string& rkVertexKey,
+		const std::string& rkEdgeKey,
+		const bool kIsTopological,
+		const double kMaxDistance,
+		std::vector<GraphIndex::ShortestPathTree>& rTrees,
+		const ProgressToken::Ptr& kpProgressToken) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		std::vector<int> sourceIds = rkSourceVertexIds;
+		if (sourceIds.empty())
+		{
+			for (int i = 0; i < pIndex->NumOfVertices(); ++i)
+			{
+				sourceIds.push_back(i);
+			}
+		}
+		for (const int kSourceId : sourceIds)
+		{
+			if (kSourceId < 0 || kSourceId >= pIndex->NumOfVertices())
+			{
+				throw std::runtime_error("The vertex id is out of range.");
+			}
+		}
+
+		// ComputeCost reads the dictionaries, so the costs are resolved before going parallel.
+		GraphIndex::EdgeWeights::Ptr pEdgeWeights = kIsTopological ? nullptr : ResolveEdgeWeights(*pIndex, rkVertexKey, rkEdgeKey);
+		rTrees.assign(sourceIds.size(), GraphIndex::ShortestPathTree());
+		OSD_Parallel::For(0, (int)sourceIds.size(), [&](const int i)
+		{
+			if (kpProgressToken == nullptr || !kpProgressToken->IsCancelled())
+			{
+				pIndex->Search(sourceIds[i], pEdgeWeights.get(), kMaxDistance, rTrees[i]);
+			}
+		});
+		ProgressToken::ThrowIfCancelled(kpProgressToken);
+	}
+
+	inline void Graph::DistanceMatrix(
+		const std::vector<int>& rkSourceVertexIds,
+		const std::string& rkVertexKey,
+		const std::string& rkEdgeKey,
+		const bool kIsTopological,
+		const double kMaxDistance,
+		std::vector<std::vector<double>>& rDistances,
+		std::vector<std::vector<int>>& rPredecessorIds,
+		const ProgressToken::Ptr& kpProgressToken) const
+	{
+		std::vector<GraphIndex::ShortestPathTree> trees;
+		ShortestPathTrees(rkSourceVertexIds, rkVertexKey, rkEdgeKey, kIsTopological, kMaxDistance, trees, kpProgressToken);
+
+		const int kNumOfVertices = Index()->NumOfVertices();
+		rDistances.assign(trees.size(), std::vector<double>(kNumOfVertices, -1.0));
+		rPredecessorIds.assign(trees.size(), std::vector<int>(kNumOfVertices, -1));
+		for (size_t i = 0; i < trees.size(); ++i)
+		{
+			const GraphIndex::ShortestPathTree& rkTree = trees[i];
+			for (size_t j = 0; j < rkTree.vertexIds.size(); ++j)
+			{
+				rDistances[i][rkTree.vertexIds[j]] = rkTree.distances[j];
+				rPredecessorIds[i][rkTree.vertexIds[j]] = rkTree.predecessorIds[j];
+			}
+		}
+	}
+
+	inline int Graph::Eccentricity(const int kVertexId) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		if (kVertexId < 0 || kVertexId >= pIndex->NumOfVertices())
+		{
+			throw std::runtime_error("The vertex id is out of range.");
+		}
+
+		GraphIndex::ShortestPathTree tree;
+		pIndex->Search(kVertexId, nullptr, -1.0, tree);
+		return (int)tree.distances.back();
+	}
+
+	inline void Graph::Eccentricities(std::vector<int>& rEccentricities, const ProgressToken::Ptr& kpProgressToken) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		rEccentricities.assign(pIndex->NumOfVertices(), 0);
+		OSD_Parallel::For(0, pIndex->NumOfVertices(), [&](const int i)
+		{
+			if (kpProgressToken == nullptr || !kpProgressToken->IsCancelled())
+			{
+				GraphIndex::ShortestPathTree tree;
+				pIndex->Search(i, nullptr, -1.0, tree);
+				rEccentricities[i] = (int)tree.distances.back();
+			}
+		});
+		ProgressToken::ThrowIfCancelled(kpProgressToken);
+	}
+
+	inline int Graph::Diameter(const bool kIsApproximate, const ProgressToken::Ptr& kpProgressToken) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		const int kNumOfVertices = pIndex->NumOfVertices();
+		std::vector<bool> isVisited(kNumOfVertices, false);
+		std::vector<int> predecessorIds(kNumOfVertices, -1);
+		GraphIndex::ShortestPathTree tree;
+		int diameter = 0;
+		for (int rootId = 0; rootId < kNumOfVertices; ++rootId)
+		{
+			if (isVisited[rootId])
+			{
+				continue;
+			}
+
+			// The component of the root, and its vertex of highest degree.
+			pIndex->Search(rootId, nullptr, -1.0, tree);
+			int hubId = rootId;
+			for (const int kId : tree.vertexIds)
+			{
+				isVisited[kId] = true;
+				if (pIndex->Degree(kId) > pIndex->Degree(hubId))
+				{
+					hubId = kId;
+				}
+			}
+			if (tree.vertexIds.size() < 2)
+			{
+				continue;
+			}
+
+			// Double sweep: the vertex furthest from the hub, then the one furthest from it.
+			pIndex->Search(hubId, nullptr, -1.0, tree);
+			pIndex->Search(tree.vertexIds.back(), nullptr, -1.0, tree);
+			const int kLowerBound = (int)tree.distances.back();
+			if (kIsApproximate)
+			{
+				diameter = std::max(diameter, kLowerBound);
+				continue;
+			}
+
+			// The centre is the middle of the path found by the second sweep.
+			for (size_t i = 0; i < tree.vertexIds.size(); ++i)
+			{
+				predecessorIds[tree.vertexIds[i]] = tree.predecessorIds[i];
+			}
+			int centreId = tree.vertexIds.back();
+			for (int i = 0; i < kLowerBound / 2; ++i)
+			{
+				centreId = predecessorIds[centreId];
+			}
+			diameter = std::max(diameter, FringeDiameter(*pIndex, centreId, kLowerBound, kpProgressToken));
+			ProgressToken::ThrowIfCancelled(kpProgressToken);
+		}
+		return diameter;
+	}
+
+	inline int Graph::FringeDiameter(const GraphIndex& rkIndex, const int kCentreId, const int kLowerBound, const ProgressToken::Ptr& kpProgressToken)
+	{
+		GraphIndex::ShortestPathTree centreTree;
+		rkIndex.Search(kCentreId, nullptr, -1.0, centreTree);
+		int level = (int)centreTree.distances.back();
+		int lowerBound = std::max(kLowerBound, level);
+
+		// The tree is in breadth-first order, so each fringe is a contiguous range at the end.
+		size_t fringeEnd = centreTree.vertexIds.size();
+		while (2 * level > lowerBound)
+		{
+			size_t fringeBegin = fringeEnd;
+			while (fringeBegin > 0 && (int)centreTree.distances[fringeBegin - 1] == level)
+			{
+				--fringeBegin;
+			}
+
+			std::atomic<int> fringeEccentricity(0);
+			OSD_Parallel::For((int)fringeBegin, (int)fringeEnd, [&](const int i)
+			{
+				if (kpProgressToken != nullptr && kpProgressToken->IsCancelled())
+				{
+					return;
+				}
+
+				GraphIndex::ShortestPathTree tree;
+				rkIndex.Search(centreTree.vertexIds[i], nullptr, -1.0, tree);
+				const int kEccentricity = (int)tree.distances.back();
+				int currentEccentricity = fringeEccentricity;
+				while (kEccentricity > currentEccentricity && !fringeEccentricity.compare_exchange_weak(currentEccentricity, kEccentricity))
+				{
+				}
+			});
+			ProgressToken::ThrowIfCancelled(kpProgressToken);
+
+			lowerBound = std::max(lowerBound, fringeEccentricity.load());
+			if (lowerBound > 2 * (level - 1))
+			{
+				return lowerBound;
+			}
+			--level;
+			fringeEnd = fringeBegin;
+		}
+		return lowerBound;
+	}
+
+	inline void Graph::Centrality(const CentralityType kType, const CentralityOptions& rkOptions, std::vector<double>& rValues) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		GraphIndex::EdgeWeights::Ptr pEdgeWeights = rkOptions.isTopological ? nullptr : ResolveEdgeWeights(*pIndex, rkOptions.vertexKey, rkOptions.edgeKey);
+		GraphCentrality::Compute(*pIndex, pEdgeWeights.get(), kType, rkOptions, rValues);
+	}
+
+	inline void Graph::Centrality(const CentralityType kType, const CentralityOptions& rkOptions, const std::string& rkDictionaryKey) const
+	{
+		GraphIndex::Ptr pIndex = Index();
+		std::vector<double> values;
+		Centrality(kType, rkOptions, values);
+		for (int i = 0; i < (int)values.size(); ++i)
+		{
+			AttributeManager::GetInstance().Add(pIndex->OcctVertex(i), rkDictionaryKey, std::make_shared<DoubleAttribute>(values[i]));
+		}
+	}
 }
@@ -0,0 +1,430 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+#include "GraphIndex.h"
+#include "ProgressToken.h"
+
+#include <OSD_Parallel.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TopologicCore
+{
+	enum CentralityType
+	{
+		CENTRALITY_BETWEENNESS,
+		CENTRALITY_CLOSENESS,
+		CENTRALITY_INTEGRATION
+	};
+
+	/// <summary>
+	/// Settings of the centrality measures of a Graph.
+	/// </summary>
+	struct CentralityOptions
+	{
+		CentralityOptions()
+			: isTopological(true)
+			, radius(-1.0)
+			, numOfSamples(0)
+			, seed(0)
+			, isNormalized(false)
+		{
+		}
+
+		/// <summary>
+		/// Counts the edges on the paths. Otherwise, the costs are those of Graph::ComputeCost for the keys below.
+		/// </summary>
+		bool isTopological;
+
+		std::string vertexKey;
+
+		std::string edgeKey;
+
+		/// <summary>
+		/// Only the paths up to this length (in edges, or in cost) are considered, as in the "radius n" measures of
+		/// space syntax. Negative for no limit.
+		/// </summary>
+		double radius;
+
+		/// <summary>
+		/// Searches from this many random source vertices only and extrapolates to the whole graph. 0 to search from
+		/// every vertex.
+		/// </summary>
+		int numOfSamples;
+
+		/// <summary>
+		/// The seed of the random choice of the sources.
+		/// </summary>
+		unsigned int seed;
+
+		/// <summary>
+		/// Divides betweenness by the number of pairs of other vertices, and scales closeness by the fraction of the
+		/// other vertices that are reached (Wasserman and Faust).
+		/// </summary>
+		bool isNormalized;
+
+		/// <summary>
+		/// Stops the computation, which then throws, when cancelled. Null by default.
+		/// </summary>
+		ProgressToken::Ptr progressToken;
+	};
+
+	/// <summary>
+	/// Centrality measures over a GraphIndex, computed by one search per source vertex, in parallel on the OCCT thread pool.
+	/// Betweenness uses Brandes' accumulation of pair dependencies. Closeness is the number of reached vertices divided by
+	/// the sum of their distances. Integration is the inverse of the real relative asymmetry of space syntax (Hillier and
+	/// Hanson), from the mean depth of the reached vertices.
+	/// </summary>
+	class GraphCentrality
+	{
+	public:
+		/// <summary>
+		/// Computes a centrality measure for every vertex of an index.
+		/// </summary>
+		/// <param name="rkIndex"></param>
+		/// <param name="kpEdgeWeights">Null for topological distances</param>
+		/// <param name="kType"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="rValues">One per vertex id</param>
+		static void Compute(
+			const GraphIndex& rkIndex,
+			const GraphIndex::EdgeWeights* kpEdgeWeights,
+			const CentralityType kType,
+			const CentralityOptions& rkOptions,
+			std::vector<double>& rValues)
+		{
+			const int kNumOfVertices = rkIndex.NumOfVertices();
+			std::vector<int> sourceIds(kNumOfVertices);
+			std::iota(sourceIds.begin(), sourceIds.end(), 0);
+			const bool kIsSampled = rkOptions.numOfSamples > 0 && rkOptions.numOfSamples < kNumOfVertices;
+			if (kIsSampled)
+			{
+				std::mt19937 randomGenerator(rkOptions.seed);
+				std::shuffle(sourceIds.begin(), sourceIds.end(), randomGenerator);
+				sourceIds.resize(rkOptions.numOfSamples);
+			}
+
+			// Betweenness is accumulated at the vertices on the paths, and the distances of a sampled search at the
+			// vertices reached (the distances being symmetric); an exact closeness belongs to the source itself.
+			const bool kAccumulatesAtTargets = kType == CENTRALITY_BETWEENNESS || kIsSampled;
+			std::vector<double> sums(kNumOfVertices, 0.0);
+			std::vector<double> counts(kNumOfVertices, 0.0);
+			std::mutex mutex;
+
+			// One task per worker, each with its own scratch and sums, taking the sources from a shared counter so that the
+			// load stays balanced.
+			const int kNumOfWorkers = std::max(1, std::min((int)sourceIds.size(), OSD_Parallel::NbLogicalProcessors()));
+			std::atomic<size_t> nextSourceIndex(0);
+			OSD_Parallel::For(0, kNumOfWorkers, [&](const int)
+			{
+				Scratch scratch(kNumOfVertices);
+				std::vector<double> workerSums(kAccumulatesAtTargets ? kNumOfVertices : 0, 0.0);
+				std::vector<double> workerCounts(kAccumulatesAtTargets ? kNumOfVertices : 0, 0.0);
+				for (size_t i = nextSourceIndex++; i < sourceIds.size(); i = nextSourceIndex++)
+				{
+					if (rkOptions.progressToken != nullptr && rkOptions.progressToken->IsCancelled())
+					{
+						return;
+					}
+
+					const int kSourceId = sourceIds[i];
+					Search(rkIndex, kpEdgeWeights, kSourceId, rkOptions.radius, kType == CENTRALITY_BETWEENNESS, scratch);
+					if (kType == CENTRALITY_BETWEENNESS)
+					{
+						AccumulateDependencies(kSourceId, scratch, workerSums);
+					}
+					else if (kAccumulatesAtTargets)
+					{
+						for (const int kId : scratch.settledIds)
+						{
+							workerSums[kId] += scratch.distances[kId];
+							workerCounts[kId] += 1.0;
+						}
+					}
+					else
+					{
+						double sum = 0.0;
+						for (const int kId : scratch.settledIds)
+						{
+							sum += scratch.distances[kId];
+						}
+						// Each source writes its own entries.
+						sums[kSourceId] = sum;
+						counts[kSourceId] = (double)scratch.settledIds.size();
+					}
+					scratch.Reset();
+				}
+
+				if (kAccumulatesAtTargets)
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					for (int j = 0; j < kNumOfVertices; ++j)
+					{
+						sums[j] += workerSums[j];
+						counts[j] += workerCounts[j];
+					}
+				}
+			});
+			ProgressToken::ThrowIfCancelled(rkOptions.progressToken);
+
+			const double kScale = kIsSampled ? (double)kNumOfVertices / (double)sourceIds.size() : 1.0;
+			rValues.assign(kNumOfVertices, 0.0);
+			for (int i = 0; i < kNumOfVertices; ++i)
+			{
+				if (kType == CENTRALITY_BETWEENNESS)
+				{
+					// Each unordered pair of endpoints is counted from both ends.
+					double betweenness = 0.5 * kScale * sums[i];
+					if (rkOptions.isNormalized && kNumOfVertices > 2)
+					{
+						betweenness *= 2.0 / ((double)(kNumOfVertices - 1) * (double)(kNumOfVertices - 2));
+					}
+					rValues[i] = betweenness;
+					continue;
+				}
+
+				// The source itself was reached at distance 0.
+				const double kNumOfReachedVertices = kScale * counts[i] - 1.0;
+				const double kTotalDistance = kScale * sums[i];
+				if (kNumOfReachedVertices < 1.0 || kTotalDistance <= 0.0)
+				{
+					continue;
+				}
+
+				if (kType == CENTRALITY_CLOSENESS)
+				{
+					double closeness = kNumOfReachedVertices / kTotalDistance;
+					if (rkOptions.isNormalized && kNumOfVertices > 1)
+					{
+						closeness *= kNumOfReachedVertices / (double)(kNumOfVertices - 1);
+					}
+					rValues[i] = closeness;
+				}
+				else
+				{
+					rValues[i] = Integration(kTotalDistance / kNumOfReachedVertices, kNumOfReachedVertices + 1.0);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Returns the integration of a vertex from the mean depth of the other vertices of its system of
+		/// kNumOfVertices vertices: 1 / RRA, where RRA = 2 (MD - 1) / (k - 2) / D_k. Zero if the system has fewer than
+		/// 4 vertices, and infinite if all the other vertices are adjacent.
+		/// </summary>
+		/// <param name="kMeanDepth"></param>
+		/// <param name="kNumOfVertices"></param>
+		/// <returns></returns>
+		static double Integration(const double kMeanDepth, const double kNumOfVertices)
+		{
+			if (kNumOfVertices < 4.0)
+			{
+				return 0.0;
+			}
+
+			const double kRelativeAsymmetry = 2.0 * (kMeanDepth - 1.0) / (kNumOfVertices - 2.0);
+			const double kDiamondValue = 2.0 * (kNumOfVertices * (std::log2((kNumOfVertices + 2.0) / 3.0) - 1.0) + 1.0) /
+				((kNumOfVertices - 1.0) * (kNumOfVertices - 2.0));
+			const double kRealRelativeAsymmetry = kRelativeAsymmetry / kDiamondValue;
+			return kRealRelativeAsymmetry <= 0.0 ? std::numeric_limits<double>::infinity() : 1.0 / kRealRelativeAsymmetry;
+		}
+
+	protected:
+		/// <summary>
+		/// The state of a search, sized once per worker and reset through the settled vertices.
+		/// The predecessors of each vertex are a linked list in predecessorIds / nextPredecessors.
+		/// </summary>
+		struct Scratch
+		{
+			Scratch(const int kNumOfVertices)
+				: distances(kNumOfVertices, std::numeric_limits<double>::max())
+				, numsOfPaths(kNumOfVertices, 0.0)
+				, dependencies(kNumOfVertices, 0.0)
+				, firstPredecessors(kNumOfVertices, -1)
+				, isSettled(kNumOfVertices, false)
+			{
+			}
+
+			void Reset()
+			{
+				for (const int kId : settledIds)
+				{
+					distances[kId] = std::numeric_limits<double>::max();
+					numsOfPaths[kId] = 0.0;
+					dependencies[kId] = 0.0;
+					firstPredecessors[kId] = -1;
+					isSettled[kId] = false;
+				}
+				settledIds.clear();
+				predecessorIds.clear();
+				nextPredecessors.clear();
+			}
+
+			void AddPredecessor(const int kId, const int kPredecessorId)
+			{
+				predecessorIds.push_back(kPredecessorId);
+				nextPredecessors.push_back(firstPredecessors[kId]);
+				firstPredecessors[kId] = (int)predecessorIds.size() - 1;
+			}
+
+			std::vector<double> distances;
+			std::vector<double> numsOfPaths;
+			std::vector<double> dependencies;
+			std::vector<int> firstPredecessors;
+			std::vector<int> predecessorIds;
+			std::vector<int> nextPredecessors;
+			std::vector<int> settledIds;
+			std::vector<bool> isSettled;
+		};
+
+		/// <summary>
+		/// Settles the vertices within the radius of a source by increasing distance, counting the shortest paths
+		/// to each one and recording their predecessors if kCountsPaths is true. With weights, a predecessor is only
+		/// recorded from a vertex settled before its successor, and the number of paths to a vertex is summed when it is
+		/// settled, so that edges of zero cost between vertices at the same distance are neither counted twice nor
+		/// turned into cycles. Weighted distances tie up to the tolerance of GraphIndex::IsShortestDistance, as in
+		/// GraphIndex::SearchDag.
+		/// </summary>
+		static void Search(
+			const GraphIndex& rkIndex,
+			const GraphIndex::EdgeWeights* kpEdgeWeights,
+			const int kSourceId,
+			const double kRadius,
+			const bool kCountsPaths,
+			Scratch& rScratch)
+		{
+			const double kLimit = kRadius < 0.0 ? std::numeric_limits<double>::max() : kRadius;
+			const std::vector<int>& rkOffsets = rkIndex.Offsets();
+			const std::vector<int>& rkTargets = rkIndex.Targets();
+			rScratch.distances[kSourceId] = 0.0;
+			rScratch.numsOfPaths[kSourceId] = 1.0;
+
+			if (kpEdgeWeights == nullptr)
+			{
+				// The settled vertices double as the queue.
+				rScratch.settledIds.push_back(kSourceId);
+				for (size_t i = 0; i < rScratch.settledIds.size(); ++i)
+				{
+					const int kId = rScratch.settledIds[i];
+					const double kDistance = rScratch.distances[kId] + 1.0;
+					if (kDistance > kLimit)
+					{
+						continue;
+					}
+					for (int slot = rkOffsets[kId]; slot < rkOffsets[kId + 1]; ++slot)
+					{
+						const int kNeighbourId = rkTargets[slot];
+						if (rScratch.distances[kNeighbourId] == std::numeric_limits<double>::max())
+						{
+							rScratch.distances[kNeighbourId] = kDistance;
+							rScratch.settledIds.push_back(kNeighbourId);
+						}
+						if (kCountsPaths && rScratch.distances[kNeighbourId] == kDistance)
+						{
+							rScratch.numsOfPaths[kNeighbourId] += rScratch.numsOfPaths[kId];
+							rScratch.AddPredecessor(kNeighbourId, kId);
+						}
+					}
+				}
+				return;
+			}
+
+			typedef std::pair<double, int> QueueItem;
+			std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+			queue.push(QueueItem(0.0, kSourceId));
+			while (!queue.empty())
+			{
+				const QueueItem kItem = queue.top();
+				queue.pop();
+				if (rScratch.isSettled[kItem.second] || kItem.first > rScratch.distances[kItem.second])
+				{
+					continue;
+				}
+				rScratch.isSettled[kItem.second] = true;
+				rScratch.settledIds.push_back(kItem.second);
+				if (kCountsPaths && kItem.second != kSourceId)
+				{
+					// All the predecessors are settled, so their numbers of paths are final.
+					for (int predecessor = rScratch.firstPredecessors[kItem.second]; predecessor >= 0; predecessor = rScratch.nextPredecessors[predecessor])
+					{
+						rScratch.numsOfPaths[kItem.second] += rScratch.numsOfPaths[rScratch.predecessorIds[predecessor]];
+					}
+				}
+				for (int slot = rkOffsets[kItem.second]; slot < rkOffsets[kItem.second + 1]; ++slot)
+				{
+					const int kNeighbourId = rkTargets[slot];
+					const double kDistance = kItem.first + kpEdgeWeights->values[slot];
+					if (rScratch.isSettled[kNeighbourId] || kDistance > kLimit)
+					{
+						continue;
+					}
+					if (GraphIndex::IsShortestDistance(kDistance, rScratch.distances[kNeighbourId]))
+					{
+						if (kCountsPaths)
+						{
+							rScratch.AddPredecessor(kNeighbourId, kItem.second);
+						}
+					}
+					else if (kDistance < rScratch.distances[kNeighbourId])
+					{
+						rScratch.distances[kNeighbourId] = kDistance;
+						rScratch.firstPredecessors[kNeighbourId] = -1;
+						queue.push(QueueItem(kDistance, kNeighbourId));
+						if (kCountsPaths)
+						{
+							rScratch.AddPredecessor(kNeighbourId, kItem.second);
+						}
+					}
+				}
+			}
+		}
+
+		/// <summary>
+		/// Brandes' backward pass: accumulates the dependencies of the source on the settled vertices, in decreasing
+		/// order of distance, and adds them to their betweenness.
+		/// </summary>
+		static void AccumulateDependencies(const int kSourceId, Scratch& rScratch, std::vector<double>& rBetweenness)
+		{
+			for (auto idIterator = rScratch.settledIds.rbegin(); idIterator != rScratch.settledIds.rend(); ++idIterator)
+			{
+				const int kId = *idIterator;
+				const double kCoefficient = (1.0 + rScratch.dependencies[kId]) / rScratch.numsOfPaths[kId];
+				for (int predecessor = rScratch.firstPredecessors[kId]; predecessor >= 0; predecessor = rScratch.nextPredecessors[predecessor])
+				{
+					const int kPredecessorId = rScratch.predecessorIds[predecessor];
+					rScratch.dependencies[kPredecessorId] += rScratch.numsOfPaths[kPredecessorId] * kCoefficient;
+				}
+				if (kId != kSourceId)
+				{
+					rBetweenness[kId] += rScratch.dependencies[kId];
+				}
+			}
+		}
+	};
+}
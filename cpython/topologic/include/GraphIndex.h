@@ -0,0 +1,640 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+
+#include <BRep_Tool.hxx>
+#include <TopExp.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_TShape.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <TopTools_MapIteratorOfMapOfShape.hxx>
+#include <TopTools_MapOfShape.hxx>
+#include <gp_Pnt.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// Immutable snapshot of the adjacency of a Graph in compressed sparse row form. The vertices are numbered densely,
+	/// in the order of the graph dictionary; the neighbours of vertex i are Targets()[Offsets()[i]] to
+	/// Targets()[Offsets()[i + 1] - 1]. The edges are indexed by the unordered pair of their endpoints' ids, and by slot
+	/// of Targets(). Apart from its cache of edge weights, which is guarded by a mutex, it is
+	/// immutable and can be shared by any number of threads.
+	/// </summary>
+	class GraphIndex
+	{
+	public:
+		typedef std::shared_ptr<GraphIndex> Ptr;
+
+		/// <summary>
+		/// The cost of each edge in Targets(), and the lowest ratio of a cost to the distance between the endpoints,
+		/// which scales the A* heuristic so that it never overestimates.
+		/// </summary>
+		struct EdgeWeights
+		{
+			typedef std::shared_ptr<const EdgeWeights> Ptr;
+
+			std::vector<double> values;
+			double minCostPerLength;
+		};
+
+		/// <summary>
+		/// The vertices reached by a search from a source, in the order they were settled (so by increasing distance),
+		/// with their distances and predecessors. The predecessor of the source is -1.
+		/// </summary>
+		struct ShortestPathTree
+		{
+			int sourceId;
+			std::vector<int> vertexIds;
+			std::vector<double> distances;
+			std::vector<int> predecessorIds;
+		};
+
+		/// <summary>
+		/// The vertices reached by a search from a source in the order they were settled, with their distances and the
+		/// lists of all their predecessors on a shortest path. The predecessors are given by their positions in vertexIds,
+		/// which are always lower than that of the vertex, so the lists form a directed acyclic graph rooted at the source.
+		/// The predecessors of the vertex at position i are predecessorPositions[predecessorOffsets[i]] to
+		/// predecessorPositions[predecessorOffsets[i + 1] - 1].
+		/// </summary>
+		struct ShortestPathDag
+		{
+			int sourceId;
+			std::vector<int> vertexIds;
+			std::vector<double> distances;
+			std::vector<int> predecessorOffsets;
+			std::vector<int> predecessorPositions;
+		};
+
+	public:
+		/// <summary>
+		/// </summary>
+		/// <param name="rkGraphDictionary"></param>
+		/// <param name="rkOcctEdges"></param>
+		/// <param name="rkFindCoincidentVertex">Returns the vertex of the graph coincident with an endpoint of an edge
+		/// that is not itself one of its vertices, or a null vertex</param>
+		GraphIndex(
+			const std::map<TopoDS_Vertex, TopTools_MapOfShape, OcctShapeComparator>& rkGraphDictionary,
+			const TopTools_MapOfShape& rkOcctEdges,
+			const std::function<TopoDS_Vertex(const TopoDS_Vertex&)>& rkFindCoincidentVertex)
+			: m_numOfEdges(rkOcctEdges.Extent())
+		{
+			m_occtVertices.reserve(rkGraphDictionary.size());
+			m_ids.reserve(rkGraphDictionary.size());
+			for (const auto& rkDictionaryPair : rkGraphDictionary)
+			{
+				m_ids.insert(std::make_pair(rkDictionaryPair.first.TShape().get(), (int)m_occtVertices.size()));
+				m_occtVertices.push_back(rkDictionaryPair.first);
+				m_occtPoints.push_back(BRep_Tool::Pnt(rkDictionaryPair.first));
+			}
+
+			m_offsets.reserve(m_occtVertices.size() + 1);
+			m_offsets.push_back(0);
+			for (const auto& rkDictionaryPair : rkGraphDictionary)
+			{
+				for (TopTools_MapIteratorOfMapOfShape occtAdjacentIterator(rkDictionaryPair.second); occtAdjacentIterator.More(); occtAdjacentIterator.Next())
+				{
+					const int kTargetId = Id(TopoDS::Vertex(occtAdjacentIterator.Key()));
+					if (kTargetId >= 0)
+					{
+						m_targets.push_back(kTargetId);
+					}
+				}
+				m_offsets.push_back((int)m_targets.size());
+			}
+
+			for (TopTools_MapIteratorOfMapOfShape occtEdgeIterator(rkOcctEdges); occtEdgeIterator.More(); occtEdgeIterator.Next())
+			{
+				const TopoDS_Edge& rkOcctEdge = TopoDS::Edge(occtEdgeIterator.Key());
+				TopoDS_Vertex occtVertex1, occtVertex2;
+				TopExp::Vertices(rkOcctEdge, occtVertex1, occtVertex2);
+				const int kId1 = FindEndpointId(occtVertex1, rkFindCoincidentVertex);
+				const int kId2 = FindEndpointId(occtVertex2, rkFindCoincidentVertex);
+				if (kId1 >= 0 && kId2 >= 0)
+				{
+					m_edgeIndices.insert(std::make_pair(PairKey(kId1, kId2), (int)m_occtEdges.size()));
+					m_occtEdges.push_back(rkOcctEdge);
+				}
+			}
+
+			m_slotEdges.reserve(m_targets.size());
+			for (int i = 0; i < NumOfVertices(); ++i)
+			{
+				for (const int* kpNeighbour = NeighboursBegin(i); kpNeighbour != NeighboursEnd(i); ++kpNeighbour)
+				{
+					m_slotEdges.push_back(EdgeIndex(i, *kpNeighbour));
+				}
+			}
+		}
+
+		int NumOfVertices() const
+		{
+			return (int)m_occtVertices.size();
+		}
+
+		/// <summary>
+		/// The number of edges of the graph when the index was built.
+		/// </summary>
+		/// <returns></returns>
+		int NumOfEdges() const
+		{
+			return m_numOfEdges;
+		}
+
+		/// <summary>
+		/// Returns the id of a vertex of the graph, or -1 if the vertex is not one of its vertices.
+		/// </summary>
+		/// <param name="rkOcctVertex"></param>
+		/// <returns></returns>
+		int Id(const TopoDS_Vertex& rkOcctVertex) const
+		{
+			auto idIterator = m_ids.find(rkOcctVertex.TShape().get());
+			return idIterator == m_ids.end() ? -1 : idIterator->second;
+		}
+
+		const TopoDS_Vertex& OcctVertex(const int kId) const
+		{
+			return m_occtVertices[kId];
+		}
+
+		const gp_Pnt& OcctPoint(const int kId) const
+		{
+			return m_occtPoints[kId];
+		}
+
+		/// <summary>
+		/// Throws if an id is not that of a vertex of the index. The accessors used in the searches, such as Degree() and
+		/// NeighboursBegin(), do not check their ids.
+		/// </summary>
+		/// <param name="kId"></param>
+		void CheckId(const int kId) const
+		{
+			if (kId < 0 || kId >= NumOfVertices())
+			{
+				throw std::runtime_error("The vertex id is out of range.");
+			}
+		}
+
+		int Degree(const int kId) const
+		{
+			return m_offsets[kId + 1] - m_offsets[kId];
+		}
+
+		const int* NeighboursBegin(const int kId) const
+		{
+			return m_targets.data() + m_offsets[kId];
+		}
+
+		const int* NeighboursEnd(const int kId) const
+		{
+			return m_targets.data() + m_offsets[kId + 1];
+		}
+
+		void AdjacentIds(const int kId, std::vector<int>& rAdjacentIds) const
+		{
+			CheckId(kId);
+			rAdjacentIds.assign(NeighboursBegin(kId), NeighboursEnd(kId));
+		}
+
+		/// <summary>
+		/// Returns the index of the edge between two vertices, or -1 if they are not connected by an edge, in constant
+		/// expected time; OcctEdge() returns the edge.
+		/// </summary>
+		/// <param name="kId1"></param>
+		/// <param name="kId2"></param>
+		/// <returns></returns>
+		int EdgeIndex(const int kId1, const int kId2) const
+		{
+			auto edgeIndexIterator = m_edgeIndices.find(PairKey(kId1, kId2));
+			return edgeIndexIterator == m_edgeIndices.end() ? -1 : edgeIndexIterator->second;
+		}
+
+		bool ContainsEdge(const int kId1, const int kId2) const
+		{
+			return EdgeIndex(kId1, kId2) >= 0;
+		}
+
+		/// <summary>
+		/// Lists the indices of the edges incident to a vertex, in the order of its neighbours.
+		/// </summary>
+		/// <param name="kId"></param>
+		/// <param name="rEdgeIndices"></param>
+		void IncidentEdgeIndices(const int kId, std::vector<int>& rEdgeIndices) const
+		{
+			CheckId(kId);
+			for (int slot = m_offsets[kId]; slot < m_offsets[kId + 1]; ++slot)
+			{
+				if (m_slotEdges[slot] >= 0)
+				{
+					rEdgeIndices.push_back(m_slotEdges[slot]);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Returns the index of the edge of a slot of Targets(), or -1 if the adjacency has no matching edge.
+		/// </summary>
+		/// <param name="kSlot"></param>
+		/// <returns></returns>
+		int SlotEdgeIndex(const int kSlot) const
+		{
+			return m_slotEdges[kSlot];
+		}
+
+		/// <summary>
+		/// Returns the slot of Targets() which holds a neighbour of a vertex, or -1 if they are not adjacent.
+		/// </summary>
+		/// <param name="kId"></param>
+		/// <param name="kNeighbourId"></param>
+		/// <returns></returns>
+		int Slot(const int kId, const int kNeighbourId) const
+		{
+			for (int slot = m_offsets[kId]; slot < m_offsets[kId + 1]; ++slot)
+			{
+				if (m_targets[slot] == kNeighbourId)
+				{
+					return slot;
+				}
+			}
+			return -1;
+		}
+
+		const TopoDS_Edge& OcctEdge(const int kEdgeIndex) const
+		{
+			return m_occtEdges[kEdgeIndex];
+		}
+
+		const std::vector<int>& Offsets() const
+		{
+			return m_offsets;
+		}
+
+		const std::vector<int>& Targets() const
+		{
+			return m_targets;
+		}
+
+		/// <summary>
+		/// Returns true if a distance equals a shortest distance up to a relative tolerance of 1e-9, so that the sums of
+		/// the costs of different paths of equal length compare equal.
+		/// </summary>
+		/// <param name="kDistance"></param>
+		/// <param name="kShortestDistance"></param>
+		/// <returns></returns>
+		static bool IsShortestDistance(const double kDistance, const double kShortestDistance)
+		{
+			return std::abs(kDistance - kShortestDistance) <= 1e-9 * std::max(1.0, std::abs(kShortestDistance));
+		}
+
+		/// <summary>
+		/// Returns the number of edges on a shortest path between two vertices, or -1 if they are not connected.
+		/// </summary>
+		/// <param name="kStartId"></param>
+		/// <param name="kEndId"></param>
+		/// <returns></returns>
+		int TopologicalDistance(const int kStartId, const int kEndId) const
+		{
+			CheckId(kStartId);
+			CheckId(kEndId);
+			if (kStartId == kEndId)
+			{
+				return 0;
+			}
+
+			std::vector<int> distances(m_occtVertices.size(), -1);
+			std::vector<int> frontier(1, kStartId);
+			std::vector<int> nextFrontier;
+			distances[kStartId] = 0;
+			for (int distance = 1; !frontier.empty(); ++distance)
+			{
+				nextFrontier.clear();
+				for (const int kId : frontier)
+				{
+					for (const int* kpNeighbour = NeighboursBegin(kId); kpNeighbour != NeighboursEnd(kId); ++kpNeighbour)
+					{
+						if (distances[*kpNeighbour] >= 0)
+						{
+							continue;
+						}
+						if (*kpNeighbour == kEndId)
+						{
+							return distance;
+						}
+						distances[*kpNeighbour] = distance;
+						nextFrontier.push_back(*kpNeighbour);
+					}
+				}
+				frontier.swap(nextFrontier);
+			}
+			return -1;
+		}
+
+		/// <summary>
+		/// Searches the shortest paths from a source: breadth-first, counting the edges, if there are no edge weights,
+		/// or with Dijkstra's algorithm otherwise. Thread-safe; the scratch arrays are kept per thread.
+		/// </summary>
+		/// <param name="kSourceId"></param>
+		/// <param name="kpEdgeWeights">May be null</param>
+		/// <param name="kMaxDistance">The vertices further than this are not reached. Negative for no limit.</param>
+		/// <param name="rTree"></param>
+		void Search(const int kSourceId, const EdgeWeights* kpEdgeWeights, const double kMaxDistance, ShortestPathTree& rTree) const
+		{
+			static thread_local std::vector<double> distances;
+			static thread_local std::vector<int> predecessorIds;
+			if (distances.size() != m_occtVertices.size())
+			{
+				distances.assign(m_occtVertices.size(), std::numeric_limits<double>::max());
+				predecessorIds.assign(m_occtVertices.size(), -1);
+			}
+
+			rTree.sourceId = kSourceId;
+			rTree.vertexIds.clear();
+			rTree.distances.clear();
+			rTree.predecessorIds.clear();
+			const double kLimit = kMaxDistance < 0.0 ? std::numeric_limits<double>::max() : kMaxDistance;
+			distances[kSourceId] = 0.0;
+			predecessorIds[kSourceId] = -1;
+
+			if (kpEdgeWeights == nullptr)
+			{
+				// The settled vertices double as the queue.
+				rTree.vertexIds.push_back(kSourceId);
+				for (size_t i = 0; i < rTree.vertexIds.size(); ++i)
+				{
+					const int kId = rTree.vertexIds[i];
+					const double kDistance = distances[kId] + 1.0;
+					if (kDistance > kLimit)
+					{
+						continue;
+					}
+					for (const int* kpNeighbour = NeighboursBegin(kId); kpNeighbour != NeighboursEnd(kId); ++kpNeighbour)
+					{
+						if (distances[*kpNeighbour] == std::numeric_limits<double>::max())
+						{
+							distances[*kpNeighbour] = kDistance;
+							predecessorIds[*kpNeighbour] = kId;
+							rTree.vertexIds.push_back(*kpNeighbour);
+						}
+					}
+				}
+			}
+			else
+			{
+				typedef std::pair<double, int> QueueItem;
+				std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+				queue.push(QueueItem(0.0, kSourceId));
+				while (!queue.empty())
+				{
+					const QueueItem kItem = queue.top();
+					queue.pop();
+					if (kItem.first > distances[kItem.second])
+					{
+						continue;
+					}
+					rTree.vertexIds.push_back(kItem.second);
+					for (int slot = m_offsets[kItem.second]; slot < m_offsets[kItem.second + 1]; ++slot)
+					{
+						const int kNeighbourId = m_targets[slot];
+						const double kDistance = kItem.first + kpEdgeWeights->values[slot];
+						if (kDistance <= kLimit && kDistance < distances[kNeighbourId])
+						{
+							distances[kNeighbourId] = kDistance;
+							predecessorIds[kNeighbourId] = kItem.second;
+							queue.push(QueueItem(kDistance, kNeighbourId));
+						}
+					}
+				}
+			}
+
+			rTree.distances.reserve(rTree.vertexIds.size());
+			rTree.predecessorIds.reserve(rTree.vertexIds.size());
+			for (const int kId : rTree.vertexIds)
+			{
+				rTree.distances.push_back(distances[kId]);
+				rTree.predecessorIds.push_back(predecessorIds[kId]);
+				distances[kId] = std::numeric_limits<double>::max();
+				predecessorIds[kId] = -1;
+			}
+		}
+
+		/// <summary>
+		/// Searches the shortest paths from a source with Dijkstra's algorithm, keeping every predecessor through which a
+		/// vertex is reached at its shortest distance, up to a relative tolerance of 1e-9. Once the target is settled, the
+		/// search only settles the other vertices at the same distance, which can precede it through edges of zero cost,
+		/// and the target is then moved to the end of the graph. Thread-safe; the scratch arrays are kept per thread.
+		/// </summary>
+		/// <param name="kSourceId"></param>
+		/// <param name="kTargetId">-1 to reach all the vertices</param>
+		/// <param name="kpEdgeWeights">May be null to count the edges</param>
+		/// <param name="rDag"></param>
+		void SearchDag(const int kSourceId, const int kTargetId, const EdgeWeights* kpEdgeWeights, ShortestPathDag& rDag) const
+		{
+			static thread_local std::vector<double> distances;
+			static thread_local std::vector<int> positions;
+			if (distances.size() != m_occtVertices.size())
+			{
+				distances.assign(m_occtVertices.size(), std::numeric_limits<double>::max());
+				positions.assign(m_occtVertices.size(), -1);
+			}
+
+			rDag.sourceId = kSourceId;
+			rDag.vertexIds.clear();
+			rDag.distances.clear();
+			rDag.predecessorOffsets.clear();
+			rDag.predecessorPositions.clear();
+
+			// The vertices given a distance, to reset the scratch arrays.
+			std::vector<int> reachedIds(1, kSourceId);
+			typedef std::pair<double, int> QueueItem;
+			std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+			distances[kSourceId] = 0.0;
+			queue.push(QueueItem(0.0, kSourceId));
+			int targetPosition = -1;
+			while (!queue.empty())
+			{
+				const QueueItem kItem = queue.top();
+				queue.pop();
+				if (positions[kItem.second] >= 0)
+				{
+					continue;
+				}
+				if (targetPosition >= 0 && kItem.first > distances[kTargetId] && !IsShortestDistance(kItem.first, distances[kTargetId]))
+				{
+					break;
+				}
+				positions[kItem.second] = (int)rDag.vertexIds.size();
+				rDag.vertexIds.push_back(kItem.second);
+				if (kItem.second == kTargetId)
+				{
+					// The paths through the target back to it are not simple, so it is not expanded.
+					targetPosition = positions[kItem.second];
+					continue;
+				}
+				for (int slot = m_offsets[kItem.second]; slot < m_offsets[kItem.second + 1]; ++slot)
+				{
+					const int kNeighbourId = m_targets[slot];
+					const double kDistance = kItem.first + (kpEdgeWeights == nullptr ? 1.0 : kpEdgeWeights->values[slot]);
+					if (kDistance < distances[kNeighbourId])
+					{
+						if (distances[kNeighbourId] == std::numeric_limits<double>::max())
+						{
+							reachedIds.push_back(kNeighbourId);
+						}
+						distances[kNeighbourId] = kDistance;
+						queue.push(QueueItem(kDistance, kNeighbourId));
+					}
+				}
+			}
+
+			if (targetPosition >= 0)
+			{
+				std::rotate(rDag.vertexIds.begin() + targetPosition, rDag.vertexIds.begin() + targetPosition + 1, rDag.vertexIds.end());
+				for (int position = targetPosition; position < (int)rDag.vertexIds.size(); ++position)
+				{
+					positions[rDag.vertexIds[position]] = position;
+				}
+			}
+
+			// A settled vertex is a predecessor of a vertex settled after it if the edge between them is tight. Requiring
+			// the order keeps the graph acyclic even with edges of zero cost.
+			const int kNumOfSettledVertices = (int)rDag.vertexIds.size();
+			rDag.distances.reserve(kNumOfSettledVertices);
+			rDag.predecessorOffsets.assign(kNumOfSettledVertices + 1, 0);
+			for (int pass = 0; pass < 2; ++pass)
+			{
+				for (int position = 0; position < kNumOfSettledVertices; ++position)
+				{
+					const int kId = rDag.vertexIds[position];
+					for (int slot = m_offsets[kId]; slot < m_offsets[kId + 1]; ++slot)
+					{
+						const int kNeighbourPosition = positions[m_targets[slot]];
+						if (kNeighbourPosition <= position)
+						{
+							continue;
+						}
+						const double kDistance = distances[kId] + (kpEdgeWeights == nullptr ? 1.0 : kpEdgeWeights->values[slot]);
+						const double kNeighbourDistance = distances[m_targets[slot]];
+						if (!IsShortestDistance(kDistance, kNeighbourDistance))
+						{
+							continue;
+						}
+						if (pass == 0)
+						{
+							++rDag.predecessorOffsets[kNeighbourPosition + 1];
+						}
+						else
+						{
+							rDag.predecessorPositions[rDag.predecessorOffsets[kNeighbourPosition]++] = position;
+						}
+					}
+				}
+
+				if (pass == 0)
+				{
+					for (int position = 0; position < kNumOfSettledVertices; ++position)
+					{
+						rDag.predecessorOffsets[position + 1] += rDag.predecessorOffsets[position];
+					}
+					rDag.predecessorPositions.resize(rDag.predecessorOffsets.back());
+				}
+				else
+				{
+					// The fill has advanced each offset to the next one; shift them back.
+					for (int position = kNumOfSettledVertices; position > 0; --position)
+					{
+						rDag.predecessorOffsets[position] = rDag.predecessorOffsets[position - 1];
+					}
+					rDag.predecessorOffsets[0] = 0;
+				}
+			}
+
+			for (const int kId : rDag.vertexIds)
+			{
+				rDag.distances.push_back(distances[kId]);
+			}
+			for (const int kId : reachedIds)
+			{
+				distances[kId] = std::numeric_limits<double>::max();
+				positions[kId] = -1;
+			}
+		}
+
+		/// <summary>
+		/// Returns the edge weights cached under a key, or null.
+		/// </summary>
+		/// <param name="rkKey"></param>
+		/// <returns></returns>
+		EdgeWeights::Ptr FindEdgeWeights(const std::string& rkKey) const
+		{
+			std::lock_guard<std::mutex> lock(m_edgeWeightsMutex);
+			auto edgeWeightsIterator = m_edgeWeights.find(rkKey);
+			return edgeWeightsIterator == m_edgeWeights.end() ? nullptr : edgeWeightsIterator->second;
+		}
+
+		void AddEdgeWeights(const std::string& rkKey, const EdgeWeights::Ptr& kpEdgeWeights) const
+		{
+			std::lock_guard<std::mutex> lock(m_edgeWeightsMutex);
+			m_edgeWeights[rkKey] = kpEdgeWeights;
+		}
+
+	protected:
+		static uint64_t PairKey(const int kId1, const int kId2)
+		{
+			return ((uint64_t)(uint32_t)std::min(kId1, kId2) << 32) | (uint64_t)(uint32_t)std::max(kId1, kId2);
+		}
+
+		int FindEndpointId(const TopoDS_Vertex& rkOcctVertex, const std::function<TopoDS_Vertex(const TopoDS_Vertex&)>& rkFindCoincidentVertex) const
+		{
+			const int kId = Id(rkOcctVertex);
+			if (kId >= 0 || rkOcctVertex.IsNull())
+			{
+				return kId;
+			}
+
+			const TopoDS_Vertex kOcctCoincidentVertex = rkFindCoincidentVertex(rkOcctVertex);
+			return kOcctCoincidentVertex.IsNull() ? -1 : Id(kOcctCoincidentVertex);
+		}
+
+		int m_numOfEdges;
+		std::vector<TopoDS_Vertex> m_occtVertices;
+		std::unordered_map<const TopoDS_TShape*, int> m_ids;
+		std::vector<int> m_offsets;
+		std::vector<int> m_targets;
+		std::vector<gp_Pnt> m_occtPoints;
+		std::vector<TopoDS_Edge> m_occtEdges;
+		std::unordered_map<uint64_t, int> m_edgeIndices;
+		std::vector<int> m_slotEdges;
+		mutable std::mutex m_edgeWeightsMutex;
+		mutable std::map<std::string, EdgeWeights::Ptr> m_edgeWeights;
+	};
+}
@@ -0,0 +1,115 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+
+#include <NCollection_IncAllocator.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <TopTools_MapOfShape.hxx>
+
+#include <memory>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// Per-thread OCCT containers reused by the navigation methods instead of being rebuilt on every call.
+	/// The containers share an NCollection_IncAllocator which is reset, not released, between calls, so that
+	/// their nodes and buckets are recycled. The containers are leased for the duration of a call; a nested
+	/// lease on the same thread gets its own temporary containers. Only Topology::PooledUpwardNavigation and
+	/// PooledDownwardNavigation use them: the library's own navigation, including Edges(), Faces(), Cells() and so on,
+	/// keeps its per-call containers.
+	/// </summary>
+	class NavigationScratch
+	{
+	public:
+		class Lease
+		{
+		public:
+			Lease()
+			{
+				NavigationScratch& rThreadScratch = GetThreadInstance();
+				if (rThreadScratch.m_isInUse)
+				{
+					m_pTemporaryScratch.reset(new NavigationScratch());
+					m_pScratch = m_pTemporaryScratch.get();
+				}
+				else
+				{
+					m_pScratch = &rThreadScratch;
+				}
+				m_pScratch->m_isInUse = true;
+			}
+
+			~Lease()
+			{
+				m_pScratch->Reset();
+			}
+
+			Lease(const Lease&) = delete;
+			Lease& operator=(const Lease&) = delete;
+
+			NavigationScratch* operator->() const
+			{
+				return m_pScratch;
+			}
+
+		protected:
+			NavigationScratch* m_pScratch;
+			std::unique_ptr<NavigationScratch> m_pTemporaryScratch;
+		};
+
+		TopTools_MapOfShape& OcctShapes()
+		{
+			return m_occtShapes;
+		}
+
+		TopTools_IndexedDataMapOfShapeListOfShape& OcctShapeMap()
+		{
+			return m_occtShapeMap;
+		}
+
+	protected:
+		NavigationScratch()
+			: m_pOcctAllocator(new NCollection_IncAllocator())
+			, m_occtShapes(1, m_pOcctAllocator)
+			, m_occtShapeMap(1, m_pOcctAllocator)
+			, m_isInUse(false)
+		{
+		}
+
+		static NavigationScratch& GetThreadInstance()
+		{
+			static thread_local NavigationScratch instance;
+			return instance;
+		}
+
+		void Reset()
+		{
+			// Keep the buckets; the nodes go back to the allocator, which keeps its blocks for the next call.
+			m_occtShapes.Clear(Standard_False);
+			m_occtShapeMap.Clear(Standard_False);
+			m_pOcctAllocator->Reset(Standard_False);
+			m_isInUse = false;
+		}
+
+		Handle(NCollection_IncAllocator) m_pOcctAllocator;
+		TopTools_MapOfShape m_occtShapes;
+		TopTools_IndexedDataMapOfShapeListOfShape m_occtShapeMap;
+		bool m_isInUse;
+	};
+}
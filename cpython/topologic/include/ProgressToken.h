@@ -0,0 +1,273 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+
+#include <Standard_Version.hxx>
+#if OCC_VERSION_HEX >= 0x070500
+#include <Message_ProgressIndicator.hxx>
+#include <Message_ProgressRange.hxx>
+#include <Message_ProgressScope.hxx>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// Progress and cancellation token shared between the caller and a long operation (booleans, sewing, triangulation,
+	/// graph algorithms). The operation stops once the token is cancelled or its time limit is reached. From OCCT 7.5,
+	/// OCCT algorithms are driven through the Message_ProgressRange returned by Start(); with earlier versions they run
+	/// to completion, report no progress, and the token is only polled before and after them. Other loops poll
+	/// IsCancelled().
+	/// </summary>
+	class ProgressToken
+	{
+	public:
+		typedef std::shared_ptr<ProgressToken> Ptr;
+		typedef std::function<void(double)> Callback;
+
+#if OCC_VERSION_HEX >= 0x070500
+		typedef Message_ProgressRange Range;
+		typedef Message_ProgressScope Scope;
+#else
+		/// <summary>
+		/// Stand-in for Message_ProgressRange, which OCCT only has from 7.5.
+		/// </summary>
+		class Range
+		{
+		};
+
+		/// <summary>
+		/// Stand-in for Message_ProgressScope, which OCCT only has from 7.5.
+		/// </summary>
+		class Scope
+		{
+		public:
+			Scope(const Range& /*rkRange*/, const char* /*kpName*/, const double /*kMax*/)
+			{
+			}
+
+			Range Next()
+			{
+				return Range();
+			}
+		};
+#endif
+
+	public:
+		/// <summary>
+		/// </summary>
+		/// <param name="kTimeLimitInSeconds">0 for no time limit</param>
+		ProgressToken(const double kTimeLimitInSeconds = 0.0)
+			: m_isCancelled(false)
+			, m_hasTimeLimit(false)
+			, m_progress(0.0)
+		{
+#if OCC_VERSION_HEX >= 0x070500
+			m_pOcctIndicator = new Indicator(this);
+#endif
+			SetTimeLimit(kTimeLimitInSeconds);
+		}
+
+		ProgressToken(const ProgressToken&) = delete;
+		ProgressToken& operator=(const ProgressToken&) = delete;
+
+		/// <summary>
+		/// Asks the operation to stop. Can be called from any thread.
+		/// </summary>
+		void Cancel()
+		{
+			m_isCancelled = true;
+		}
+
+		/// <summary>
+		/// Sets the time limit, counted from now.
+		/// </summary>
+		/// <param name="kTimeLimitInSeconds">0 for no time limit</param>
+		void SetTimeLimit(const double kTimeLimitInSeconds)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_hasTimeLimit = kTimeLimitInSeconds > 0.0;
+			m_deadline = std::chrono::steady_clock::now() +
+				std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(kTimeLimitInSeconds));
+		}
+
+		/// <summary>
+		/// Sets a function called with the progress, between 0 and 1, of the OCCT algorithms run with this token.
+		/// It is only called on the thread that started the operation, never on the worker threads of a parallel
+		/// algorithm; the progress made on those is reported at the next update on the starting thread, and can be
+		/// read at any time with Progress(). Not called before OCCT 7.5.
+		/// </summary>
+		/// <param name="rkCallback"></param>
+		void SetCallback(const Callback& rkCallback)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_callback = rkCallback;
+		}
+
+		bool IsCancelled()
+		{
+			if (m_isCancelled)
+			{
+				return true;
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_hasTimeLimit && std::chrono::steady_clock::now() >= m_deadline)
+			{
+				m_isCancelled = true;
+			}
+			return m_isCancelled;
+		}
+
+		/// <summary>
+		/// The last progress reported by an OCCT algorithm, between 0 and 1.
+		/// </summary>
+		/// <returns></returns>
+		double Progress() const
+		{
+			return m_progress;
+		}
+
+		/// <summary>
+		/// Starts reporting a new operation and returns the range to pass to it.
+		/// </summary>
+		/// <returns></returns>
+		Range Start()
+		{
+			m_progress = 0.0;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_startingThreadId = std::this_thread::get_id();
+			}
+#if OCC_VERSION_HEX >= 0x070500
+			return m_pOcctIndicator->Start();
+#else
+			return Range();
+#endif
+		}
+
+		/// <summary>
+		/// Throws if the token has been cancelled.
+		/// </summary>
+		/// <param name="kpProgressToken">May be null</param>
+		static void ThrowIfCancelled(const ProgressToken::Ptr& kpProgressToken)
+		{
+			if (kpProgressToken != nullptr && kpProgressToken->IsCancelled())
+			{
+				throw std::runtime_error("The operation was cancelled.");
+			}
+		}
+
+		/// <summary>
+		/// Returns the range of a token, or an empty range if there is none.
+		/// </summary>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns></returns>
+		static Range Start(const ProgressToken::Ptr& kpProgressToken)
+		{
+			return kpProgressToken == nullptr ? Range() : kpProgressToken->Start();
+		}
+
+		/// <summary>
+		/// Runs the Perform() of an OCCT algorithm with a range, or without one before OCCT 7.5.
+		/// </summary>
+		/// <param name="rOcctAlgorithm"></param>
+		/// <param name="rkRange"></param>
+		template <class OcctAlgorithm>
+		static void Perform(OcctAlgorithm& rOcctAlgorithm, const Range& rkRange)
+		{
+#if OCC_VERSION_HEX >= 0x070500
+			rOcctAlgorithm.Perform(rkRange);
+#else
+			(void)rkRange;
+			rOcctAlgorithm.Perform();
+#endif
+		}
+
+		/// <summary>
+		/// Runs the Build() of an OCCT algorithm with a range, or without one before OCCT 7.5.
+		/// </summary>
+		/// <param name="rOcctAlgorithm"></param>
+		/// <param name="rkRange"></param>
+		template <class OcctAlgorithm>
+		static void Build(OcctAlgorithm& rOcctAlgorithm, const Range& rkRange)
+		{
+#if OCC_VERSION_HEX >= 0x070500
+			rOcctAlgorithm.Build(rkRange);
+#else
+			(void)rkRange;
+			rOcctAlgorithm.Build();
+#endif
+		}
+
+	protected:
+#if OCC_VERSION_HEX >= 0x070500
+		class Indicator : public Message_ProgressIndicator
+		{
+		public:
+			Indicator(ProgressToken* pProgressToken)
+				: m_pProgressToken(pProgressToken)
+			{
+			}
+
+			virtual Standard_Boolean UserBreak() override
+			{
+				return m_pProgressToken->IsCancelled();
+			}
+
+			virtual void Show(const Message_ProgressScope& /*rkOcctScope*/, const Standard_Boolean /*kIsForced*/) override
+			{
+				m_pProgressToken->m_progress = GetPosition();
+				Callback callback;
+				{
+					std::lock_guard<std::mutex> lock(m_pProgressToken->m_mutex);
+					if (std::this_thread::get_id() != m_pProgressToken->m_startingThreadId)
+					{
+						return;
+					}
+					callback = m_pProgressToken->m_callback;
+				}
+				if (callback)
+				{
+					callback(GetPosition());
+				}
+			}
+
+		protected:
+			ProgressToken* m_pProgressToken;
+		};
+
+		Handle(Indicator) m_pOcctIndicator;
+#endif
+		std::mutex m_mutex;
+		std::atomic<bool> m_isCancelled;
+		bool m_hasTimeLimit;
+		std::chrono::steady_clock::time_point m_deadline;
+		std::atomic<double> m_progress;
+		Callback m_callback;
+		std::thread::id m_startingThreadId;
+	};
+}
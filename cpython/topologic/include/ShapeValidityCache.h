@@ -0,0 +1,218 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+
+#include <BRepCheck_Analyzer.hxx>
+#include <BRep_Tool.hxx>
+#include <NCollection_DataMap.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopTools_ShapeMapHasher.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Trsf.hxx>
+
+#include <cstdint>
+#include <mutex>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// Cache of the validity of shapes, keyed by the TShape of the checked shape only, so that the shapes which BRepCheck
+	/// finds valid are not healed again. Each entry records an edit stamp of the shape: a hash of its sub-shapes with
+	/// their locations, orientations, geometry handles and tolerances. An entry is trusted only while the stamp is
+	/// unchanged, which also catches OCCT's in-place edits (e.g. enlarged tolerances). No flag is set on the shapes, so
+	/// shared sub-shapes are left untouched. The cache holds on to the shapes it has seen and is emptied once it reaches
+	/// MAX_NUM_OF_ENTRIES.
+	/// </summary>
+	class ShapeValidityCache
+	{
+	public:
+		static ShapeValidityCache& GetInstance()
+		{
+			static ShapeValidityCache instance;
+			return instance;
+		}
+
+		/// <summary>
+		/// Returns whether a shape is valid, running BRepCheck_Analyzer only if the shape has not been checked yet or
+		/// has been edited since.
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		/// <returns></returns>
+		bool IsValid(const TopoDS_Shape& rkOcctShape)
+		{
+			if (rkOcctShape.IsNull())
+			{
+				return false;
+			}
+
+			const TopoDS_Shape kOcctUnlocatedShape = rkOcctShape.Located(TopLoc_Location());
+			const uint64_t kEditStamp = EditStamp(kOcctUnlocatedShape);
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				const Entry* kpEntry = m_validities.Seek(kOcctUnlocatedShape);
+				if (kpEntry != nullptr && kpEntry->editStamp == kEditStamp)
+				{
+					return kpEntry->isValid;
+				}
+			}
+
+			bool isValid = false;
+			try
+			{
+				BRepCheck_Analyzer occtAnalyzer(kOcctUnlocatedShape);
+				isValid = occtAnalyzer.IsValid() == Standard_True;
+			}
+			catch (Standard_Failure&)
+			{
+				isValid = false;
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_validities.Extent() >= MAX_NUM_OF_ENTRIES)
+			{
+				m_validities.Clear();
+			}
+			Entry entry;
+			entry.isValid = isValid;
+			entry.editStamp = kEditStamp;
+			m_validities.Bind(kOcctUnlocatedShape, entry);
+			return isValid;
+		}
+
+		/// <summary>
+		/// Forgets the validity of a shape, e.g. after modifying a curve or a surface object in place, which the edit stamp
+		/// does not see.
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		void Invalidate(const TopoDS_Shape& rkOcctShape)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_validities.UnBind(rkOcctShape.Located(TopLoc_Location()));
+		}
+
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_validities.Clear();
+		}
+
+	protected:
+		static const int MAX_NUM_OF_ENTRIES = 65536;
+
+		struct Entry
+		{
+			bool isValid;
+			uint64_t editStamp;
+		};
+
+		ShapeValidityCache()
+		{
+		}
+
+		static void AddToStamp(const void* kpData, const size_t kSize, uint64_t& rStamp)
+		{
+			const unsigned char* kpBytes = static_cast<const unsigned char*>(kpData);
+			for (size_t i = 0; i < kSize; ++i)
+			{
+				rStamp ^= kpBytes[i];
+				rStamp *= 1099511628211ULL;
+			}
+		}
+
+		static void AddToStamp(const double kValue, uint64_t& rStamp)
+		{
+			AddToStamp(&kValue, sizeof(kValue), rStamp);
+		}
+
+		static void AddToStamp(const void* kpObject, uint64_t& rStamp)
+		{
+			AddToStamp(&kpObject, sizeof(kpObject), rStamp);
+		}
+
+		/// <summary>
+		/// Hashes the sub-shapes of a shape in the order of TopExp::MapShapes, with the geometry handles and tolerances
+		/// that OCCT replaces or enlarges in place.
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		/// <returns></returns>
+		static uint64_t EditStamp(const TopoDS_Shape& rkOcctShape)
+		{
+			uint64_t stamp = 14695981039346656037ULL;
+			TopTools_IndexedMapOfShape occtSubshapes;
+			TopExp::MapShapes(rkOcctShape, occtSubshapes);
+			for (int i = 1; i <= occtSubshapes.Extent(); ++i)
+			{
+				const TopoDS_Shape& rkOcctSubshape = occtSubshapes(i);
+				const int kOrientation = (int)rkOcctSubshape.Orientation();
+				AddToStamp(rkOcctSubshape.TShape().get(), stamp);
+				AddToStamp(&kOrientation, sizeof(kOrientation), stamp);
+				const gp_Trsf kOcctTransformation = rkOcctSubshape.Location().Transformation();
+				for (int row = 1; row <= 3; ++row)
+				{
+					for (int column = 1; column <= 4; ++column)
+					{
+						AddToStamp(kOcctTransformation.Value(row, column), stamp);
+					}
+				}
+
+				TopLoc_Location occtLocation;
+				switch (rkOcctSubshape.ShapeType())
+				{
+				case TopAbs_VERTEX:
+				{
+					const TopoDS_Vertex& rkOcctVertex = TopoDS::Vertex(rkOcctSubshape);
+					const gp_Pnt kOcctPoint = BRep_Tool::Pnt(rkOcctVertex);
+					AddToStamp(kOcctPoint.X(), stamp);
+					AddToStamp(kOcctPoint.Y(), stamp);
+					AddToStamp(kOcctPoint.Z(), stamp);
+					AddToStamp(BRep_Tool::Tolerance(rkOcctVertex), stamp);
+					break;
+				}
+				case TopAbs_EDGE:
+				{
+					const TopoDS_Edge& rkOcctEdge = TopoDS::Edge(rkOcctSubshape);
+					double first = 0.0, last = 0.0;
+					AddToStamp(BRep_Tool::Curve(rkOcctEdge, occtLocation, first, last).get(), stamp);
+					AddToStamp(first, stamp);
+					AddToStamp(last, stamp);
+					AddToStamp(BRep_Tool::Tolerance(rkOcctEdge), stamp);
+					break;
+				}
+				case TopAbs_FACE:
+				{
+					const TopoDS_Face& rkOcctFace = TopoDS::Face(rkOcctSubshape);
+					AddToStamp(BRep_Tool::Surface(rkOcctFace, occtLocation).get(), stamp);
+					AddToStamp(BRep_Tool::Tolerance(rkOcctFace), stamp);
+					break;
+				}
+				default:
+					break;
+				}
+			}
+			return stamp;
+		}
+
+		std::mutex m_mutex;
+		NCollection_DataMap<TopoDS_Shape, Entry, TopTools_ShapeMapHasher> m_validities;
+	};
+}
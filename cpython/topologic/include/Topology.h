@@ -20,10 +20,19 @@
 #include "GlobalCluster.h"
 #include "TopologicalQuery.h"
 #include "Dictionary.h"
+#include "AttributeManager.h"
+#include "TopologyAllocator.h"
+#include "NavigationScratch.h"
+#include "BooleanOptions.h"
+#include "BoundingBoxCache.h"
+#include "BooleanCache.h"
+#include "ShapeValidityCache.h"
+#include "Context.h"
 
 #include <TopTools_ListOfShape.hxx>
 #include <TopTools_DataMapOfShapeShape.hxx>
 #include <BOPAlgo_CellsBuilder.hxx>
+#include <BOPTools_AlgoTools.hxx>
 #include <BRepAlgoAPI_BooleanOperation.hxx>
 #include <BRepBuilderAPI_MakeShape.hxx>
 #include <Standard_Handle.hxx>
@@ -36,13 +45,36 @@
 #include <TopExp_Explorer.hxx>
 #include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
 #include <TopTools_MapOfShape.hxx>
-
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <Standard_Failure.hxx>
+#include <Bnd_BoundSortBox.hxx>
+#include <OSD_Parallel.hxx>
+#include <Bnd_HArray1OfBox.hxx>
+#include <BRep_Builder.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepBuilderAPI_Sewing.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepExtrema_DistShapeShape.hxx>
+#include <Precision.hxx>
+#include <gp.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Pln.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Vec.hxx>
+#include <TColStd_ListOfInteger.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopoDS_Iterator.hxx>
+
+#include <cmath>
 #include <limits>
 #include <list>
 #include <vector>
 #include <map>
 #include <memory>
 #include <algorithm>
+#include <sstream>
+#include <string>
 
 class TopoDS_Shape;
 
@@ -60,6 +92,7 @@ namespace TopologicCore
 	class Context;
 	class Aperture;
 	class TopologyFactory;
+	class BooleanSession;
 
 	/// <summary>
 	/// A Topology is an abstract superclass that constructors, properties and methods used by other subclasses that extend it.
@@ -210,6 +243,33 @@ namespace TopologicCore
 		/// <returns></returns>
 		static TopoDS_Shape OcctSewFaces(const TopTools_ListOfShape& rkOcctFaces, const double kTolerance = 0.001);
 
+		/// <summary>
+		/// Sews faces with the range of a progress token, throwing if it is cancelled.
+		/// </summary>
+		/// <param name="rkOcctFaces"></param>
+		/// <param name="kTolerance"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <returns></returns>
+		static TopoDS_Shape OcctSewFaces(const TopTools_ListOfShape& rkOcctFaces, const double kTolerance, const ProgressToken::Ptr& kpProgressToken)
+		{
+			BRepBuilderAPI_Sewing occtSewing(kTolerance, true, true, true, true);
+			for (TopTools_ListIteratorOfListOfShape occtFaceIterator(rkOcctFaces); occtFaceIterator.More(); occtFaceIterator.Next())
+			{
+				occtSewing.Add(occtFaceIterator.Value());
+			}
+
+			try
+			{
+				ProgressToken::Perform(occtSewing, ProgressToken::Start(kpProgressToken));
+			}
+			catch (Standard_Failure& e)
+			{
+				throw std::runtime_error(e.GetMessageString());
+			}
+			ProgressToken::ThrowIfCancelled(kpProgressToken);
+			return occtSewing.SewedShape();
+		}
+
 		/// <summary>
 		/// 
 		/// </summary>
@@ -256,6 +316,21 @@ namespace TopologicCore
 		/// <returns></returns>
 		TOPOLOGIC_API Topology::Ptr SelfMerge();
 
+		/// <summary>
+		/// Self-merges the members of a Cluster in spatial partitions, on the OCCT thread pool (TBB when OCCT is built with it).
+		/// The members are split into partitions by recursive median cuts of their bounding box centres; each partition
+		/// is self-merged on its own into loose Cells, Faces, Edges and Vertices, then only the parts touching a part of
+		/// another partition are merged again. The containers are made once, from all the parts, at the end.
+		/// The result is the conformal Cluster of the merged parts, grouped into containers (Wires, Shells, CellComplexes);
+		/// unlike SelfMerge(), closed Shells are not turned into Cells. Small inputs, and inputs where most members touch
+		/// another partition, are merged in one go instead, with the same kind of result. The partitions are always merged
+		/// non-destructively, since they may share sub-shapes.
+		/// </summary>
+		/// <param name="rkOptions">Applied to the self-merge of each partition and of the interfaces</param>
+		/// <param name="kNumOfPartitions">0 uses one partition per logical processor</param>
+		/// <returns></returns>
+		Topology::Ptr SelfMerge(const BooleanOptions& rkOptions, const int kNumOfPartitions = 0);
+
 		/// <summary>
 		/// 
 		/// </summary>
@@ -288,6 +363,150 @@ namespace TopologicCore
 		/// <returns></returns>
 		TOPOLOGIC_API Topology::Ptr Divide(const Topology::Ptr& kpTool = nullptr, const bool kTransferDictionary = false);
 
+		/// <summary>
+		/// Overloads of the boolean operations that run OCCT with the given options, e.g. in parallel or with a fuzzy value.
+		/// Imprint and Slice both keep every part of this topology split by the tool.
+		/// </summary>
+		/// <param name="kpOtherTopology"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		Topology::Ptr Difference(const Topology::Ptr& kpOtherTopology, const BooleanOptions& rkOptions, const bool kTransferDictionary = false)
+		{
+			return BooleanOperation(kpOtherTopology, BOOLEAN_DIFFERENCE, rkOptions, kTransferDictionary);
+		}
+
+		Topology::Ptr Impose(const Topology::Ptr& kpTool, const BooleanOptions& rkOptions, const bool kTransferDictionary = false)
+		{
+			return BooleanOperation(kpTool, BOOLEAN_IMPOSE, rkOptions, kTransferDictionary);
+		}
+
+		Topology::Ptr Imprint(const Topology::Ptr& kpTool, const BooleanOptions& rkOptions, const bool kTransferDictionary = false)
+		{
+			return BooleanOperation(kpTool, BOOLEAN_IMPRINT, rkOptions, kTransferDictionary);
+		}
+
+		Topology::Ptr Intersect(const Topology::Ptr& kpOtherTopology, const BooleanOptions& rkOptions, const bool kTransferDictionary = false)
+		{
+			return BooleanOperation(kpOtherTopology, BOOLEAN_INTERSECT, rkOptions, kTransferDictionary);
+		}
+
+		Topology::Ptr Merge(const Topology::Ptr& kpOtherTopology, const BooleanOptions& rkOptions, const bool kTransferDictionary = false)
+		{
+			return BooleanOperation(kpOtherTopology, BOOLEAN_MERGE, rkOptions, kTransferDictionary);
+		}
+
+		Topology::Ptr Slice(const Topology::Ptr& kpTool, const BooleanOptions& rkOptions, const bool kTransferDictionary = false)
+		{
+			return BooleanOperation(kpTool, BOOLEAN_SLICE, rkOptions, kTransferDictionary);
+		}
+
+		/// <summary>
+		/// Slices this topology by all the tools in a single cells builder run, instead of slicing the growing result
+		/// by one tool after another.
+		/// </summary>
+		/// <param name="rkTools"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		Topology::Ptr Slice(const std::list<Topology::Ptr>& rkTools, const BooleanOptions& rkOptions = BooleanOptions(), const bool kTransferDictionary = false);
+
+		/// <summary>
+		/// Slices this topology by a family of parallel planes, in a single cells builder run. The planes go through
+		/// the origin and are spaced along the normal, e.g. storey planes; only those strictly inside the exact bounding box,
+		/// by more than the tolerance, are used, so a plane on the bottom or top face does not leave a degenerate slice.
+		/// Without any such plane, the result is that of Slice() with no tools. Throws if the spacing would make more than
+		/// 10000 planes across the bounding box.
+		/// </summary>
+		/// <param name="kOriginX"></param>
+		/// <param name="kOriginY"></param>
+		/// <param name="kOriginZ"></param>
+		/// <param name="kNormalX"></param>
+		/// <param name="kNormalY"></param>
+		/// <param name="kNormalZ"></param>
+		/// <param name="kSpacing"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		Topology::Ptr Slice(
+			const double kOriginX, const double kOriginY, const double kOriginZ,
+			const double kNormalX, const double kNormalY, const double kNormalZ,
+			const double kSpacing,
+			const BooleanOptions& rkOptions = BooleanOptions(),
+			const bool kTransferDictionary = false);
+
+		/// <summary>
+		/// Divides a copy of this topology by all the tools: the parts of the slice are added to it as contents once,
+		/// see DivideBySlice.
+		/// </summary>
+		/// <param name="rkTools"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		Topology::Ptr Divide(const std::list<Topology::Ptr>& rkTools, const BooleanOptions& rkOptions = BooleanOptions(), const bool kTransferDictionary = false)
+		{
+			return DivideBySlice(Slice(rkTools, rkOptions, kTransferDictionary));
+		}
+
+		/// <summary>
+		/// Divides a copy of this topology by a family of parallel planes, see Slice.
+		/// </summary>
+		/// <param name="kOriginX"></param>
+		/// <param name="kOriginY"></param>
+		/// <param name="kOriginZ"></param>
+		/// <param name="kNormalX"></param>
+		/// <param name="kNormalY"></param>
+		/// <param name="kNormalZ"></param>
+		/// <param name="kSpacing"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		Topology::Ptr Divide(
+			const double kOriginX, const double kOriginY, const double kOriginZ,
+			const double kNormalX, const double kNormalY, const double kNormalZ,
+			const double kSpacing,
+			const BooleanOptions& rkOptions = BooleanOptions(),
+			const bool kTransferDictionary = false)
+		{
+			return DivideBySlice(Slice(kOriginX, kOriginY, kOriginZ, kNormalX, kNormalY, kNormalZ, kSpacing, rkOptions, kTransferDictionary));
+		}
+
+		Topology::Ptr Union(const Topology::Ptr& kpOtherTopology, const BooleanOptions& rkOptions, const bool kTransferDictionary = false)
+		{
+			return BooleanOperation(kpOtherTopology, BOOLEAN_UNION, rkOptions, kTransferDictionary);
+		}
+
+		Topology::Ptr XOR(const Topology::Ptr& kpOtherTopology, const BooleanOptions& rkOptions, const bool kTransferDictionary = false)
+		{
+			return BooleanOperation(kpOtherTopology, BOOLEAN_XOR, rkOptions, kTransferDictionary);
+		}
+
+		/// <summary>
+		/// Merges all the topologies in a single cells builder run, instead of folding Merge over the list.
+		/// Internal boundaries are kept. Null entries are skipped; returns null if there are no others.
+		/// </summary>
+		/// <param name="rkTopologies"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		static Topology::Ptr MergeAll(const std::list<Topology::Ptr>& rkTopologies, const BooleanOptions& rkOptions = BooleanOptions(), const bool kTransferDictionary = false)
+		{
+			return BooleanOperation(rkTopologies, BOOLEAN_MERGE, rkOptions, kTransferDictionary);
+		}
+
+		/// <summary>
+		/// Unites all the topologies in a single cells builder run, instead of folding Union over the list.
+		/// Internal boundaries are removed. Null entries are skipped; returns null if there are no others.
+		/// </summary>
+		/// <param name="rkTopologies"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		static Topology::Ptr UnionAll(const std::list<Topology::Ptr>& rkTopologies, const BooleanOptions& rkOptions = BooleanOptions(), const bool kTransferDictionary = false)
+		{
+			return BooleanOperation(rkTopologies, BOOLEAN_UNION, rkOptions, kTransferDictionary);
+		}
+
 		/// <summary>
 		/// 
 		/// </summary>
@@ -508,6 +727,30 @@ namespace TopologicCore
 		/// <param name="rOcctMembers"></param>
 		static void DownwardNavigation(const TopoDS_Shape& rkOcctShape, const TopAbs_ShapeEnum& rkShapeEnum, TopTools_MapOfShape& rOcctMembers);
 
+		/// <summary>
+		/// Navigate() for code compiled from these headers: the wrappers of the sub-topologies and ancestors are created
+		/// with AllocateTopology, from the TopologyPool or the TopologyArena open on the calling thread. Navigate() and the
+		/// methods of the library built on it are left as the library compiled them.
+		/// </summary>
+		/// <param name="rMembers"></param>
+		template <class Subclass>
+		void PooledNavigate(std::list<std::shared_ptr<Subclass>>& rMembers) const;
+
+		/// <summary>
+		/// UpwardNavigation() with the wrappers created with AllocateTopology and the maps leased from NavigationScratch.
+		/// </summary>
+		/// <param name="rkOcctHostTopology"></param>
+		/// <param name="rAncestors"></param>
+		template <class Subclass>
+		void PooledUpwardNavigation(const TopoDS_Shape& rkOcctHostTopology, std::list<std::shared_ptr<Subclass>>& rAncestors) const;
+
+		/// <summary>
+		/// DownwardNavigation() with the wrappers created with AllocateTopology and the map leased from NavigationScratch.
+		/// </summary>
+		/// <param name="rMembers"></param>
+		template <class Subclass>
+		void PooledDownwardNavigation(std::list<std::shared_ptr<Subclass>>& rMembers) const;
+
 		/// <summary>
 		/// Copy the whole content/context hierarchy.
 		/// </summary>
@@ -650,6 +893,8 @@ namespace TopologicCore
 		Dictionary GetDictionary();
 
 	protected:
+		friend class BooleanSession;
+
 		Topology(const int kDimensionality, const TopoDS_Shape& rkOcctShape, const std::string& rkGuid = "");
         void AddUnionInternalStructure(const TopoDS_Shape& rkOcctShape, TopTools_ListOfShape& rUnionArguments);
 
@@ -729,6 +974,105 @@ namespace TopologicCore
 			const TopTools_ListOfShape& rkOcctArgumentsB,
 			BOPAlgo_CellsBuilder& rOcctCellsBuilder);
 
+		/// <summary>
+		/// 
+		/// </summary>
+		/// <param name="kpOtherTopology"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="rOcctCellsBuilder"></param>
+		/// <param name="rOcctCellsBuildersOperandsA"></param>
+		/// <param name="rOcctCellsBuildersOperandsB"></param>
+		/// <param name="rOcctMapFaceToFixedFaceA"></param>
+		/// <param name="rOcctMapFaceToFixedFaceB"></param>
+		void NonRegularBooleanOperation(
+			const Topology::Ptr& kpOtherTopology,
+			const BooleanOptions& rkOptions,
+			BOPAlgo_CellsBuilder& rOcctCellsBuilder,
+			TopTools_ListOfShape& rOcctCellsBuildersOperandsA,
+			TopTools_ListOfShape& rOcctCellsBuildersOperandsB,
+			TopTools_DataMapOfShapeShape& rOcctMapFaceToFixedFaceA,
+			TopTools_DataMapOfShapeShape& rOcctMapFaceToFixedFaceB)
+		{
+			rkOptions.Apply(rOcctCellsBuilder);
+			if (rkOptions.fixValidOperands && rkOptions.progressToken == nullptr)
+			{
+				NonRegularBooleanOperation(kpOtherTopology, rOcctCellsBuilder, rOcctCellsBuildersOperandsA, rOcctCellsBuildersOperandsB, rOcctMapFaceToFixedFaceA, rOcctMapFaceToFixedFaceB);
+				MapFixedBooleanArguments(GetOcctShape(), rOcctCellsBuildersOperandsA, rOcctMapFaceToFixedFaceA);
+				MapFixedBooleanArguments(kpOtherTopology->GetOcctShape(), rOcctCellsBuildersOperandsB, rOcctMapFaceToFixedFaceB);
+				return;
+			}
+
+			if (rkOptions.fixValidOperands)
+			{
+				AddBooleanOperands(kpOtherTopology, rOcctCellsBuilder, rOcctCellsBuildersOperandsA, rOcctCellsBuildersOperandsB, rOcctMapFaceToFixedFaceA, rOcctMapFaceToFixedFaceB);
+				MapFixedBooleanArguments(GetOcctShape(), rOcctCellsBuildersOperandsA, rOcctMapFaceToFixedFaceA);
+				MapFixedBooleanArguments(kpOtherTopology->GetOcctShape(), rOcctCellsBuildersOperandsB, rOcctMapFaceToFixedFaceB);
+			}
+			else
+			{
+				AddBooleanArguments(rOcctCellsBuildersOperandsA, rOcctMapFaceToFixedFaceA, false);
+				kpOtherTopology->AddBooleanArguments(rOcctCellsBuildersOperandsB, rOcctMapFaceToFixedFaceB, false);
+			}
+			PerformCellsBuilder(rOcctCellsBuildersOperandsA, rOcctCellsBuildersOperandsB, rkOptions.progressToken, rOcctCellsBuilder);
+		}
+
+		/// <summary>
+		/// 
+		/// </summary>
+		/// <param name="rkOcctArgumentsA"></param>
+		/// <param name="rkOcctArgumentsB"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="rOcctCellsBuilder"></param>
+		static void NonRegularBooleanOperation(
+			const TopTools_ListOfShape& rkOcctArgumentsA,
+			const TopTools_ListOfShape& rkOcctArgumentsB,
+			const BooleanOptions& rkOptions,
+			BOPAlgo_CellsBuilder& rOcctCellsBuilder)
+		{
+			rkOptions.Apply(rOcctCellsBuilder);
+			if (rkOptions.progressToken == nullptr)
+			{
+				NonRegularBooleanOperation(rkOcctArgumentsA, rkOcctArgumentsB, rOcctCellsBuilder);
+				return;
+			}
+
+			PerformCellsBuilder(rkOcctArgumentsA, rkOcctArgumentsB, rkOptions.progressToken, rOcctCellsBuilder);
+		}
+
+		/// <summary>
+		/// Runs the cells builder on the arguments with the range of a progress token, throwing if it is cancelled or fails.
+		/// </summary>
+		/// <param name="rkOcctArgumentsA"></param>
+		/// <param name="rkOcctArgumentsB"></param>
+		/// <param name="kpProgressToken"></param>
+		/// <param name="rOcctCellsBuilder"></param>
+		static void PerformCellsBuilder(
+			const TopTools_ListOfShape& rkOcctArgumentsA,
+			const TopTools_ListOfShape& rkOcctArgumentsB,
+			const ProgressToken::Ptr& kpProgressToken,
+			BOPAlgo_CellsBuilder& rOcctCellsBuilder)
+		{
+			TopTools_ListOfShape occtArguments;
+			for (TopTools_ListIteratorOfListOfShape occtArgumentIterator(rkOcctArgumentsA); occtArgumentIterator.More(); occtArgumentIterator.Next())
+			{
+				occtArguments.Append(occtArgumentIterator.Value());
+			}
+			for (TopTools_ListIteratorOfListOfShape occtArgumentIterator(rkOcctArgumentsB); occtArgumentIterator.More(); occtArgumentIterator.Next())
+			{
+				occtArguments.Append(occtArgumentIterator.Value());
+			}
+
+			rOcctCellsBuilder.SetArguments(occtArguments);
+			ProgressToken::Perform(rOcctCellsBuilder, ProgressToken::Start(kpProgressToken));
+			ProgressToken::ThrowIfCancelled(kpProgressToken);
+			if (rOcctCellsBuilder.HasErrors())
+			{
+				std::ostringstream errorStream;
+				rOcctCellsBuilder.DumpErrors(errorStream);
+				throw std::runtime_error(errorStream.str());
+			}
+		}
+
 		/// <summary>
 		/// 
 		/// </summary>
@@ -743,72 +1087,372 @@ namespace TopologicCore
 		/// <summary>
 		/// 
 		/// </summary>
-		/// <param name="rOcctBooleanResult"></param>
+		/// <param name="rkOcctArgumentsA"></param>
+		/// <param name="rkOcctArgumentsB"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="rOcctBooleanOperation"></param>
+		static void RegularBooleanOperation(
+			const TopTools_ListOfShape& rkOcctArgumentsA,
+			const TopTools_ListOfShape& rkOcctArgumentsB,
+			const BooleanOptions& rkOptions,
+			BRepAlgoAPI_BooleanOperation& rOcctBooleanOperation)
+		{
+			rkOptions.Apply(rOcctBooleanOperation);
+			if (rkOptions.progressToken == nullptr)
+			{
+				RegularBooleanOperation(rkOcctArgumentsA, rkOcctArgumentsB, rOcctBooleanOperation);
+				return;
+			}
+
+			rOcctBooleanOperation.SetArguments(rkOcctArgumentsA);
+			rOcctBooleanOperation.SetTools(rkOcctArgumentsB);
+			ProgressToken::Build(rOcctBooleanOperation, ProgressToken::Start(rkOptions.progressToken));
+			ProgressToken::ThrowIfCancelled(rkOptions.progressToken);
+			if (rOcctBooleanOperation.HasErrors())
+			{
+				std::ostringstream errorStream;
+				rOcctBooleanOperation.DumpErrors(errorStream);
+				throw std::runtime_error(errorStream.str());
+			}
+		}
+
+		/// <summary>
+		/// Runs a non-regular boolean operation with the given options, going through the BooleanCache if they ask for it.
+		/// </summary>
+		/// <param name="kpOtherTopology"></param>
+		/// <param name="kOperationType"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
 		/// <returns></returns>
-		TopoDS_Shape PostprocessBooleanResult(
-			TopoDS_Shape& rOcctBooleanResult
-		);
+		Topology::Ptr BooleanOperation(
+			const Topology::Ptr& kpOtherTopology,
+			const BooleanOperationType kOperationType,
+			const BooleanOptions& rkOptions,
+			const bool kTransferDictionary);
 
 		/// <summary>
-		/// 
+		/// Runs a non-regular boolean operation with the given options and selects its result in the cells builder.
 		/// </summary>
-		/// <param name="rkOcctMakeShape"></param>
-		/// <param name="rkShapes"></param>
-		static void TransferMakeShapeContents(BRepBuilderAPI_MakeShape & rkOcctMakeShape, const std::list<Topology::Ptr>& rkShapes);
+		/// <param name="kpOtherTopology"></param>
+		/// <param name="kOperationType"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <param name="pImageIndices">If not null, receives the images of the operands' sub-shapes for the BooleanCache</param>
+		/// <returns></returns>
+		Topology::Ptr PerformBooleanOperation(
+			const Topology::Ptr& kpOtherTopology,
+			const BooleanOperationType kOperationType,
+			const BooleanOptions& rkOptions,
+			const bool kTransferDictionary,
+			BooleanCache::ImageIndices* pImageIndices);
 
 		/// <summary>
-		/// 
+		/// Makes a copy of a cached boolean result and reattaches the dictionaries of this topology and kpOtherTopology
+		/// to the images of their sub-shapes.
 		/// </summary>
-		/// <param name="rkOcctMakeShape"></param>
-		/// <param name="rkOcctShapes"></param>
-		static void TransferMakeShapeContents(BRepBuilderAPI_MakeShape& rkOcctMakeShape, const TopTools_ListOfShape& rkOcctShapes);
+		/// <param name="kpOtherTopology"></param>
+		/// <param name="kOperationType"></param>
+		/// <param name="rkOcctCachedResult">May be null</param>
+		/// <param name="rkImageIndices"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		Topology::Ptr MakeCachedBooleanResult(
+			const Topology::Ptr& kpOtherTopology,
+			const BooleanOperationType kOperationType,
+			const TopoDS_Shape& rkOcctCachedResult,
+			const BooleanCache::ImageIndices& rkImageIndices,
+			const bool kTransferDictionary);
 
 		/// <summary>
-		/// 
+		/// Runs an n-ary merge or union of the topologies in one cells builder run.
 		/// </summary>
-		/// <param name="rkOcctShape"></param>
+		/// <param name="rkTopologies"></param>
+		/// <param name="kOperationType">BOOLEAN_MERGE or BOOLEAN_UNION</param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
 		/// <returns></returns>
-		TopoDS_Shape FixBooleanOperandCell(const TopoDS_Shape& rkOcctShape);
+		static Topology::Ptr BooleanOperation(
+			const std::list<Topology::Ptr>& rkTopologies,
+			const BooleanOperationType kOperationType,
+			const BooleanOptions& rkOptions,
+			const bool kTransferDictionary);
 
 		/// <summary>
-		/// 
+		/// Adds the arguments of a topology to an n-ary boolean: the members of a Cluster, the cells of a CellComplex,
+		/// or the topology itself, fixed as in AddBooleanOperands.
+		/// </summary>
+		/// <param name="rOcctArguments"></param>
+		/// <param name="rOcctMapShapeToFixedShape">Maps the fixed arguments and faces to their fixed versions</param>
+		/// <param name="kFixesValidShapes">If false, the arguments found valid by the ShapeValidityCache are added as they are</param>
+		void AddBooleanArguments(TopTools_ListOfShape& rOcctArguments, TopTools_DataMapOfShapeShape& rOcctMapShapeToFixedShape, const bool kFixesValidShapes = true);
+
+		/// <summary>
+		/// Lists the shapes that stand for a topology in a boolean: the members of a Cluster, the cells of a CellComplex,
+		/// or the topology itself.
 		/// </summary>
 		/// <param name="rkOcctShape"></param>
-		/// <returns></returns>
-		TopoDS_Shape FixBooleanOperandShell(const TopoDS_Shape& rkOcctShape);
+		/// <param name="rOcctArgumentShapes"></param>
+		static void BooleanArgumentShapes(const TopoDS_Shape& rkOcctShape, TopTools_ListOfShape& rOcctArgumentShapes);
 
 		/// <summary>
-		/// 
+		/// Maps the argument shapes of an operand to the fixed shapes AddBooleanOperands gave to the cells builder in the
+		/// same order, so that the history of the solids and shells it recreated can be followed.
 		/// </summary>
 		/// <param name="rkOcctShape"></param>
-		/// <param name="rMapFaceToFixedFace"></param>
-		/// <returns></returns>
-		TopoDS_Shape FixBooleanOperandFace(const TopoDS_Shape& rkOcctShape, TopTools_DataMapOfShapeShape& rMapFaceToFixedFace);
+		/// <param name="rkOcctFixedArguments"></param>
+		/// <param name="rOcctMapShapeToFixedShape"></param>
+		static void MapFixedBooleanArguments(const TopoDS_Shape& rkOcctShape, const TopTools_ListOfShape& rkOcctFixedArguments, TopTools_DataMapOfShapeShape& rOcctMapShapeToFixedShape);
 
-		TopoDS_Shape FixBooleanOperandFace(const TopoDS_Shape& rkOcctShape);
+		/// <summary>
+		/// Copies the dictionary of an operand itself, e.g. of a CellComplex, to a boolean result of the same type.
+		/// The dictionaries of its sub-shapes are transferred by TransferDictionaries.
+		/// </summary>
+		/// <param name="rkOcctOriginShape"></param>
+		/// <param name="rkOcctDestinationShape"></param>
+		static void TransferOperandDictionary(const TopoDS_Shape& rkOcctOriginShape, const TopoDS_Shape& rkOcctDestinationShape);
 
-		void GetDeletedBooleanSubtopologies(const TopoDS_Shape& rkOcctShape, BOPAlgo_CellsBuilder& rOcctCellsBuilder, TopTools_ListOfShape& rOcctDeletedShapes);
+		/// <summary>
+		/// Copies the dictionaries of the two operands of a binary boolean to its result, the first operand's last. The second
+		/// operand's is not copied by Difference, which keeps nothing of it.
+		/// </summary>
+		/// <param name="kpOtherTopology"></param>
+		/// <param name="kOperationType"></param>
+		/// <param name="rkOcctDestinationShape"></param>
+		void TransferOperandDictionaries(const Topology::Ptr& kpOtherTopology, const BooleanOperationType kOperationType, const TopoDS_Shape& rkOcctDestinationShape) const;
+
+		/// <summary>
+		/// Transfers the dictionaries of the sub-shapes of rkOcctOriginShape to their images in rkOcctDestinationShape,
+		/// following the modification history of an OCCT algorithm (e.g. BOPAlgo_CellsBuilder, BRepBuilderAPI_MakeShape).
+		/// Deleted sub-shapes are skipped; unmodified ones keep their dictionaries as they are.
+		/// </summary>
+		/// <param name="rOcctHistory"></param>
+		/// <param name="rkOcctOriginShape"></param>
+		/// <param name="rkOcctMapShapeToFixedShape">Maps sub-shapes of the origin to the fixed shapes given to the algorithm</param>
+		/// <param name="rkOcctDestinationShape"></param>
+		template <class OcctHistory>
+		static void TransferDictionaries(
+			OcctHistory& rOcctHistory,
+			const TopoDS_Shape& rkOcctOriginShape,
+			const TopTools_DataMapOfShapeShape& rkOcctMapShapeToFixedShape,
+			const TopoDS_Shape& rkOcctDestinationShape);
+
+		/// <summary>
+		/// Records the images of all the sub-shapes of rkOcctOriginShape in rkOcctDestinationSubshapes as pairs of indices
+		/// in the order of TopExp::MapShapes, the origin indices being shifted by kOffset.
+		/// </summary>
+		/// <param name="pOcctHistory">If null, every sub-shape is its own image</param>
+		/// <param name="rkOcctOriginShape"></param>
+		/// <param name="rkOcctMapShapeToFixedShape"></param>
+		/// <param name="rkOcctDestinationSubshapes"></param>
+		/// <param name="kOffset"></param>
+		/// <param name="rImageIndices"></param>
+		/// <returns>The number of sub-shapes of rkOcctOriginShape</returns>
+		template <class OcctHistory>
+		static int RecordBooleanImages(
+			OcctHistory* pOcctHistory,
+			const TopoDS_Shape& rkOcctOriginShape,
+			const TopTools_DataMapOfShapeShape& rkOcctMapShapeToFixedShape,
+			const TopTools_IndexedMapOfShape& rkOcctDestinationSubshapes,
+			const int kOffset,
+			BooleanCache::ImageIndices& rImageIndices);
+
+		/// <summary>
+		/// Gets the images of a sub-shape of an operand from the history of an OCCT algorithm: its modified shapes and
+		/// the generated shapes of the same type, or the (fixed) sub-shape itself if there are none.
+		/// </summary>
+		/// <param name="pOcctHistory">If null, the sub-shape is its own image</param>
+		/// <param name="rkOcctOriginSubshape"></param>
+		/// <param name="rkOcctMapShapeToFixedShape"></param>
+		/// <param name="rOcctImages"></param>
+		/// <returns>False if the sub-shape has been deleted</returns>
+		template <class OcctHistory>
+		static bool BooleanImages(
+			OcctHistory* pOcctHistory,
+			const TopoDS_Shape& rkOcctOriginSubshape,
+			const TopTools_DataMapOfShapeShape& rkOcctMapShapeToFixedShape,
+			TopTools_ListOfShape& rOcctImages);
+
+		/// <summary>
+		/// Splits the members of two operands into those whose bounding boxes overlap a member of the other operand
+		/// and those that are disjoint from the other operand. A topology other than a Cluster is its own single member.
+		/// </summary>
+		/// <param name="rkOcctShapeA"></param>
+		/// <param name="rkOcctShapeB"></param>
+		/// <param name="rkOptions">The fuzzy value enlarges the boxes; useOBB also compares oriented boxes</param>
+		/// <param name="rOcctOverlappingMembersA"></param>
+		/// <param name="rOcctDisjointMembersA"></param>
+		/// <param name="rOcctOverlappingMembersB"></param>
+		/// <param name="rOcctDisjointMembersB"></param>
+		static void PartitionBooleanOperands(
+			const TopoDS_Shape& rkOcctShapeA,
+			const TopoDS_Shape& rkOcctShapeB,
+			const BooleanOptions& rkOptions,
+			TopTools_ListOfShape& rOcctOverlappingMembersA,
+			TopTools_ListOfShape& rOcctDisjointMembersA,
+			TopTools_ListOfShape& rOcctOverlappingMembersB,
+			TopTools_ListOfShape& rOcctDisjointMembersB);
+
+		/// <summary>
+		/// Slices this topology by tools already added as boolean arguments.
+		/// </summary>
+		/// <param name="rkOcctToolArguments"></param>
+		/// <param name="rOcctMapShapeToFixedShape">Holds the fixed tool arguments and faces</param>
+		/// <param name="rkOcctTools">The tools whose dictionaries are transferred</param>
+		/// <param name="rkOptions"></param>
+		/// <param name="kTransferDictionary"></param>
+		/// <returns></returns>
+		Topology::Ptr SliceByArguments(
+			const TopTools_ListOfShape& rkOcctToolArguments,
+			TopTools_DataMapOfShapeShape& rOcctMapShapeToFixedShape,
+			const TopTools_ListOfShape& rkOcctTools,
+			const BooleanOptions& rkOptions,
+			const bool kTransferDictionary);
 
-		void GetDeletedBooleanSubtopologies(const TopoDS_Shape& rkOcctShape, BRepAlgoAPI_BooleanOperation& rOcctBooleanOperation, TopTools_ListOfShape& rOcctDeletedShapes);
+		/// <summary>
+		/// Returns a copy of this topology with the parts of its slice as contents. The contents and apertures of this
+		/// topology and of its sub-topologies are moved to the part nearest to their centre of mass, on a sub-topology of the
+		/// same type as their original context.
+		/// </summary>
+		/// <param name="kpSlicedTopology"></param>
+		/// <returns></returns>
+		Topology::Ptr DivideBySlice(const Topology::Ptr& kpSlicedTopology);
 
-		Topology::Ptr TrackContextAncestor();
+		/// <summary>
+		/// Splits shapes into kNumOfPartitions groups of similar sizes by recursive median cuts of their bounding box centres
+		/// along the longest axis.
+		/// </summary>
+		/// <param name="rkOcctShapes"></param>
+		/// <param name="kNumOfPartitions"></param>
+		/// <param name="rOcctPartitions"></param>
+		static void PartitionSpatially(const TopTools_ListOfShape& rkOcctShapes, const int kNumOfPartitions, std::vector<TopTools_ListOfShape>& rOcctPartitions);
 
-		static Topology::Ptr IntersectEdgeFace(const Topology::Ptr kpMergeTopology, Edge const * const kpkEdge, Face const * const kpkFace);
+		/// <summary>
+		/// Flags the shapes whose bounding boxes, enlarged by kFuzzyValue, overlap that of a shape from another partition.
+		/// </summary>
+		/// <param name="rkOcctShapes"></param>
+		/// <param name="rkPartitionIndices">The partition of each shape</param>
+		/// <param name="kFuzzyValue"></param>
+		/// <param name="rIsOnInterface"></param>
+		/// <returns>The number of flagged shapes</returns>
+		static int FindInterfaceShapes(
+			const std::vector<TopoDS_Shape>& rkOcctShapes,
+			const std::vector<int>& rkPartitionIndices,
+			const double kFuzzyValue,
+			std::vector<bool>& rIsOnInterface);
 
-		static Topology::Ptr IntersectFaceFace(const Topology::Ptr kpMergeTopology, Face const* const kpkFace, Face const* const kpkOtherFace);
+		/// <summary>
+		/// Splits shapes at their mutual intersections, keeping all the parts, and groups the parts into containers.
+		/// </summary>
+		/// <param name="rkOcctShapes"></param>
+		/// <param name="rkOptions"></param>
+		/// <param name="rkOcctRange">Drives the progress and cancellation of the cells builder</param>
+		/// <param name="kMakesContainers">If false, the parts are returned loose in a compound</param>
+		/// <returns></returns>
+		static TopoDS_Shape MergeConformally(
+			const TopTools_ListOfShape& rkOcctShapes,
+			const BooleanOptions& rkOptions,
+			const ProgressToken::Range& rkOcctRange,
+			const bool kMakesContainers = true);
 
-		static Topology::Ptr IntersectEdgeShell(Edge * const kpkEdge, Shell const * const kpkShell);
+		/// <summary>
+		/// Groups the connected Solids, Faces and Edges of conformal parts into CompSolids, Shells and Wires, as
+		/// BOPAlgo_CellsBuilder::MakeContainers() does, and adds them and the Vertices to a compound.
+		/// </summary>
+		/// <param name="rkOcctParts"></param>
+		/// <returns></returns>
+		static TopoDS_Shape MakeContainers(const TopTools_ListOfShape& rkOcctParts);
 
-		int m_dimensionality;
-		static int m_numOfTopologies;
-	};
+		/// <summary>
+		/// Adds the members of a boolean result and the members left out of the boolean by the broad phase to a compound,
+		/// or returns the only one there is.
+		/// </summary>
+		/// <param name="rkOcctBooleanResult">May be null</param>
+		/// <param name="rkOcctUnchangedMembers"></param>
+		/// <returns></returns>
+		static TopoDS_Shape MakeBooleanResultCompound(const TopoDS_Shape& rkOcctBooleanResult, const TopTools_ListOfShape& rkOcctUnchangedMembers);
 
-	template<class Subclass>
-	void Topology::Navigate(std::list<std::shared_ptr<Subclass>>& rMembers) const
-	{
-		if (Subclass::Type() > GetType())
-		{
-			UpwardNavigation(rMembers);
+		/// <summary>
+		/// Adds the parts of the operands that make up the result of an operation to the cells builder's result.
+		/// </summary>
+		/// <param name="kOperationType"></param>
+		/// <param name="rkOcctArgumentsA"></param>
+		/// <param name="rkOcctArgumentsB"></param>
+		/// <param name="rOcctCellsBuilder"></param>
+		static void SelectBooleanResult(
+			const BooleanOperationType kOperationType,
+			const TopTools_ListOfShape& rkOcctArgumentsA,
+			const TopTools_ListOfShape& rkOcctArgumentsB,
+			BOPAlgo_CellsBuilder& rOcctCellsBuilder);
+
+		/// <summary>
+		/// 
+		/// </summary>
+		/// <param name="rOcctBooleanResult"></param>
+		/// <returns></returns>
+		TopoDS_Shape PostprocessBooleanResult(
+			TopoDS_Shape& rOcctBooleanResult
+		);
+
+		/// <summary>
+		/// 
+		/// </summary>
+		/// <param name="rkOcctMakeShape"></param>
+		/// <param name="rkShapes"></param>
+		static void TransferMakeShapeContents(BRepBuilderAPI_MakeShape & rkOcctMakeShape, const std::list<Topology::Ptr>& rkShapes);
+
+		/// <summary>
+		/// 
+		/// </summary>
+		/// <param name="rkOcctMakeShape"></param>
+		/// <param name="rkOcctShapes"></param>
+		static void TransferMakeShapeContents(BRepBuilderAPI_MakeShape& rkOcctMakeShape, const TopTools_ListOfShape& rkOcctShapes);
+
+		/// <summary>
+		/// 
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		/// <returns></returns>
+		TopoDS_Shape FixBooleanOperandCell(const TopoDS_Shape& rkOcctShape);
+
+		/// <summary>
+		/// 
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		/// <returns></returns>
+		TopoDS_Shape FixBooleanOperandShell(const TopoDS_Shape& rkOcctShape);
+
+		/// <summary>
+		/// 
+		/// </summary>
+		/// <param name="rkOcctShape"></param>
+		/// <param name="rMapFaceToFixedFace"></param>
+		/// <returns></returns>
+		TopoDS_Shape FixBooleanOperandFace(const TopoDS_Shape& rkOcctShape, TopTools_DataMapOfShapeShape& rMapFaceToFixedFace);
+
+		TopoDS_Shape FixBooleanOperandFace(const TopoDS_Shape& rkOcctShape);
+
+		void GetDeletedBooleanSubtopologies(const TopoDS_Shape& rkOcctShape, BOPAlgo_CellsBuilder& rOcctCellsBuilder, TopTools_ListOfShape& rOcctDeletedShapes);
+
+		void GetDeletedBooleanSubtopologies(const TopoDS_Shape& rkOcctShape, BRepAlgoAPI_BooleanOperation& rOcctBooleanOperation, TopTools_ListOfShape& rOcctDeletedShapes);
+
+		Topology::Ptr TrackContextAncestor();
+
+		static Topology::Ptr IntersectEdgeFace(const Topology::Ptr kpMergeTopology, Edge const * const kpkEdge, Face const * const kpkFace);
+
+		static Topology::Ptr IntersectFaceFace(const Topology::Ptr kpMergeTopology, Face const* const kpkFace, Face const* const kpkOtherFace);
+
+		static Topology::Ptr IntersectEdgeShell(Edge * const kpkEdge, Shell const * const kpkShell);
+
+		int m_dimensionality;
+		static int m_numOfTopologies;
+	};
+
+	template<class Subclass>
+	void Topology::Navigate(std::list<std::shared_ptr<Subclass>>& rMembers) const
+	{
+		if (Subclass::Type() > GetType())
+		{
+			UpwardNavigation(rMembers);
 		}
 		else if (Subclass::Type() < GetType())
 		{
@@ -883,6 +1527,1316 @@ namespace TopologicCore
 		}
 	}
 
+	template<class Subclass>
+	void Topology::PooledNavigate(std::list<std::shared_ptr<Subclass>>& rMembers) const
+	{
+		if (Subclass::Type() > GetType())
+		{
+			PooledUpwardNavigation(GlobalCluster::GetInstance().GetOcctCompound(), rMembers);
+		}
+		else if (Subclass::Type() < GetType())
+		{
+			PooledDownwardNavigation(rMembers);
+		}
+		else
+		{
+			rMembers.push_back(TopologicalQuery::Downcast<Subclass>(ByOcctShape(GetOcctShape(), GetInstanceGUID())));
+		}
+	}
+
+	template<class Subclass>
+	inline void Topology::PooledUpwardNavigation(const TopoDS_Shape& rkOcctHostTopology, std::list<std::shared_ptr<Subclass>>& rAncestors) const
+	{
+		static_assert(std::is_base_of<Topology, Subclass>::value, "Subclass not derived from Topology");
+
+		TopAbs_ShapeEnum occtShapeType = CheckOcctShapeType<Subclass>();
+
+		NavigationScratch::Lease scratch;
+		TopTools_MapOfShape& rOcctAncestorMap = scratch->OcctShapes();
+		TopTools_IndexedDataMapOfShapeListOfShape& rOcctShapeMap = scratch->OcctShapeMap();
+		TopExp::MapShapesAndUniqueAncestors(
+			rkOcctHostTopology,
+			GetOcctShape().ShapeType(),
+			occtShapeType,
+			rOcctShapeMap);
+
+		const TopTools_ListOfShape* kpOcctAncestors = rOcctShapeMap.Seek(GetOcctShape());
+		if (kpOcctAncestors == nullptr)
+		{
+			return;
+		}
+
+		for (TopTools_ListIteratorOfListOfShape occtAncestorIterator(*kpOcctAncestors);
+			occtAncestorIterator.More();
+			occtAncestorIterator.Next())
+		{
+			const TopoDS_Shape& rkOcctAncestor = occtAncestorIterator.Value();
+			if (rkOcctAncestor.ShapeType() == occtShapeType && rOcctAncestorMap.Add(rkOcctAncestor))
+			{
+				rAncestors.push_back(AllocateTopology<Subclass>(rkOcctAncestor));
+			}
+		}
+	}
+
+	template <class Subclass>
+	void Topology::PooledDownwardNavigation(std::list<std::shared_ptr<Subclass>>& rMembers) const
+	{
+		static_assert(std::is_base_of<Topology, Subclass>::value, "Subclass not derived from Topology");
+
+		TopAbs_ShapeEnum occtShapeType = CheckOcctShapeType<Subclass>();
+		NavigationScratch::Lease scratch;
+		TopTools_MapOfShape& rOcctShapes = scratch->OcctShapes();
+		for (TopExp_Explorer occtExplorer(GetOcctShape(), occtShapeType); occtExplorer.More(); occtExplorer.Next())
+		{
+			const TopoDS_Shape& occtCurrent = occtExplorer.Current();
+			if (rOcctShapes.Add(occtCurrent))
+			{
+				rMembers.push_back(AllocateTopology<Subclass>(occtCurrent));
+			}
+		}
+	}
+
+	inline Topology::Ptr Topology::BooleanOperation(
+		const Topology::Ptr& kpOtherTopology,
+		const BooleanOperationType kOperationType,
+		const BooleanOptions& rkOptions,
+		const bool kTransferDictionary)
+	{
+		if (kpOtherTopology == nullptr)
+		{
+			return nullptr;
+		}
+
+		if (!rkOptions.useCache)
+		{
+			return PerformBooleanOperation(kpOtherTopology, kOperationType, rkOptions, kTransferDictionary, nullptr);
+		}
+
+		BooleanCache& rBooleanCache = BooleanCache::GetInstance();
+		const std::string kKey = BooleanCache::Key(GetOcctShape(), kpOtherTopology->GetOcctShape(), kOperationType, rkOptions);
+		TopoDS_Shape occtCachedResult;
+		BooleanCache::ImageIndices imageIndices;
+		if (rBooleanCache.Find(kKey, occtCachedResult, imageIndices))
+		{
+			return MakeCachedBooleanResult(kpOtherTopology, kOperationType, occtCachedResult, imageIndices, kTransferDictionary);
+		}
+
+		Topology::Ptr pResultTopology = PerformBooleanOperation(kpOtherTopology, kOperationType, rkOptions, kTransferDictionary, &imageIndices);
+		rBooleanCache.Add(kKey, pResultTopology == nullptr ? TopoDS_Shape() : pResultTopology->GetOcctShape(), imageIndices);
+		return pResultTopology;
+	}
+
+	inline Topology::Ptr Topology::PerformBooleanOperation(
+		const Topology::Ptr& kpOtherTopology,
+		const BooleanOperationType kOperationType,
+		const BooleanOptions& rkOptions,
+		const bool kTransferDictionary,
+		BooleanCache::ImageIndices* pImageIndices)
+	{
+		BoundingBoxCache::Scope boundingBoxCacheScope;
+
+		// Broad phase: only the members of a Cluster whose boxes overlap the other operand go into the intersection.
+		Topology::Ptr pOperandA = shared_from_this();
+		Topology::Ptr pOperandB = kpOtherTopology;
+		TopTools_ListOfShape occtUnchangedMembers;
+		if (rkOptions.broadPhase && (GetType() == TOPOLOGY_CLUSTER || kpOtherTopology->GetType() == TOPOLOGY_CLUSTER))
+		{
+			TopTools_ListOfShape occtOverlappingMembersA;
+			TopTools_ListOfShape occtDisjointMembersA;
+			TopTools_ListOfShape occtOverlappingMembersB;
+			TopTools_ListOfShape occtDisjointMembersB;
+			PartitionBooleanOperands(
+				GetOcctShape(), kpOtherTopology->GetOcctShape(), rkOptions,
+				occtOverlappingMembersA, occtDisjointMembersA,
+				occtOverlappingMembersB, occtDisjointMembersB);
+
+			// Disjoint members of A are only discarded by Intersect; those of B are kept where B's outside parts are.
+			const bool kKeepsDisjointMembersA = kOperationType != BOOLEAN_INTERSECT;
+			const bool kKeepsDisjointMembersB = kOperationType == BOOLEAN_IMPOSE || kOperationType == BOOLEAN_MERGE ||
+				kOperationType == BOOLEAN_UNION || kOperationType == BOOLEAN_XOR;
+			if (!occtDisjointMembersA.IsEmpty() && !occtOverlappingMembersA.IsEmpty())
+			{
+				pOperandA = Topology::ByOcctShape(MakeBooleanResultCompound(TopoDS_Shape(), occtOverlappingMembersA), "");
+			}
+			if (!occtDisjointMembersB.IsEmpty() && !occtOverlappingMembersB.IsEmpty())
+			{
+				pOperandB = Topology::ByOcctShape(MakeBooleanResultCompound(TopoDS_Shape(), occtOverlappingMembersB), "");
+			}
+
+			// Append() moves the members out of the disjoint lists.
+			if (kKeepsDisjointMembersA)
+			{
+				occtUnchangedMembers.Append(occtDisjointMembersA);
+			}
+			if (kKeepsDisjointMembersB)
+			{
+				occtUnchangedMembers.Append(occtDisjointMembersB);
+			}
+
+			if (occtOverlappingMembersA.IsEmpty() || occtOverlappingMembersB.IsEmpty())
+			{
+				if (occtUnchangedMembers.IsEmpty())
+				{
+					return nullptr;
+				}
+
+				TopoDS_Shape occtUnchangedShape = MakeBooleanResultCompound(TopoDS_Shape(), occtUnchangedMembers);
+				if (kTransferDictionary)
+				{
+					TransferOperandDictionaries(kpOtherTopology, kOperationType, occtUnchangedShape);
+				}
+				if (pImageIndices != nullptr)
+				{
+					TopTools_IndexedMapOfShape occtDestinationSubshapes;
+					TopExp::MapShapes(occtUnchangedShape, occtDestinationSubshapes);
+					const int kNumOfSubshapesA = RecordBooleanImages<BOPAlgo_CellsBuilder>(
+						nullptr, GetOcctShape(), TopTools_DataMapOfShapeShape(), occtDestinationSubshapes, 0, *pImageIndices);
+					RecordBooleanImages<BOPAlgo_CellsBuilder>(
+						nullptr, kpOtherTopology->GetOcctShape(), TopTools_DataMapOfShapeShape(), occtDestinationSubshapes, kNumOfSubshapesA, *pImageIndices);
+				}
+				return Topology::ByOcctShape(occtUnchangedShape, "");
+			}
+		}
+
+		BOPAlgo_CellsBuilder occtCellsBuilder;
+		TopTools_ListOfShape occtCellsBuildersOperandsA;
+		TopTools_ListOfShape occtCellsBuildersOperandsB;
+		TopTools_DataMapOfShapeShape occtMapFaceToFixedFaceA;
+		TopTools_DataMapOfShapeShape occtMapFaceToFixedFaceB;
+		try
+		{
+			pOperandA->NonRegularBooleanOperation(
+				pOperandB, rkOptions, occtCellsBuilder,
+				occtCellsBuildersOperandsA, occtCellsBuildersOperandsB,
+				occtMapFaceToFixedFaceA, occtMapFaceToFixedFaceB);
+			SelectBooleanResult(kOperationType, occtCellsBuildersOperandsA, occtCellsBuildersOperandsB, occtCellsBuilder);
+		}
+		catch (Standard_Failure& e)
+		{
+			throw std::runtime_error(e.GetMessageString());
+		}
+
+		TopoDS_Shape occtResultShape = occtCellsBuilder.Shape();
+		if (occtResultShape.IsNull() && occtUnchangedMembers.IsEmpty())
+		{
+			return nullptr;
+		}
+
+		TopoDS_Shape occtPostprocessedShape;
+		if (!occtResultShape.IsNull())
+		{
+			occtPostprocessedShape = PostprocessBooleanResult(occtResultShape);
+			if (kTransferDictionary)
+			{
+				TransferDictionaries(occtCellsBuilder, pOperandA->GetOcctShape(), occtMapFaceToFixedFaceA, occtPostprocessedShape);
+				TransferDictionaries(occtCellsBuilder, pOperandB->GetOcctShape(), occtMapFaceToFixedFaceB, occtPostprocessedShape);
+			}
+		}
+
+		if (!occtUnchangedMembers.IsEmpty())
+		{
+			occtPostprocessedShape = MakeBooleanResultCompound(occtPostprocessedShape, occtUnchangedMembers);
+		}
+		if (kTransferDictionary)
+		{
+			TransferOperandDictionaries(kpOtherTopology, kOperationType, occtPostprocessedShape);
+		}
+
+		if (pImageIndices != nullptr)
+		{
+			// The members left out by the broad phase are not in the history, so they are their own images.
+			TopTools_IndexedMapOfShape occtDestinationSubshapes;
+			TopExp::MapShapes(occtPostprocessedShape, occtDestinationSubshapes);
+			const int kNumOfSubshapesA = RecordBooleanImages(
+				&occtCellsBuilder, GetOcctShape(), occtMapFaceToFixedFaceA, occtDestinationSubshapes, 0, *pImageIndices);
+			RecordBooleanImages(
+				&occtCellsBuilder, kpOtherTopology->GetOcctShape(), occtMapFaceToFixedFaceB, occtDestinationSubshapes, kNumOfSubshapesA, *pImageIndices);
+		}
+		return Topology::ByOcctShape(occtPostprocessedShape, "");
+	}
+
+	inline Topology::Ptr Topology::MakeCachedBooleanResult(
+		const Topology::Ptr& kpOtherTopology,
+		const BooleanOperationType kOperationType,
+		const TopoDS_Shape& rkOcctCachedResult,
+		const BooleanCache::ImageIndices& rkImageIndices,
+		const bool kTransferDictionary)
+	{
+		if (rkOcctCachedResult.IsNull())
+		{
+			return nullptr;
+		}
+
+		// The cached shape is copied so that the results of different calls do not share dictionaries.
+		BRepBuilderAPI_Copy occtCopy(rkOcctCachedResult);
+		if (kTransferDictionary)
+		{
+			TopTools_IndexedMapOfShape occtOriginSubshapesA;
+			TopTools_IndexedMapOfShape occtOriginSubshapesB;
+			TopTools_IndexedMapOfShape occtCachedSubshapes;
+			TopExp::MapShapes(GetOcctShape(), occtOriginSubshapesA);
+			TopExp::MapShapes(kpOtherTopology->GetOcctShape(), occtOriginSubshapesB);
+			TopExp::MapShapes(rkOcctCachedResult, occtCachedSubshapes);
+
+			AttributeManager& rAttributeManager = AttributeManager::GetInstance();
+			const int kNumOfSubshapesA = occtOriginSubshapesA.Extent();
+			for (const std::pair<int, int>& rkImageIndex : rkImageIndices)
+			{
+				if (rkImageIndex.first < 1 || rkImageIndex.first > kNumOfSubshapesA + occtOriginSubshapesB.Extent() ||
+					rkImageIndex.second < 1 || rkImageIndex.second > occtCachedSubshapes.Extent())
+				{
+					continue;
+				}
+
+				const TopoDS_Shape& rkOcctOriginSubshape = rkImageIndex.first <= kNumOfSubshapesA ?
+					occtOriginSubshapesA(rkImageIndex.first) : occtOriginSubshapesB(rkImageIndex.first - kNumOfSubshapesA);
+				AttributeManager::AttributeMap attributes;
+				if (rAttributeManager.FindAll(rkOcctOriginSubshape, attributes))
+				{
+					rAttributeManager.CopyAttributes(rkOcctOriginSubshape, occtCopy.ModifiedShape(occtCachedSubshapes(rkImageIndex.second)));
+				}
+			}
+			TransferOperandDictionaries(kpOtherTopology, kOperationType, occtCopy.Shape());
+		}
+		return Topology::ByOcctShape(occtCopy.Shape(), "");
+	}
+
+	inline void Topology::PartitionBooleanOperands(
+		const TopoDS_Shape& rkOcctShapeA,
+		const TopoDS_Shape& rkOcctShapeB,
+		const BooleanOptions& rkOptions,
+		TopTools_ListOfShape& rOcctOverlappingMembersA,
+		TopTools_ListOfShape& rOcctDisjointMembersA,
+		TopTools_ListOfShape& rOcctOverlappingMembersB,
+		TopTools_ListOfShape& rOcctDisjointMembersB)
+	{
+		std::vector<TopoDS_Shape> occtMembersA;
+		std::vector<TopoDS_Shape> occtMembersB;
+		for (int i = 0; i < 2; ++i)
+		{
+			const TopoDS_Shape& rkOcctShape = i == 0 ? rkOcctShapeA : rkOcctShapeB;
+			std::vector<TopoDS_Shape>& rOcctMembers = i == 0 ? occtMembersA : occtMembersB;
+			if (rkOcctShape.ShapeType() == TopAbs_COMPOUND)
+			{
+				TopTools_ListOfShape occtMembers;
+				Members(rkOcctShape, occtMembers);
+				for (TopTools_ListIteratorOfListOfShape occtMemberIterator(occtMembers); occtMemberIterator.More(); occtMemberIterator.Next())
+				{
+					rOcctMembers.push_back(occtMemberIterator.Value());
+				}
+			}
+			else
+			{
+				rOcctMembers.push_back(rkOcctShape);
+			}
+		}
+
+		if (occtMembersA.empty() || occtMembersB.empty())
+		{
+			for (const TopoDS_Shape& rkOcctMember : occtMembersA)
+			{
+				rOcctDisjointMembersA.Append(rkOcctMember);
+			}
+			for (const TopoDS_Shape& rkOcctMember : occtMembersB)
+			{
+				rOcctDisjointMembersB.Append(rkOcctMember);
+			}
+			return;
+		}
+
+		BoundingBoxCache& rBoundingBoxCache = BoundingBoxCache::GetThreadInstance();
+		Handle(Bnd_HArray1OfBox) pOcctBoxesB = new Bnd_HArray1OfBox(1, (int)occtMembersB.size());
+		Bnd_Box occtCompleteBoxB;
+		for (int i = 0; i < (int)occtMembersB.size(); ++i)
+		{
+			Bnd_Box occtBox = rBoundingBoxCache.AxisAlignedBox(occtMembersB[i]);
+			occtBox.Enlarge(rkOptions.fuzzyValue);
+			pOcctBoxesB->SetValue(i + 1, occtBox);
+			occtCompleteBoxB.Add(occtBox);
+		}
+
+		Bnd_BoundSortBox occtBoundSortBox;
+		occtBoundSortBox.Initialize(occtCompleteBoxB, pOcctBoxesB);
+
+		std::vector<bool> isOverlappingB(occtMembersB.size(), false);
+		for (const TopoDS_Shape& rkOcctMemberA : occtMembersA)
+		{
+			Bnd_Box occtBoxA = rBoundingBoxCache.AxisAlignedBox(rkOcctMemberA);
+			occtBoxA.Enlarge(rkOptions.fuzzyValue);
+
+			bool isOverlappingA = false;
+			const TColStd_ListOfInteger& rkCandidateIndices = occtBoundSortBox.Compare(occtBoxA);
+			if (!rkCandidateIndices.IsEmpty() && rkOptions.useOBB)
+			{
+				Bnd_OBB occtOrientedBoxA = rBoundingBoxCache.OrientedBox(rkOcctMemberA);
+				occtOrientedBoxA.Enlarge(rkOptions.fuzzyValue);
+				for (TColStd_ListOfInteger::Iterator occtIndexIterator(rkCandidateIndices); occtIndexIterator.More(); occtIndexIterator.Next())
+				{
+					const int kIndexB = occtIndexIterator.Value() - 1;
+					if (!occtOrientedBoxA.IsOut(rBoundingBoxCache.OrientedBox(occtMembersB[kIndexB])))
+					{
+						isOverlappingA = true;
+						isOverlappingB[kIndexB] = true;
+					}
+				}
+			}
+			else
+			{
+				for (TColStd_ListOfInteger::Iterator occtIndexIterator(rkCandidateIndices); occtIndexIterator.More(); occtIndexIterator.Next())
+				{
+					isOverlappingA = true;
+					isOverlappingB[occtIndexIterator.Value() - 1] = true;
+				}
+			}
+
+			(isOverlappingA ? rOcctOverlappingMembersA : rOcctDisjointMembersA).Append(rkOcctMemberA);
+		}
+
+		for (int i = 0; i < (int)occtMembersB.size(); ++i)
+		{
+			(isOverlappingB[i] ? rOcctOverlappingMembersB : rOcctDisjointMembersB).Append(occtMembersB[i]);
+		}
+	}
+
+	inline Topology::Ptr Topology::SelfMerge(const BooleanOptions& rkOptions, const int kNumOfPartitions)
+	{
+		static const int MIN_NUM_OF_MEMBERS_PER_PARTITION = 16;
+		BoundingBoxCache::Scope boundingBoxCacheScope;
+
+		TopTools_ListOfShape occtMembers;
+		if (GetOcctShape().ShapeType() == TopAbs_COMPOUND)
+		{
+			Members(GetOcctShape(), occtMembers);
+		}
+		else
+		{
+			occtMembers.Append(GetOcctShape());
+		}
+		const int kNumOfRequestedPartitions = kNumOfPartitions > 0 ? kNumOfPartitions : OSD_Parallel::NbLogicalProcessors();
+		const int kNumOfUsedPartitions = std::min(kNumOfRequestedPartitions, occtMembers.Extent() / MIN_NUM_OF_MEMBERS_PER_PARTITION);
+
+		std::vector<TopTools_ListOfShape> occtPartitions;
+		if (kNumOfUsedPartitions >= 2)
+		{
+			PartitionSpatially(occtMembers, kNumOfUsedPartitions, occtPartitions);
+
+			// If most members touch another partition, the interface pass would merge nearly everything a second time.
+			std::vector<TopoDS_Shape> occtPartitionedMembers;
+			std::vector<int> partitionIndices;
+			for (int i = 0; i < (int)occtPartitions.size(); ++i)
+			{
+				for (TopTools_ListIteratorOfListOfShape occtMemberIterator(occtPartitions[i]); occtMemberIterator.More(); occtMemberIterator.Next())
+				{
+					occtPartitionedMembers.push_back(occtMemberIterator.Value());
+					partitionIndices.push_back(i);
+				}
+			}
+			std::vector<bool> isOnInterface;
+			if (2 * FindInterfaceShapes(occtPartitionedMembers, partitionIndices, rkOptions.fuzzyValue, isOnInterface) > (int)occtPartitionedMembers.size())
+			{
+				occtPartitions.clear();
+			}
+		}
+
+		if (occtPartitions.empty())
+		{
+			try
+			{
+				return Topology::ByOcctShape(MergeConformally(occtMembers, rkOptions, ProgressToken::Start(rkOptions.progressToken)), "");
+			}
+			catch (Standard_Failure& e)
+			{
+				throw std::runtime_error(e.GetMessageString());
+			}
+		}
+
+		// 1. Self-merge the partitions in parallel, without containers: a container would span the whole partition and
+		// put all of it on the interface. Neighbouring partitions may share sub-shapes, which must not be modified concurrently.
+		BooleanOptions partitionOptions = rkOptions;
+		partitionOptions.nonDestructive = true;
+
+		// One step of the progress per partition, and one for the interfaces.
+		ProgressToken::Scope occtProgressScope(ProgressToken::Start(rkOptions.progressToken), "SelfMerge", (Standard_Real)occtPartitions.size() + 1.0);
+		std::vector<ProgressToken::Range> occtPartitionRanges;
+		for (size_t i = 0; i < occtPartitions.size(); ++i)
+		{
+			occtPartitionRanges.push_back(occtProgressScope.Next());
+		}
+
+		std::vector<TopoDS_Shape> occtPartitionResults(occtPartitions.size());
+		std::vector<std::string> errorMessages(occtPartitions.size());
+		OSD_Parallel::For(0, (int)occtPartitions.size(), [&](const int i)
+		{
+			try
+			{
+				occtPartitionResults[i] = MergeConformally(occtPartitions[i], partitionOptions, occtPartitionRanges[i], false);
+			}
+			catch (Standard_Failure& e)
+			{
+				errorMessages[i] = e.GetMessageString();
+			}
+			catch (std::exception& e)
+			{
+				errorMessages[i] = e.what();
+			}
+		});
+		for (const std::string& rkErrorMessage : errorMessages)
+		{
+			if (!rkErrorMessage.empty())
+			{
+				throw std::runtime_error(rkErrorMessage);
+			}
+		}
+
+		// 2. Find the parts whose bounding boxes overlap a part of another partition.
+		std::vector<TopoDS_Shape> occtParts;
+		std::vector<int> partitionIndices;
+		for (int i = 0; i < (int)occtPartitionResults.size(); ++i)
+		{
+			TopTools_ListOfShape occtPartitionParts;
+			if (occtPartitionResults[i].IsNull())
+			{
+				continue;
+			}
+			else if (occtPartitionResults[i].ShapeType() == TopAbs_COMPOUND)
+			{
+				Members(occtPartitionResults[i], occtPartitionParts);
+			}
+			else
+			{
+				occtPartitionParts.Append(occtPartitionResults[i]);
+			}
+
+			for (TopTools_ListIteratorOfListOfShape occtPartIterator(occtPartitionParts); occtPartIterator.More(); occtPartIterator.Next())
+			{
+				occtParts.push_back(occtPartIterator.Value());
+				partitionIndices.push_back(i);
+			}
+		}
+
+		if (occtParts.empty())
+		{
+			return nullptr;
+		}
+
+		std::vector<bool> isOnInterface;
+		FindInterfaceShapes(occtParts, partitionIndices, rkOptions.fuzzyValue, isOnInterface);
+
+		// 3. Merge the interface parts, add the other parts unchanged, and group them all into containers.
+		TopTools_ListOfShape occtInterfaceParts;
+		TopTools_ListOfShape occtMergedParts;
+		for (int i = 0; i < (int)occtParts.size(); ++i)
+		{
+			(isOnInterface[i] ? occtInterfaceParts : occtMergedParts).Append(occtParts[i]);
+		}
+
+		if (!occtInterfaceParts.IsEmpty())
+		{
+			TopoDS_Shape occtInterfaceResult;
+			try
+			{
+				occtInterfaceResult = MergeConformally(occtInterfaceParts, rkOptions, occtProgressScope.Next(), false);
+			}
+			catch (Standard_Failure& e)
+			{
+				throw std::runtime_error(e.GetMessageString());
+			}
+			for (TopoDS_Iterator occtPartIterator(occtInterfaceResult); occtPartIterator.More(); occtPartIterator.Next())
+			{
+				occtMergedParts.Append(occtPartIterator.Value());
+			}
+		}
+		return Topology::ByOcctShape(MakeContainers(occtMergedParts), "");
+	}
+
+	inline Topology::Ptr Topology::Slice(const std::list<Topology::Ptr>& rkTools, const BooleanOptions& rkOptions, const bool kTransferDictionary)
+	{
+		TopTools_ListOfShape occtToolArguments;
+		TopTools_ListOfShape occtTools;
+		TopTools_DataMapOfShapeShape occtMapShapeToFixedShape;
+		for (const Topology::Ptr& kpTool : rkTools)
+		{
+			if (kpTool != nullptr)
+			{
+				kpTool->AddBooleanArguments(occtToolArguments, occtMapShapeToFixedShape, rkOptions.fixValidOperands);
+				occtTools.Append(kpTool->GetOcctShape());
+			}
+		}
+		return SliceByArguments(occtToolArguments, occtMapShapeToFixedShape, occtTools, rkOptions, kTransferDictionary);
+	}
+
+	inline Topology::Ptr Topology::Slice(
+		const double kOriginX, const double kOriginY, const double kOriginZ,
+		const double kNormalX, const double kNormalY, const double kNormalZ,
+		const double kSpacing,
+		const BooleanOptions& rkOptions,
+		const bool kTransferDictionary)
+	{
+		if (kSpacing <= 0.0)
+		{
+			throw std::runtime_error("The spacing of the planes must be positive.");
+		}
+
+		const gp_Vec kOcctNormal(kNormalX, kNormalY, kNormalZ);
+		if (kOcctNormal.Magnitude() < gp::Resolution())
+		{
+			throw std::runtime_error("The normal of the planes is null.");
+		}
+		const gp_Dir kOcctDirection(kOcctNormal);
+		const gp_Pnt kOcctOrigin(kOriginX, kOriginY, kOriginZ);
+
+		// The exact box: the tolerances would move the outermost planes onto the bottom and top faces.
+		Bnd_Box occtBox;
+		BRepBndLib::AddOptimal(GetOcctShape(), occtBox, Standard_False, Standard_False);
+		if (occtBox.IsVoid())
+		{
+			return nullptr;
+		}
+
+		// The range of signed distances of the box corners from the origin along the normal.
+		double minX = 0.0, minY = 0.0, minZ = 0.0, maxX = 0.0, maxY = 0.0, maxZ = 0.0;
+		occtBox.Get(minX, minY, minZ, maxX, maxY, maxZ);
+		double minDistance = std::numeric_limits<double>::max();
+		double maxDistance = -std::numeric_limits<double>::max();
+		for (int i = 0; i < 8; ++i)
+		{
+			const gp_Pnt kOcctCorner(i & 1 ? maxX : minX, i & 2 ? maxY : minY, i & 4 ? maxZ : minZ);
+			const double kDistance = gp_Vec(kOcctOrigin, kOcctCorner).Dot(kOcctDirection);
+			minDistance = std::min(minDistance, kDistance);
+			maxDistance = std::max(maxDistance, kDistance);
+		}
+
+		static const double MAX_NUM_OF_PLANES = 10000.0;
+		if ((maxDistance - minDistance) / kSpacing > MAX_NUM_OF_PLANES)
+		{
+			throw std::runtime_error("The spacing of the planes is too small for the size of the topology.");
+		}
+
+		const gp_Pnt kOcctCentre(0.5 * (minX + maxX), 0.5 * (minY + maxY), 0.5 * (minZ + maxZ));
+		const double kCentreDistance = gp_Vec(kOcctOrigin, kOcctCentre).Dot(kOcctDirection);
+		const double kDiagonal = gp_Pnt(minX, minY, minZ).Distance(gp_Pnt(maxX, maxY, maxZ));
+		const double kTolerance = std::max(Precision::Confusion(), rkOptions.fuzzyValue);
+
+		TopTools_ListOfShape occtToolArguments;
+		for (double k = std::floor(minDistance / kSpacing) + 1.0; k * kSpacing < maxDistance - kTolerance; k += 1.0)
+		{
+			ProgressToken::ThrowIfCancelled(rkOptions.progressToken);
+			if (k * kSpacing <= minDistance + kTolerance)
+			{
+				continue;
+			}
+
+			// Each plane is bounded by a square centred on the projection of the box centre, twice as wide as the box
+			// diagonal, so it covers the box whatever its orientation.
+			const gp_Pnt kOcctPlaneCentre = kOcctCentre.Translated(gp_Vec(kOcctDirection) * (k * kSpacing - kCentreDistance));
+			occtToolArguments.Append(BRepBuilderAPI_MakeFace(gp_Pln(kOcctPlaneCentre, kOcctDirection), -kDiagonal, kDiagonal, -kDiagonal, kDiagonal).Face());
+		}
+
+		TopTools_DataMapOfShapeShape occtMapShapeToFixedShape;
+		return SliceByArguments(occtToolArguments, occtMapShapeToFixedShape, TopTools_ListOfShape(), rkOptions, kTransferDictionary);
+	}
+
+	inline Topology::Ptr Topology::SliceByArguments(
+		const TopTools_ListOfShape& rkOcctToolArguments,
+		TopTools_DataMapOfShapeShape& rOcctMapShapeToFixedShape,
+		const TopTools_ListOfShape& rkOcctTools,
+		const BooleanOptions& rkOptions,
+		const bool kTransferDictionary)
+	{
+		TopTools_ListOfShape occtArguments;
+		AddBooleanArguments(occtArguments, rOcctMapShapeToFixedShape, rkOptions.fixValidOperands);
+
+		BOPAlgo_CellsBuilder occtCellsBuilder;
+		try
+		{
+			NonRegularBooleanOperation(occtArguments, rkOcctToolArguments, rkOptions, occtCellsBuilder);
+			SelectBooleanResult(BOOLEAN_SLICE, occtArguments, rkOcctToolArguments, occtCellsBuilder);
+		}
+		catch (Standard_Failure& e)
+		{
+			throw std::runtime_error(e.GetMessageString());
+		}
+
+		TopoDS_Shape occtResultShape = occtCellsBuilder.Shape();
+		if (occtResultShape.IsNull())
+		{
+			return nullptr;
+		}
+
+		TopoDS_Shape occtPostprocessedShape = PostprocessBooleanResult(occtResultShape);
+		if (kTransferDictionary)
+		{
+			TransferDictionaries(occtCellsBuilder, GetOcctShape(), rOcctMapShapeToFixedShape, occtPostprocessedShape);
+			TransferOperandDictionary(GetOcctShape(), occtPostprocessedShape);
+			for (TopTools_ListIteratorOfListOfShape occtToolIterator(rkOcctTools); occtToolIterator.More(); occtToolIterator.Next())
+			{
+				TransferDictionaries(occtCellsBuilder, occtToolIterator.Value(), rOcctMapShapeToFixedShape, occtPostprocessedShape);
+			}
+		}
+		return Topology::ByOcctShape(occtPostprocessedShape, "");
+	}
+
+	inline Topology::Ptr Topology::DivideBySlice(const Topology::Ptr& kpSlicedTopology)
+	{
+		Topology::Ptr pCopyTopology = ShallowCopy();
+		if (kpSlicedTopology == nullptr)
+		{
+			return pCopyTopology;
+		}
+
+		// The parts are the members of a sliced Cluster, or the sub-topologies of the type of this topology.
+		TopTools_ListOfShape occtParts;
+		const TopoDS_Shape& rkOcctSlicedShape = kpSlicedTopology->GetOcctShape();
+		TopAbs_ShapeEnum occtPartType = GetOcctShape().ShapeType();
+		if (occtPartType == TopAbs_COMPSOLID)
+		{
+			occtPartType = TopAbs_SOLID;
+		}
+		else if (occtPartType == TopAbs_SHELL)
+		{
+			occtPartType = TopAbs_FACE;
+		}
+		else if (occtPartType == TopAbs_WIRE)
+		{
+			occtPartType = TopAbs_EDGE;
+		}
+
+		if (occtPartType == TopAbs_COMPOUND)
+		{
+			Members(rkOcctSlicedShape, occtParts);
+		}
+		else
+		{
+			TopTools_MapOfShape occtVisitedParts;
+			for (TopExp_Explorer occtExplorer(rkOcctSlicedShape, occtPartType); occtExplorer.More(); occtExplorer.Next())
+			{
+				if (occtVisitedParts.Add(occtExplorer.Current()))
+				{
+					occtParts.Append(occtExplorer.Current());
+				}
+			}
+		}
+
+		std::vector<Topology::Ptr> parts;
+		for (TopTools_ListIteratorOfListOfShape occtPartIterator(occtParts); occtPartIterator.More(); occtPartIterator.Next())
+		{
+			parts.push_back(Topology::ByOcctShape(occtPartIterator.Value(), ""));
+		}
+
+		// Move the contents and apertures to the nearest part. Their context type is that of the sub-topology of this
+		// topology they were attached to; 0 for this topology itself.
+		if (!parts.empty())
+		{
+			TopTools_IndexedMapOfShape occtSubshapes;
+			TopExp::MapShapes(GetOcctShape(), occtSubshapes);
+
+			std::list<Topology::Ptr> subContents;
+			SubContents(subContents);
+			for (const Topology::Ptr& kpSubContent : subContents)
+			{
+				int contextType = 0;
+				std::list<Context::Ptr> contexts;
+				kpSubContent->Contexts(contexts);
+				for (const Context::Ptr& kpContext : contexts)
+				{
+					const Topology::Ptr kpContextTopology = kpContext->Topology();
+					if (kpContextTopology != nullptr && !kpContextTopology->GetOcctShape().IsSame(GetOcctShape()) &&
+						occtSubshapes.Contains(kpContextTopology->GetOcctShape()))
+					{
+						contextType = kpContextTopology->GetType();
+						break;
+					}
+				}
+
+				const TopoDS_Vertex occtCentre = CenterOfMass(kpSubContent->GetOcctShape());
+				size_t nearestPartIndex = 0;
+				double minDistance = std::numeric_limits<double>::max();
+				for (size_t i = 0; i < parts.size(); ++i)
+				{
+					BRepExtrema_DistShapeShape occtDistance(occtCentre, parts[i]->GetOcctShape());
+					if (occtDistance.IsDone() && occtDistance.Value() < minDistance)
+					{
+						minDistance = occtDistance.Value();
+						nearestPartIndex = i;
+					}
+				}
+				parts[nearestPartIndex] = parts[nearestPartIndex]->AddContent(kpSubContent, contextType);
+			}
+		}
+		return pCopyTopology->AddContents(std::list<Topology::Ptr>(parts.begin(), parts.end()), 0);
+	}
+
+	inline int Topology::FindInterfaceShapes(
+		const std::vector<TopoDS_Shape>& rkOcctShapes,
+		const std::vector<int>& rkPartitionIndices,
+		const double kFuzzyValue,
+		std::vector<bool>& rIsOnInterface)
+	{
+		rIsOnInterface.assign(rkOcctShapes.size(), false);
+		if (rkOcctShapes.empty())
+		{
+			return 0;
+		}
+
+		BoundingBoxCache& rBoundingBoxCache = BoundingBoxCache::GetThreadInstance();
+		Handle(Bnd_HArray1OfBox) pOcctBoxes = new Bnd_HArray1OfBox(1, (int)rkOcctShapes.size());
+		Bnd_Box occtCompleteBox;
+		for (int i = 0; i < (int)rkOcctShapes.size(); ++i)
+		{
+			Bnd_Box occtBox = rBoundingBoxCache.AxisAlignedBox(rkOcctShapes[i]);
+			occtBox.Enlarge(kFuzzyValue);
+			pOcctBoxes->SetValue(i + 1, occtBox);
+			occtCompleteBox.Add(occtBox);
+		}
+
+		Bnd_BoundSortBox occtBoundSortBox;
+		occtBoundSortBox.Initialize(occtCompleteBox, pOcctBoxes);
+		int numOfInterfaceShapes = 0;
+		for (int i = 0; i < (int)rkOcctShapes.size(); ++i)
+		{
+			const TColStd_ListOfInteger& rkCandidateIndices = occtBoundSortBox.Compare(pOcctBoxes->Value(i + 1));
+			for (TColStd_ListOfInteger::Iterator occtIndexIterator(rkCandidateIndices); occtIndexIterator.More(); occtIndexIterator.Next())
+			{
+				const int kCandidateIndex = occtIndexIterator.Value() - 1;
+				if (rkPartitionIndices[kCandidateIndex] != rkPartitionIndices[i])
+				{
+					if (!rIsOnInterface[i])
+					{
+						rIsOnInterface[i] = true;
+						++numOfInterfaceShapes;
+					}
+					if (!rIsOnInterface[kCandidateIndex])
+					{
+						rIsOnInterface[kCandidateIndex] = true;
+						++numOfInterfaceShapes;
+					}
+				}
+			}
+		}
+		return numOfInterfaceShapes;
+	}
+
+	inline void Topology::PartitionSpatially(const TopTools_ListOfShape& rkOcctShapes, const int kNumOfPartitions, std::vector<TopTools_ListOfShape>& rOcctPartitions)
+	{
+		struct Item
+		{
+			TopoDS_Shape occtShape;
+			double centre[3];
+		};
+
+		BoundingBoxCache& rBoundingBoxCache = BoundingBoxCache::GetThreadInstance();
+		std::vector<Item> items;
+		for (TopTools_ListIteratorOfListOfShape occtShapeIterator(rkOcctShapes); occtShapeIterator.More(); occtShapeIterator.Next())
+		{
+			Item item;
+			item.occtShape = occtShapeIterator.Value();
+			item.centre[0] = item.centre[1] = item.centre[2] = 0.0;
+			const Bnd_Box occtBox = rBoundingBoxCache.AxisAlignedBox(item.occtShape);
+			if (!occtBox.IsVoid())
+			{
+				double minX = 0.0, minY = 0.0, minZ = 0.0, maxX = 0.0, maxY = 0.0, maxZ = 0.0;
+				occtBox.Get(minX, minY, minZ, maxX, maxY, maxZ);
+				item.centre[0] = 0.5 * (minX + maxX);
+				item.centre[1] = 0.5 * (minY + maxY);
+				item.centre[2] = 0.5 * (minZ + maxZ);
+			}
+			items.push_back(item);
+		}
+
+		// Each range of items is cut into two ranges holding a number of items proportional to their number of partitions.
+		struct Range
+		{
+			size_t begin;
+			size_t end;
+			int numOfPartitions;
+		};
+		std::vector<Range> ranges;
+		ranges.push_back(Range{ 0, items.size(), std::max(kNumOfPartitions, 1) });
+		while (!ranges.empty())
+		{
+			const Range kRange = ranges.back();
+			ranges.pop_back();
+			if (kRange.numOfPartitions == 1 || kRange.end - kRange.begin < 2)
+			{
+				TopTools_ListOfShape occtPartition;
+				for (size_t i = kRange.begin; i < kRange.end; ++i)
+				{
+					occtPartition.Append(items[i].occtShape);
+				}
+				rOcctPartitions.push_back(occtPartition);
+				continue;
+			}
+
+			double minCentre[3] = { items[kRange.begin].centre[0], items[kRange.begin].centre[1], items[kRange.begin].centre[2] };
+			double maxCentre[3] = { minCentre[0], minCentre[1], minCentre[2] };
+			for (size_t i = kRange.begin; i < kRange.end; ++i)
+			{
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					minCentre[axis] = std::min(minCentre[axis], items[i].centre[axis]);
+					maxCentre[axis] = std::max(maxCentre[axis], items[i].centre[axis]);
+				}
+			}
+			int longestAxis = 0;
+			for (int axis = 1; axis < 3; ++axis)
+			{
+				if (maxCentre[axis] - minCentre[axis] > maxCentre[longestAxis] - minCentre[longestAxis])
+				{
+					longestAxis = axis;
+				}
+			}
+
+			const int kNumOfLowerPartitions = kRange.numOfPartitions / 2;
+			const size_t kMiddle = kRange.begin + (kRange.end - kRange.begin) * kNumOfLowerPartitions / kRange.numOfPartitions;
+			std::nth_element(items.begin() + kRange.begin, items.begin() + kMiddle, items.begin() + kRange.end,
+				[longestAxis](const Item& rkItem1, const Item& rkItem2) { return rkItem1.centre[longestAxis] < rkItem2.centre[longestAxis]; });
+			ranges.push_back(Range{ kRange.begin, kMiddle, kNumOfLowerPartitions });
+			ranges.push_back(Range{ kMiddle, kRange.end, kRange.numOfPartitions - kNumOfLowerPartitions });
+		}
+	}
+
+	inline TopoDS_Shape Topology::MergeConformally(
+		const TopTools_ListOfShape& rkOcctShapes,
+		const BooleanOptions& rkOptions,
+		const ProgressToken::Range& rkOcctRange,
+		const bool kMakesContainers)
+	{
+		BOPAlgo_CellsBuilder occtCellsBuilder;
+		rkOptions.Apply(occtCellsBuilder);
+		occtCellsBuilder.SetArguments(rkOcctShapes);
+		ProgressToken::Perform(occtCellsBuilder, rkOcctRange);
+		ProgressToken::ThrowIfCancelled(rkOptions.progressToken);
+		if (occtCellsBuilder.HasErrors())
+		{
+			std::ostringstream errorStream;
+			occtCellsBuilder.DumpErrors(errorStream);
+			throw std::runtime_error(errorStream.str());
+		}
+
+		occtCellsBuilder.AddAllToResult();
+		if (kMakesContainers)
+		{
+			occtCellsBuilder.MakeContainers();
+		}
+		return occtCellsBuilder.Shape();
+	}
+
+	inline TopoDS_Shape Topology::MakeContainers(const TopTools_ListOfShape& rkOcctParts)
+	{
+		static const TopAbs_ShapeEnum kOcctElementTypes[] = { TopAbs_SOLID, TopAbs_FACE, TopAbs_EDGE };
+		static const TopAbs_ShapeEnum kOcctConnectionTypes[] = { TopAbs_FACE, TopAbs_EDGE, TopAbs_VERTEX };
+		static const TopAbs_ShapeEnum kOcctContainerTypes[] = { TopAbs_COMPSOLID, TopAbs_SHELL, TopAbs_WIRE };
+
+		BRep_Builder occtBuilder;
+		TopoDS_Compound occtResult;
+		occtBuilder.MakeCompound(occtResult);
+		for (int i = 0; i < 3; ++i)
+		{
+			TopoDS_Compound occtElements;
+			occtBuilder.MakeCompound(occtElements);
+			bool hasElements = false;
+			for (TopTools_ListIteratorOfListOfShape occtPartIterator(rkOcctParts); occtPartIterator.More(); occtPartIterator.Next())
+			{
+				if (occtPartIterator.Value().ShapeType() == kOcctElementTypes[i])
+				{
+					occtBuilder.Add(occtElements, occtPartIterator.Value());
+					hasElements = true;
+				}
+			}
+			if (!hasElements)
+			{
+				continue;
+			}
+
+			TopTools_ListOfShape occtBlocks;
+			BOPTools_AlgoTools::MakeConnexityBlocks(occtElements, kOcctConnectionTypes[i], kOcctElementTypes[i], occtBlocks);
+			for (TopTools_ListIteratorOfListOfShape occtBlockIterator(occtBlocks); occtBlockIterator.More(); occtBlockIterator.Next())
+			{
+				TopoDS_Shape occtContainer;
+				BOPTools_AlgoTools::MakeContainer(kOcctContainerTypes[i], occtContainer);
+				for (TopoDS_Iterator occtElementIterator(occtBlockIterator.Value()); occtElementIterator.More(); occtElementIterator.Next())
+				{
+					occtBuilder.Add(occtContainer, occtElementIterator.Value());
+				}
+				occtBuilder.Add(occtResult, occtContainer);
+			}
+		}
+
+		for (TopTools_ListIteratorOfListOfShape occtPartIterator(rkOcctParts); occtPartIterator.More(); occtPartIterator.Next())
+		{
+			if (occtPartIterator.Value().ShapeType() == TopAbs_VERTEX)
+			{
+				occtBuilder.Add(occtResult, occtPartIterator.Value());
+			}
+		}
+		return occtResult;
+	}
+
+	inline TopoDS_Shape Topology::MakeBooleanResultCompound(const TopoDS_Shape& rkOcctBooleanResult, const TopTools_ListOfShape& rkOcctUnchangedMembers)
+	{
+		TopTools_ListOfShape occtMembers;
+		if (!rkOcctBooleanResult.IsNull())
+		{
+			if (rkOcctBooleanResult.ShapeType() == TopAbs_COMPOUND)
+			{
+				Members(rkOcctBooleanResult, occtMembers);
+			}
+			else
+			{
+				occtMembers.Append(rkOcctBooleanResult);
+			}
+		}
+		for (TopTools_ListIteratorOfListOfShape occtMemberIterator(rkOcctUnchangedMembers); occtMemberIterator.More(); occtMemberIterator.Next())
+		{
+			occtMembers.Append(occtMemberIterator.Value());
+		}
+
+		if (occtMembers.Extent() == 1)
+		{
+			return occtMembers.First();
+		}
+
+		TopoDS_Compound occtCompound;
+		BRep_Builder occtBuilder;
+		occtBuilder.MakeCompound(occtCompound);
+		for (TopTools_ListIteratorOfListOfShape occtMemberIterator(occtMembers); occtMemberIterator.More(); occtMemberIterator.Next())
+		{
+			occtBuilder.Add(occtCompound, occtMemberIterator.Value());
+		}
+		return occtCompound;
+	}
+
+	inline Topology::Ptr Topology::BooleanOperation(
+		const std::list<Topology::Ptr>& rkTopologies,
+		const BooleanOperationType kOperationType,
+		const BooleanOptions& rkOptions,
+		const bool kTransferDictionary)
+	{
+		if (kOperationType != BOOLEAN_MERGE && kOperationType != BOOLEAN_UNION)
+		{
+			throw std::runtime_error("Only Merge and Union can be run on a list of topologies.");
+		}
+
+		// Null entries are skipped.
+		std::list<Topology::Ptr> topologies;
+		for (const Topology::Ptr& kpTopology : rkTopologies)
+		{
+			if (kpTopology != nullptr)
+			{
+				topologies.push_back(kpTopology);
+			}
+		}
+		if (topologies.empty())
+		{
+			return nullptr;
+		}
+
+		TopTools_ListOfShape occtArguments;
+		TopTools_DataMapOfShapeShape occtMapShapeToFixedShape;
+		for (const Topology::Ptr& kpTopology : topologies)
+		{
+			kpTopology->AddBooleanArguments(occtArguments, occtMapShapeToFixedShape, rkOptions.fixValidOperands);
+		}
+
+		BOPAlgo_CellsBuilder occtCellsBuilder;
+		try
+		{
+			NonRegularBooleanOperation(occtArguments, TopTools_ListOfShape(), rkOptions, occtCellsBuilder);
+			SelectBooleanResult(kOperationType, occtArguments, TopTools_ListOfShape(), occtCellsBuilder);
+		}
+		catch (Standard_Failure& e)
+		{
+			throw std::runtime_error(e.GetMessageString());
+		}
+
+		TopoDS_Shape occtResultShape = occtCellsBuilder.Shape();
+		if (occtResultShape.IsNull())
+		{
+			return nullptr;
+		}
+
+		TopoDS_Shape occtPostprocessedShape = topologies.front()->PostprocessBooleanResult(occtResultShape);
+		if (kTransferDictionary)
+		{
+			for (const Topology::Ptr& kpTopology : topologies)
+			{
+				TransferDictionaries(occtCellsBuilder, kpTopology->GetOcctShape(), occtMapShapeToFixedShape, occtPostprocessedShape);
+				TransferOperandDictionary(kpTopology->GetOcctShape(), occtPostprocessedShape);
+			}
+		}
+		return Topology::ByOcctShape(occtPostprocessedShape, "");
+	}
+
+	inline void Topology::AddBooleanArguments(TopTools_ListOfShape& rOcctArguments, TopTools_DataMapOfShapeShape& rOcctMapShapeToFixedShape, const bool kFixesValidShapes)
+	{
+		TopTools_ListOfShape occtShapes;
+		BooleanArgumentShapes(GetOcctShape(), occtShapes);
+		for (TopTools_ListIteratorOfListOfShape occtShapeIterator(occtShapes); occtShapeIterator.More(); occtShapeIterator.Next())
+		{
+			const TopoDS_Shape& rkOcctArgument = occtShapeIterator.Value();
+			TopoDS_Shape occtFixedArgument;
+			if (!kFixesValidShapes && ShapeValidityCache::GetInstance().IsValid(rkOcctArgument))
+			{
+				rOcctArguments.Append(rkOcctArgument);
+				continue;
+			}
+
+			switch (rkOcctArgument.ShapeType())
+			{
+			case TopAbs_SOLID:
+				occtFixedArgument = FixBooleanOperandCell(rkOcctArgument);
+				break;
+			case TopAbs_SHELL:
+				occtFixedArgument = FixBooleanOperandShell(rkOcctArgument);
+				break;
+			case TopAbs_FACE:
+				occtFixedArgument = FixBooleanOperandFace(rkOcctArgument, rOcctMapShapeToFixedShape);
+				break;
+			default:
+				occtFixedArgument = rkOcctArgument;
+			}
+
+			if (!occtFixedArgument.IsSame(rkOcctArgument))
+			{
+				rOcctMapShapeToFixedShape.Bind(rkOcctArgument, occtFixedArgument);
+			}
+			rOcctArguments.Append(occtFixedArgument);
+		}
+	}
+
+	inline void Topology::BooleanArgumentShapes(const TopoDS_Shape& rkOcctShape, TopTools_ListOfShape& rOcctArgumentShapes)
+	{
+		if (rkOcctShape.ShapeType() == TopAbs_COMPOUND)
+		{
+			Members(rkOcctShape, rOcctArgumentShapes);
+		}
+		else if (rkOcctShape.ShapeType() == TopAbs_COMPSOLID)
+		{
+			for (TopExp_Explorer occtExplorer(rkOcctShape, TopAbs_SOLID); occtExplorer.More(); occtExplorer.Next())
+			{
+				rOcctArgumentShapes.Append(occtExplorer.Current());
+			}
+		}
+		else
+		{
+			rOcctArgumentShapes.Append(rkOcctShape);
+		}
+	}
+
+	inline void Topology::MapFixedBooleanArguments(const TopoDS_Shape& rkOcctShape, const TopTools_ListOfShape& rkOcctFixedArguments, TopTools_DataMapOfShapeShape& rOcctMapShapeToFixedShape)
+	{
+		TopTools_ListOfShape occtArgumentShapes;
+		BooleanArgumentShapes(rkOcctShape, occtArgumentShapes);
+		if (occtArgumentShapes.Extent() != rkOcctFixedArguments.Extent())
+		{
+			return;
+		}
+
+		TopTools_ListIteratorOfListOfShape occtFixedArgumentIterator(rkOcctFixedArguments);
+		for (TopTools_ListIteratorOfListOfShape occtArgumentIterator(occtArgumentShapes); occtArgumentIterator.More(); occtArgumentIterator.Next(), occtFixedArgumentIterator.Next())
+		{
+			const TopoDS_Shape& rkOcctArgument = occtArgumentIterator.Value();
+			const TopoDS_Shape& rkOcctFixedArgument = occtFixedArgumentIterator.Value();
+			if (rkOcctArgument.ShapeType() == rkOcctFixedArgument.ShapeType() && !rkOcctArgument.IsSame(rkOcctFixedArgument) &&
+				!rOcctMapShapeToFixedShape.IsBound(rkOcctArgument))
+			{
+				rOcctMapShapeToFixedShape.Bind(rkOcctArgument, rkOcctFixedArgument);
+			}
+		}
+	}
+
+	inline void Topology::TransferOperandDictionary(const TopoDS_Shape& rkOcctOriginShape, const TopoDS_Shape& rkOcctDestinationShape)
+	{
+		if (rkOcctDestinationShape.IsNull() || rkOcctOriginShape.ShapeType() != rkOcctDestinationShape.ShapeType() || rkOcctOriginShape.IsSame(rkOcctDestinationShape))
+		{
+			return;
+		}
+
+		AttributeManager& rAttributeManager = AttributeManager::GetInstance();
+		AttributeManager::AttributeMap originAttributes;
+		if (rAttributeManager.FindAll(rkOcctOriginShape, originAttributes))
+		{
+			rAttributeManager.CopyAttributes(rkOcctOriginShape, rkOcctDestinationShape);
+		}
+	}
+
+	inline void Topology::TransferOperandDictionaries(const Topology::Ptr& kpOtherTopology, const BooleanOperationType kOperationType, const TopoDS_Shape& rkOcctDestinationShape) const
+	{
+		if (kOperationType != BOOLEAN_DIFFERENCE)
+		{
+			TransferOperandDictionary(kpOtherTopology->GetOcctShape(), rkOcctDestinationShape);
+		}
+		TransferOperandDictionary(GetOcctShape(), rkOcctDestinationShape);
+	}
+
+	template <class OcctHistory>
+	void Topology::TransferDictionaries(
+		OcctHistory& rOcctHistory,
+		const TopoDS_Shape& rkOcctOriginShape,
+		const TopTools_DataMapOfShapeShape& rkOcctMapShapeToFixedShape,
+		const TopoDS_Shape& rkOcctDestinationShape)
+	{
+		AttributeManager& rAttributeManager = AttributeManager::GetInstance();
+		AttributeManager::ShapeToAttributesMap occtShapesToAttributesMap;
+		rAttributeManager.GetAttributesInSubshapes(rkOcctOriginShape, occtShapesToAttributesMap);
+		AttributeManager::AttributeMap originAttributes;
+		if (rAttributeManager.FindAll(rkOcctOriginShape, originAttributes))
+		{
+			occtShapesToAttributesMap.insert(std::make_pair(rkOcctOriginShape, originAttributes));
+		}
+
+		if (occtShapesToAttributesMap.empty())
+		{
+			return;
+		}
+
+		TopTools_IndexedMapOfShape occtDestinationSubshapes;
+		TopExp::MapShapes(rkOcctDestinationShape, occtDestinationSubshapes);
+
+		TopTools_ListOfShape occtImages;
+		for (const auto& rkShapeAttributesPair : occtShapesToAttributesMap)
+		{
+			const TopoDS_Shape& rkOcctOriginSubshape = rkShapeAttributesPair.first;
+			if (!BooleanImages(&rOcctHistory, rkOcctOriginSubshape, rkOcctMapShapeToFixedShape, occtImages))
+			{
+				continue;
+			}
+
+			for (TopTools_ListIteratorOfListOfShape occtImageIterator(occtImages); occtImageIterator.More(); occtImageIterator.Next())
+			{
+				const TopoDS_Shape& rkOcctImage = occtImageIterator.Value();
+				if (!rkOcctImage.IsSame(rkOcctOriginSubshape) && occtDestinationSubshapes.Contains(rkOcctImage))
+				{
+					rAttributeManager.CopyAttributes(rkOcctOriginSubshape, rkOcctImage);
+				}
+			}
+		}
+	}
+
+	template <class OcctHistory>
+	int Topology::RecordBooleanImages(
+		OcctHistory* pOcctHistory,
+		const TopoDS_Shape& rkOcctOriginShape,
+		const TopTools_DataMapOfShapeShape& rkOcctMapShapeToFixedShape,
+		const TopTools_IndexedMapOfShape& rkOcctDestinationSubshapes,
+		const int kOffset,
+		BooleanCache::ImageIndices& rImageIndices)
+	{
+		TopTools_IndexedMapOfShape occtOriginSubshapes;
+		TopExp::MapShapes(rkOcctOriginShape, occtOriginSubshapes);
+
+		TopTools_ListOfShape occtImages;
+		for (int i = 1; i <= occtOriginSubshapes.Extent(); ++i)
+		{
+			if (!BooleanImages(pOcctHistory, occtOriginSubshapes(i), rkOcctMapShapeToFixedShape, occtImages))
+			{
+				continue;
+			}
+
+			for (TopTools_ListIteratorOfListOfShape occtImageIterator(occtImages); occtImageIterator.More(); occtImageIterator.Next())
+			{
+				const int kDestinationIndex = rkOcctDestinationSubshapes.FindIndex(occtImageIterator.Value());
+				if (kDestinationIndex > 0)
+				{
+					rImageIndices.push_back(std::make_pair(kOffset + i, kDestinationIndex));
+				}
+			}
+		}
+		return occtOriginSubshapes.Extent();
+	}
+
+	template <class OcctHistory>
+	bool Topology::BooleanImages(
+		OcctHistory* pOcctHistory,
+		const TopoDS_Shape& rkOcctOriginSubshape,
+		const TopTools_DataMapOfShapeShape& rkOcctMapShapeToFixedShape,
+		TopTools_ListOfShape& rOcctImages)
+	{
+		rOcctImages.Clear();
+		const TopoDS_Shape* kpOcctFixedSubshape = rkOcctMapShapeToFixedShape.Seek(rkOcctOriginSubshape);
+		const TopoDS_Shape& rkOcctHistorySubshape = kpOcctFixedSubshape == nullptr ? rkOcctOriginSubshape : *kpOcctFixedSubshape;
+		if (pOcctHistory != nullptr)
+		{
+			if (pOcctHistory->IsDeleted(rkOcctHistorySubshape))
+			{
+				return false;
+			}
+
+			for (TopTools_ListIteratorOfListOfShape occtImageIterator(pOcctHistory->Modified(rkOcctHistorySubshape)); occtImageIterator.More(); occtImageIterator.Next())
+			{
+				rOcctImages.Append(occtImageIterator.Value());
+			}
+			for (TopTools_ListIteratorOfListOfShape occtImageIterator(pOcctHistory->Generated(rkOcctHistorySubshape)); occtImageIterator.More(); occtImageIterator.Next())
+			{
+				// Only shapes of the same type inherit, e.g. not the section edges generated from a face.
+				if (occtImageIterator.Value().ShapeType() == rkOcctOriginSubshape.ShapeType())
+				{
+					rOcctImages.Append(occtImageIterator.Value());
+				}
+			}
+		}
+
+		if (rOcctImages.IsEmpty())
+		{
+			rOcctImages.Append(rkOcctHistorySubshape);
+		}
+		return true;
+	}
+
+	inline void Topology::SelectBooleanResult(
+		const BooleanOperationType kOperationType,
+		const TopTools_ListOfShape& rkOcctArgumentsA,
+		const TopTools_ListOfShape& rkOcctArgumentsB,
+		BOPAlgo_CellsBuilder& rOcctCellsBuilder)
+	{
+		const TopTools_ListOfShape kOcctEmptyList;
+		TopTools_ListOfShape occtListToTake;
+
+		// The parts of each argument of A, minus B for the operations that avoid it.
+		const bool kIsBAvoided = kOperationType == BOOLEAN_DIFFERENCE || kOperationType == BOOLEAN_IMPOSE || kOperationType == BOOLEAN_XOR;
+		if (kOperationType != BOOLEAN_INTERSECT)
+		{
+			for (TopTools_ListIteratorOfListOfShape occtArgumentIteratorA(rkOcctArgumentsA); occtArgumentIteratorA.More(); occtArgumentIteratorA.Next())
+			{
+				occtListToTake.Clear();
+				occtListToTake.Append(occtArgumentIteratorA.Value());
+				rOcctCellsBuilder.AddToResult(occtListToTake, kIsBAvoided ? rkOcctArgumentsB : kOcctEmptyList, kOperationType == BOOLEAN_UNION ? 1 : 0);
+			}
+		}
+
+		// The parts of each argument of B, minus A for XOR.
+		if (kOperationType == BOOLEAN_IMPOSE || kOperationType == BOOLEAN_MERGE || kOperationType == BOOLEAN_UNION || kOperationType == BOOLEAN_XOR)
+		{
+			for (TopTools_ListIteratorOfListOfShape occtArgumentIteratorB(rkOcctArgumentsB); occtArgumentIteratorB.More(); occtArgumentIteratorB.Next())
+			{
+				occtListToTake.Clear();
+				occtListToTake.Append(occtArgumentIteratorB.Value());
+				rOcctCellsBuilder.AddToResult(occtListToTake, kOperationType == BOOLEAN_XOR ? rkOcctArgumentsA : kOcctEmptyList, kOperationType == BOOLEAN_UNION ? 1 : 0);
+			}
+		}
+
+		// The parts common to each pair of arguments.
+		if (kOperationType == BOOLEAN_INTERSECT)
+		{
+			for (TopTools_ListIteratorOfListOfShape occtArgumentIteratorA(rkOcctArgumentsA); occtArgumentIteratorA.More(); occtArgumentIteratorA.Next())
+			{
+				for (TopTools_ListIteratorOfListOfShape occtArgumentIteratorB(rkOcctArgumentsB); occtArgumentIteratorB.More(); occtArgumentIteratorB.Next())
+				{
+					occtListToTake.Clear();
+					occtListToTake.Append(occtArgumentIteratorA.Value());
+					occtListToTake.Append(occtArgumentIteratorB.Value());
+					rOcctCellsBuilder.AddToResult(occtListToTake, kOcctEmptyList);
+				}
+			}
+		}
+
+		if (kOperationType == BOOLEAN_UNION)
+		{
+			rOcctCellsBuilder.RemoveInternalBoundaries();
+		}
+		rOcctCellsBuilder.MakeContainers();
+	}
+
 	template <class Subclass>
 	//static TopAbs_ShapeEnum Topology::CheckOcctShapeType()
 	TopAbs_ShapeEnum Topology::CheckOcctShapeType()
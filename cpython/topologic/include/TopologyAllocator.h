@@ -0,0 +1,331 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+
+#include <TopoDS.hxx>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace TopologicCore
+{
+	class Vertex;
+	class Edge;
+	class Wire;
+	class Face;
+	class Shell;
+	class Cell;
+	class CellComplex;
+	class Cluster;
+
+	/// <summary>
+	/// Size-class pool for topology wrappers and their shared_ptr control blocks. Blocks are recycled through
+	/// per-size free lists instead of going back to the heap. Only the wrappers created by AllocateTopology, e.g. in
+	/// Topology::PooledNavigate, come from the pool; those created inside the compiled library, including by its
+	/// Navigate(), Edges(), Faces() and so on, are still allocated one by one.
+	/// </summary>
+	class TopologyPool
+	{
+	public:
+		/// <summary>
+		/// The pool is never destroyed, since wrappers held by other singletons (e.g. ContentManager) may be
+		/// released after static destruction has started.
+		/// </summary>
+		/// <returns></returns>
+		static TopologyPool& GetInstance()
+		{
+			static TopologyPool* pInstance = new TopologyPool();
+			return *pInstance;
+		}
+
+		void* Allocate(const size_t kSize)
+		{
+			if (kSize > MAX_POOLED_SIZE)
+			{
+				return ::operator new(kSize);
+			}
+
+			const size_t kSizeClass = SizeClass(kSize);
+			std::lock_guard<std::mutex> lock(m_mutex);
+			FreeBlock* pBlock = m_freeLists[kSizeClass];
+			if (pBlock == nullptr)
+			{
+				pBlock = AddChunk(kSizeClass);
+			}
+			m_freeLists[kSizeClass] = pBlock->pNext;
+			return pBlock;
+		}
+
+		void Deallocate(void* pMemory, const size_t kSize)
+		{
+			if (kSize > MAX_POOLED_SIZE)
+			{
+				::operator delete(pMemory);
+				return;
+			}
+
+			const size_t kSizeClass = SizeClass(kSize);
+			FreeBlock* pBlock = static_cast<FreeBlock*>(pMemory);
+			std::lock_guard<std::mutex> lock(m_mutex);
+			pBlock->pNext = m_freeLists[kSizeClass];
+			m_freeLists[kSizeClass] = pBlock;
+		}
+
+	protected:
+		static const size_t GRANULARITY = 16;
+		static const size_t MAX_POOLED_SIZE = 512;
+		static const size_t NUM_OF_BLOCKS_PER_CHUNK = 64;
+
+		struct FreeBlock
+		{
+			FreeBlock* pNext;
+		};
+
+		TopologyPool()
+		{
+			for (size_t i = 0; i < MAX_POOLED_SIZE / GRANULARITY; ++i)
+			{
+				m_freeLists[i] = nullptr;
+			}
+		}
+
+		static size_t SizeClass(const size_t kSize)
+		{
+			return kSize == 0 ? 0 : (kSize - 1) / GRANULARITY;
+		}
+
+		FreeBlock* AddChunk(const size_t kSizeClass)
+		{
+			const size_t kBlockSize = (kSizeClass + 1) * GRANULARITY;
+			char* pChunk = static_cast<char*>(::operator new(kBlockSize * NUM_OF_BLOCKS_PER_CHUNK));
+			m_chunks.push_back(pChunk);
+
+			FreeBlock* pHead = nullptr;
+			for (size_t i = NUM_OF_BLOCKS_PER_CHUNK; i > 0; --i)
+			{
+				FreeBlock* pBlock = reinterpret_cast<FreeBlock*>(pChunk + (i - 1) * kBlockSize);
+				pBlock->pNext = pHead;
+				pHead = pBlock;
+			}
+			return pHead;
+		}
+
+		std::mutex m_mutex;
+		FreeBlock* m_freeLists[MAX_POOLED_SIZE / GRANULARITY];
+		std::vector<char*> m_chunks;
+	};
+
+	/// <summary>
+	/// Bump allocator for the transient wrappers created during a bulk operation, e.g. a navigation or an export.
+	/// An arena is opened with a TopologyArena::Scope; while the scope is alive, wrappers created on the same thread
+	/// are allocated from the arena. All its memory is freed at once when the scope has ended and the last wrapper
+	/// allocated from it has been released, so wrappers escaping the scope remain valid.
+	/// </summary>
+	class TopologyArena
+	{
+	public:
+		class Scope
+		{
+		public:
+			Scope(const size_t kChunkSize = 65536)
+				: m_pArena(new TopologyArena(kChunkSize))
+				, m_pPreviousArena(Current())
+			{
+				Current() = m_pArena;
+			}
+
+			~Scope()
+			{
+				Current() = m_pPreviousArena;
+				m_pArena->Release();
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		protected:
+			TopologyArena* m_pArena;
+			TopologyArena* m_pPreviousArena;
+		};
+
+		/// <summary>
+		/// Returns the arena opened on the calling thread, or null if there is none.
+		/// </summary>
+		/// <returns></returns>
+		static TopologyArena*& Current()
+		{
+			static thread_local TopologyArena* pCurrentArena = nullptr;
+			return pCurrentArena;
+		}
+
+		void* Allocate(const size_t kSize)
+		{
+			const size_t kAlignedSize = (kSize + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+			if (m_pCurrent == nullptr || m_pCurrent + kAlignedSize > m_pEnd)
+			{
+				const size_t kChunkSize = kAlignedSize > m_chunkSize ? kAlignedSize : m_chunkSize;
+				m_pCurrent = static_cast<char*>(::operator new(kChunkSize));
+				m_pEnd = m_pCurrent + kChunkSize;
+				m_chunks.push_back(m_pCurrent);
+			}
+
+			void* pMemory = m_pCurrent;
+			m_pCurrent += kAlignedSize;
+			++m_numOfReferences;
+			return pMemory;
+		}
+
+		void Deallocate(void* /*pMemory*/, const size_t /*kSize*/)
+		{
+			Release();
+		}
+
+	protected:
+		static const size_t ALIGNMENT = alignof(std::max_align_t);
+
+		TopologyArena(const size_t kChunkSize)
+			: m_chunkSize(kChunkSize)
+			, m_pCurrent(nullptr)
+			, m_pEnd(nullptr)
+			, m_numOfReferences(1) // held by the scope
+		{
+		}
+
+		~TopologyArena()
+		{
+			for (char* pChunk : m_chunks)
+			{
+				::operator delete(pChunk);
+			}
+		}
+
+		void Release()
+		{
+			if (--m_numOfReferences == 0)
+			{
+				delete this;
+			}
+		}
+
+		size_t m_chunkSize;
+		char* m_pCurrent;
+		char* m_pEnd;
+		std::vector<char*> m_chunks;
+		std::atomic<size_t> m_numOfReferences;
+	};
+
+	/// <summary>
+	/// Standard allocator that takes memory from the arena open on the calling thread at construction time,
+	/// or from the TopologyPool otherwise. Used with std::allocate_shared so that the wrapper and its control block
+	/// share a single pooled block.
+	/// </summary>
+	template <class T>
+	class TopologyAllocator
+	{
+	public:
+		typedef T value_type;
+
+		TopologyAllocator() noexcept
+			: m_pArena(TopologyArena::Current())
+		{
+		}
+
+		template <class U>
+		TopologyAllocator(const TopologyAllocator<U>& rkAnotherAllocator) noexcept
+			: m_pArena(rkAnotherAllocator.m_pArena)
+		{
+		}
+
+		T* allocate(const size_t kNumOfObjects)
+		{
+			const size_t kSize = kNumOfObjects * sizeof(T);
+			void* pMemory = m_pArena != nullptr ? m_pArena->Allocate(kSize) : TopologyPool::GetInstance().Allocate(kSize);
+			return static_cast<T*>(pMemory);
+		}
+
+		void deallocate(T* pObjects, const size_t kNumOfObjects)
+		{
+			const size_t kSize = kNumOfObjects * sizeof(T);
+			if (m_pArena != nullptr)
+			{
+				m_pArena->Deallocate(pObjects, kSize);
+			}
+			else
+			{
+				TopologyPool::GetInstance().Deallocate(pObjects, kSize);
+			}
+		}
+
+		template <class U>
+		bool operator==(const TopologyAllocator<U>& rkAnotherAllocator) const
+		{
+			return m_pArena == rkAnotherAllocator.m_pArena;
+		}
+
+		template <class U>
+		bool operator!=(const TopologyAllocator<U>& rkAnotherAllocator) const
+		{
+			return m_pArena != rkAnotherAllocator.m_pArena;
+		}
+
+	protected:
+		template <class U> friend class TopologyAllocator;
+
+		TopologyArena* m_pArena;
+	};
+
+	/// <summary>
+	/// Maps a Topology subclass to the OCCT shape type its constructor takes.
+	/// </summary>
+	template <class Subclass> struct OcctShapeCast;
+
+	template <> struct OcctShapeCast<Vertex> { static const TopoDS_Vertex& Cast(const TopoDS_Shape& rkOcctShape) { return TopoDS::Vertex(rkOcctShape); } };
+	template <> struct OcctShapeCast<Edge> { static const TopoDS_Edge& Cast(const TopoDS_Shape& rkOcctShape) { return TopoDS::Edge(rkOcctShape); } };
+	template <> struct OcctShapeCast<Wire> { static const TopoDS_Wire& Cast(const TopoDS_Shape& rkOcctShape) { return TopoDS::Wire(rkOcctShape); } };
+	template <> struct OcctShapeCast<Face> { static const TopoDS_Face& Cast(const TopoDS_Shape& rkOcctShape) { return TopoDS::Face(rkOcctShape); } };
+	template <> struct OcctShapeCast<Shell> { static const TopoDS_Shell& Cast(const TopoDS_Shape& rkOcctShape) { return TopoDS::Shell(rkOcctShape); } };
+	template <> struct OcctShapeCast<Cell> { static const TopoDS_Solid& Cast(const TopoDS_Shape& rkOcctShape) { return TopoDS::Solid(rkOcctShape); } };
+	template <> struct OcctShapeCast<CellComplex> { static const TopoDS_CompSolid& Cast(const TopoDS_Shape& rkOcctShape) { return TopoDS::CompSolid(rkOcctShape); } };
+	template <> struct OcctShapeCast<Cluster> { static const TopoDS_Compound& Cast(const TopoDS_Shape& rkOcctShape) { return TopoDS::Compound(rkOcctShape); } };
+
+	/// <summary>
+	/// Creates a wrapper of the given subclass around rkOcctShape using the TopologyAllocator.
+	/// This is equivalent to Topology::ByOcctShape(rkOcctShape, "") when the subclass is known.
+	/// </summary>
+	/// <param name="rkOcctShape"></param>
+	/// <returns></returns>
+	template <class Subclass>
+	std::shared_ptr<Subclass> AllocateTopology(const TopoDS_Shape& rkOcctShape)
+	{
+		return std::allocate_shared<Subclass>(TopologyAllocator<Subclass>(), OcctShapeCast<Subclass>::Cast(rkOcctShape));
+	}
+
+	/// <summary>
+	/// The constructor of CellComplex is not exported from the library, so cell complexes are created through
+	/// Topology::ByOcctShape instead. Defined in CellComplex.h.
+	/// </summary>
+	/// <param name="rkOcctShape"></param>
+	/// <returns></returns>
+	template <>
+	inline std::shared_ptr<CellComplex> AllocateTopology<CellComplex>(const TopoDS_Shape& rkOcctShape);
+}
@@ -0,0 +1,372 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+#include "Topology.h"
+#include "AttributeManager.h"
+#include "IntAttribute.h"
+#include "DoubleAttribute.h"
+#include "StringAttribute.h"
+
+#include <BRepAdaptor_Surface.hxx>
+#include <BRepGProp.hxx>
+#include <GProp_GProps.hxx>
+#include <TopExp.hxx>
+#include <TopoDS.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <gp.hxx>
+#include <gp_Vec.hxx>
+
+#include <cmath>
+#include <functional>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// A filter pipeline evaluated on the OCCT shapes. Predicates are combined with AND and run in the order they
+	/// were added; only the topologies passing all of them are wrapped. Predicates that do not apply to a topology
+	/// type (e.g. Area on an edge) reject it.
+	/// </summary>
+	class TopologyFilter
+	{
+	public:
+		typedef std::shared_ptr<TopologyFilter> Ptr;
+		typedef std::function<bool(const TopoDS_Shape&)> OcctPredicate;
+		typedef std::function<bool(const Topology::Ptr&)> Predicate;
+
+	public:
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="kTypeFilter">A bitmask of TopologyType values</param>
+		TopologyFilter(const int kTypeFilter = TOPOLOGY_ALL)
+			: m_typeFilter(kTypeFilter)
+		{
+		}
+
+		/// <summary>
+		/// Keeps the faces whose area is in [kMinArea, kMaxArea].
+		/// </summary>
+		/// <param name="kMinArea"></param>
+		/// <param name="kMaxArea"></param>
+		/// <returns></returns>
+		TopologyFilter& Area(const double kMinArea, const double kMaxArea)
+		{
+			return Where([kMinArea, kMaxArea](const TopoDS_Shape& rkOcctShape)
+			{
+				if (rkOcctShape.ShapeType() != TopAbs_FACE && rkOcctShape.ShapeType() != TopAbs_SHELL)
+				{
+					return false;
+				}
+				GProp_GProps occtShapeProperties;
+				BRepGProp::SurfaceProperties(rkOcctShape, occtShapeProperties);
+				return occtShapeProperties.Mass() >= kMinArea && occtShapeProperties.Mass() <= kMaxArea;
+			});
+		}
+
+		/// <summary>
+		/// Keeps the edges and wires whose length is in [kMinLength, kMaxLength].
+		/// </summary>
+		/// <param name="kMinLength"></param>
+		/// <param name="kMaxLength"></param>
+		/// <returns></returns>
+		TopologyFilter& Length(const double kMinLength, const double kMaxLength)
+		{
+			return Where([kMinLength, kMaxLength](const TopoDS_Shape& rkOcctShape)
+			{
+				if (rkOcctShape.ShapeType() != TopAbs_EDGE && rkOcctShape.ShapeType() != TopAbs_WIRE)
+				{
+					return false;
+				}
+				GProp_GProps occtShapeProperties;
+				BRepGProp::LinearProperties(rkOcctShape, occtShapeProperties);
+				return occtShapeProperties.Mass() >= kMinLength && occtShapeProperties.Mass() <= kMaxLength;
+			});
+		}
+
+		/// <summary>
+		/// Keeps the cells and cell complexes whose volume is in [kMinVolume, kMaxVolume].
+		/// </summary>
+		/// <param name="kMinVolume"></param>
+		/// <param name="kMaxVolume"></param>
+		/// <returns></returns>
+		TopologyFilter& Volume(const double kMinVolume, const double kMaxVolume)
+		{
+			return Where([kMinVolume, kMaxVolume](const TopoDS_Shape& rkOcctShape)
+			{
+				if (rkOcctShape.ShapeType() != TopAbs_SOLID && rkOcctShape.ShapeType() != TopAbs_COMPSOLID)
+				{
+					return false;
+				}
+				GProp_GProps occtShapeProperties;
+				BRepGProp::VolumeProperties(rkOcctShape, occtShapeProperties);
+				return occtShapeProperties.Mass() >= kMinVolume && occtShapeProperties.Mass() <= kMaxVolume;
+			});
+		}
+
+		/// <summary>
+		/// Keeps the faces whose normal at the centre of their parametric domain deviates at most kMaxAngle degrees
+		/// from the given direction, e.g. (0, -1, 0) and 45 for south-facing faces. Throws if the direction is zero.
+		/// </summary>
+		/// <param name="kX"></param>
+		/// <param name="kY"></param>
+		/// <param name="kZ"></param>
+		/// <param name="kMaxAngle"></param>
+		/// <returns></returns>
+		TopologyFilter& Normal(const double kX, const double kY, const double kZ, const double kMaxAngle)
+		{
+			const gp_Vec kOcctDirection(kX, kY, kZ);
+			if (kOcctDirection.Magnitude() < gp::Resolution())
+			{
+				throw std::runtime_error("The direction is zero.");
+			}
+			const double kMaxAngleInRadians = kMaxAngle * std::acos(-1.0) / 180.0;
+			return Where([kOcctDirection, kMaxAngleInRadians](const TopoDS_Shape& rkOcctShape)
+			{
+				if (rkOcctShape.ShapeType() != TopAbs_FACE)
+				{
+					return false;
+				}
+				const TopoDS_Face& rkOcctFace = TopoDS::Face(rkOcctShape);
+				BRepAdaptor_Surface occtSurface(rkOcctFace);
+				double u = 0.5 * (occtSurface.FirstUParameter() + occtSurface.LastUParameter());
+				double v = 0.5 * (occtSurface.FirstVParameter() + occtSurface.LastVParameter());
+				gp_Pnt occtPoint;
+				gp_Vec occtDerivativeU, occtDerivativeV;
+				occtSurface.D1(u, v, occtPoint, occtDerivativeU, occtDerivativeV);
+				gp_Vec occtNormal = occtDerivativeU.Crossed(occtDerivativeV);
+				if (occtNormal.Magnitude() < gp::Resolution())
+				{
+					return false;
+				}
+				if (rkOcctFace.Orientation() == TopAbs_REVERSED)
+				{
+					occtNormal.Reverse();
+				}
+				return occtNormal.Angle(kOcctDirection) <= kMaxAngleInRadians;
+			});
+		}
+
+		/// <summary>
+		/// Keeps the topologies that have between kMinNumOfAncestors and kMaxNumOfAncestors ancestors of type
+		/// kAncestorType in kpHostTopology, e.g. the external faces of a CellComplex have one cell.
+		/// The ancestry is mapped once per topology type on first use, even if the host has no such ancestors.
+		/// </summary>
+		/// <param name="kpHostTopology"></param>
+		/// <param name="kAncestorType"></param>
+		/// <param name="kMinNumOfAncestors"></param>
+		/// <param name="kMaxNumOfAncestors"></param>
+		/// <returns></returns>
+		TopologyFilter& NumOfAncestors(
+			const Topology::Ptr& kpHostTopology,
+			const int kAncestorType,
+			const int kMinNumOfAncestors,
+			const int kMaxNumOfAncestors)
+		{
+			if (kpHostTopology == nullptr)
+			{
+				throw std::runtime_error("The host topology is null.");
+			}
+
+			const TopoDS_Shape kOcctHostShape = kpHostTopology->GetOcctShape();
+			const TopAbs_ShapeEnum kOcctAncestorType = Topology::GetOcctTopologyType((TopologyType)kAncestorType);
+			std::shared_ptr<std::vector<TopTools_IndexedDataMapOfShapeListOfShape>> pOcctAncestorMaps =
+				std::make_shared<std::vector<TopTools_IndexedDataMapOfShapeListOfShape>>(TopAbs_SHAPE);
+			std::shared_ptr<std::vector<bool>> pIsMapped = std::make_shared<std::vector<bool>>(TopAbs_SHAPE, false);
+			return Where([=](const TopoDS_Shape& rkOcctShape)
+			{
+				TopTools_IndexedDataMapOfShapeListOfShape& rOcctAncestorMap = (*pOcctAncestorMaps)[rkOcctShape.ShapeType()];
+				if (!(*pIsMapped)[rkOcctShape.ShapeType()])
+				{
+					TopExp::MapShapesAndUniqueAncestors(kOcctHostShape, rkOcctShape.ShapeType(), kOcctAncestorType, rOcctAncestorMap);
+					(*pIsMapped)[rkOcctShape.ShapeType()] = true;
+				}
+				const TopTools_ListOfShape* kpOcctAncestors = rOcctAncestorMap.Seek(rkOcctShape);
+				int numOfAncestors = kpOcctAncestors == nullptr ? 0 : kpOcctAncestors->Extent();
+				return numOfAncestors >= kMinNumOfAncestors && numOfAncestors <= kMaxNumOfAncestors;
+			});
+		}
+
+		/// <summary>
+		/// Keeps the topologies whose dictionary contains rkKey.
+		/// </summary>
+		/// <param name="rkKey"></param>
+		/// <returns></returns>
+		TopologyFilter& HasKey(const std::string& rkKey)
+		{
+			return Where([rkKey](const TopoDS_Shape& rkOcctShape)
+			{
+				return AttributeManager::GetInstance().Find(rkOcctShape, rkKey) != nullptr;
+			});
+		}
+
+		/// <summary>
+		/// Keeps the topologies whose int or double value at rkKey is in [kMinValue, kMaxValue].
+		/// </summary>
+		/// <param name="rkKey"></param>
+		/// <param name="kMinValue"></param>
+		/// <param name="kMaxValue"></param>
+		/// <returns></returns>
+		TopologyFilter& ValueInRange(const std::string& rkKey, const double kMinValue, const double kMaxValue)
+		{
+			return Where([rkKey, kMinValue, kMaxValue](const TopoDS_Shape& rkOcctShape)
+			{
+				Attribute::Ptr pAttribute = AttributeManager::GetInstance().Find(rkOcctShape, rkKey);
+				double value = 0.0;
+				if (std::shared_ptr<IntAttribute> pIntAttribute = std::dynamic_pointer_cast<IntAttribute>(pAttribute))
+				{
+					value = (double)pIntAttribute->IntValue();
+				}
+				else if (std::shared_ptr<DoubleAttribute> pDoubleAttribute = std::dynamic_pointer_cast<DoubleAttribute>(pAttribute))
+				{
+					value = pDoubleAttribute->DoubleValue();
+				}
+				else
+				{
+					return false;
+				}
+				return value >= kMinValue && value <= kMaxValue;
+			});
+		}
+
+		/// <summary>
+		/// Keeps the topologies whose string value at rkKey equals rkValue.
+		/// </summary>
+		/// <param name="rkKey"></param>
+		/// <param name="rkValue"></param>
+		/// <returns></returns>
+		TopologyFilter& ValueEquals(const std::string& rkKey, const std::string& rkValue)
+		{
+			return Where([rkKey, rkValue](const TopoDS_Shape& rkOcctShape)
+			{
+				std::shared_ptr<StringAttribute> pStringAttribute =
+					std::dynamic_pointer_cast<StringAttribute>(AttributeManager::GetInstance().Find(rkOcctShape, rkKey));
+				return pStringAttribute != nullptr && *static_cast<std::string*>(pStringAttribute->Value()) == rkValue;
+			});
+		}
+
+		/// <summary>
+		/// Adds a custom predicate on the OCCT shape.
+		/// </summary>
+		/// <param name="rkPredicate"></param>
+		/// <returns></returns>
+		TopologyFilter& Where(const OcctPredicate& rkPredicate)
+		{
+			m_occtPredicates.push_back(rkPredicate);
+			return *this;
+		}
+
+		/// <summary>
+		/// Adds a custom predicate on the wrapped topology. These run after all the OCCT predicates,
+		/// so only the topologies that passed them are wrapped.
+		/// </summary>
+		/// <param name="rkPredicate"></param>
+		/// <returns></returns>
+		TopologyFilter& WhereTopology(const Predicate& rkPredicate)
+		{
+			m_predicates.push_back(rkPredicate);
+			return *this;
+		}
+
+		/// <summary>
+		/// Selects the sub-topologies of kpTopology, including itself, that pass the filter.
+		/// </summary>
+		/// <param name="kpTopology"></param>
+		/// <param name="rSelectedTopologies"></param>
+		void Select(const Topology::Ptr& kpTopology, std::list<Topology::Ptr>& rSelectedTopologies) const
+		{
+			for (int topologyType = TOPOLOGY_VERTEX; topologyType <= TOPOLOGY_CLUSTER; topologyType <<= 1)
+			{
+				if ((m_typeFilter & topologyType) == 0)
+				{
+					continue;
+				}
+
+				TopTools_IndexedMapOfShape occtShapes;
+				TopExp::MapShapes(kpTopology->GetOcctShape(), Topology::GetOcctTopologyType((TopologyType)topologyType), occtShapes);
+				for (int i = 1; i <= occtShapes.Extent(); ++i)
+				{
+					Topology::Ptr pTopology = nullptr;
+					if (IsSelected(occtShapes(i), pTopology))
+					{
+						rSelectedTopologies.push_back(pTopology);
+					}
+				}
+			}
+		}
+
+		/// <summary>
+		/// Filters a list of topologies. A drop-in replacement for Topology::Filter with predicates; as there, null
+		/// entries are skipped.
+		/// </summary>
+		/// <param name="rkTopologies"></param>
+		/// <param name="rFilteredTopologies"></param>
+		void Apply(const std::list<Topology::Ptr>& rkTopologies, std::list<Topology::Ptr>& rFilteredTopologies) const
+		{
+			for (const Topology::Ptr& kpTopology : rkTopologies)
+			{
+				if (kpTopology == nullptr || (m_typeFilter & kpTopology->GetType()) == 0)
+				{
+					continue;
+				}
+
+				Topology::Ptr pTopology = kpTopology;
+				if (IsSelected(kpTopology->GetOcctShape(), pTopology))
+				{
+					rFilteredTopologies.push_back(pTopology);
+				}
+			}
+		}
+
+	protected:
+		bool IsSelected(const TopoDS_Shape& rkOcctShape, Topology::Ptr& rTopology) const
+		{
+			for (const OcctPredicate& rkOcctPredicate : m_occtPredicates)
+			{
+				if (!rkOcctPredicate(rkOcctShape))
+				{
+					return false;
+				}
+			}
+
+			if (rTopology == nullptr)
+			{
+				rTopology = Topology::ByOcctShape(rkOcctShape, "");
+			}
+
+			for (const Predicate& rkPredicate : m_predicates)
+			{
+				if (!rkPredicate(rTopology))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		int m_typeFilter;
+		std::vector<OcctPredicate> m_occtPredicates;
+		std::vector<Predicate> m_predicates;
+	};
+}
@@ -0,0 +1,95 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "TopologySet.h"
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// A hash map from topologies to values with O(1) insertion and lookup, keyed by TShape identity.
+	/// </summary>
+	template <class Value>
+	class TopologyMap
+	{
+	public:
+		typedef std::shared_ptr<TopologyMap<Value>> Ptr;
+
+	public:
+		/// <summary>
+		/// Sets the value of a topology, replacing any previous one.
+		/// </summary>
+		/// <param name="kpTopology"></param>
+		/// <param name="rkValue"></param>
+		void Set(const Topology::Ptr& kpTopology, const Value& rkValue)
+		{
+			m_values[kpTopology] = rkValue;
+		}
+
+		/// <summary>
+		/// Looks up the value of a topology. Returns false if the topology is not in the map.
+		/// </summary>
+		/// <param name="kpTopology"></param>
+		/// <param name="rValue"></param>
+		/// <returns></returns>
+		bool Find(const Topology::Ptr& kpTopology, Value& rValue) const
+		{
+			typename std::unordered_map<Topology::Ptr, Value, TopologyHasher, TopologyEqual>::const_iterator kValueIterator = m_values.find(kpTopology);
+			if (kValueIterator == m_values.end())
+			{
+				return false;
+			}
+			rValue = kValueIterator->second;
+			return true;
+		}
+
+		bool Contains(const Topology::Ptr& kpTopology) const
+		{
+			return m_values.find(kpTopology) != m_values.end();
+		}
+
+		bool Remove(const Topology::Ptr& kpTopology)
+		{
+			return m_values.erase(kpTopology) > 0;
+		}
+
+		int Size() const
+		{
+			return (int)m_values.size();
+		}
+
+		void Clear()
+		{
+			m_values.clear();
+		}
+
+		void Topologies(std::list<Topology::Ptr>& rTopologies) const
+		{
+			for (const auto& rkValuePair : m_values)
+			{
+				rTopologies.push_back(rkValuePair.first);
+			}
+		}
+
+	protected:
+		std::unordered_map<Topology::Ptr, Value, TopologyHasher, TopologyEqual> m_values;
+	};
+}
@@ -0,0 +1,137 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+#include "Topology.h"
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_set>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// Hashes a topology by the identity of its TShape, consistently with Topology::IsSame.
+	/// </summary>
+	struct TopologyHasher
+	{
+		static std::size_t Hash(const TopoDS_Shape& rkOcctShape)
+		{
+			return std::hash<const void*>()(rkOcctShape.TShape().get());
+		}
+
+		std::size_t operator()(const Topology::Ptr& kpTopology) const
+		{
+			return Hash(kpTopology->GetOcctShape());
+		}
+	};
+
+	/// <summary>
+	/// Compares two topologies as Topology::IsSame does, i.e. same TShape and same location.
+	/// </summary>
+	struct TopologyEqual
+	{
+		bool operator()(const Topology::Ptr& kpTopology1, const Topology::Ptr& kpTopology2) const
+		{
+			return kpTopology1->GetOcctShape().IsSame(kpTopology2->GetOcctShape());
+		}
+	};
+
+	/// <summary>
+	/// A hash set of topologies with O(1) insertion and lookup, keyed by TShape identity.
+	/// </summary>
+	class TopologySet
+	{
+	public:
+		typedef std::shared_ptr<TopologySet> Ptr;
+
+	public:
+		TopologySet()
+		{
+		}
+
+		TopologySet(const std::list<Topology::Ptr>& rkTopologies)
+		{
+			AddTopologies(rkTopologies);
+		}
+
+		/// <summary>
+		/// Adds a topology. Returns false if an identical topology is already in the set.
+		/// </summary>
+		/// <param name="kpTopology"></param>
+		/// <returns></returns>
+		bool AddTopology(const Topology::Ptr& kpTopology)
+		{
+			return m_topologies.insert(kpTopology).second;
+		}
+
+		void AddTopologies(const std::list<Topology::Ptr>& rkTopologies)
+		{
+			for (const Topology::Ptr& kpTopology : rkTopologies)
+			{
+				m_topologies.insert(kpTopology);
+			}
+		}
+
+		bool RemoveTopology(const Topology::Ptr& kpTopology)
+		{
+			return m_topologies.erase(kpTopology) > 0;
+		}
+
+		bool Contains(const Topology::Ptr& kpTopology) const
+		{
+			return m_topologies.find(kpTopology) != m_topologies.end();
+		}
+
+		int Size() const
+		{
+			return (int)m_topologies.size();
+		}
+
+		void Clear()
+		{
+			m_topologies.clear();
+		}
+
+		void Topologies(std::list<Topology::Ptr>& rTopologies) const
+		{
+			rTopologies.insert(rTopologies.end(), m_topologies.begin(), m_topologies.end());
+		}
+
+		/// <summary>
+		/// Removes the duplicates from a list of topologies, keeping the first occurrence and the order.
+		/// </summary>
+		/// <param name="rkTopologies"></param>
+		/// <param name="rUniqueTopologies"></param>
+		static void Unique(const std::list<Topology::Ptr>& rkTopologies, std::list<Topology::Ptr>& rUniqueTopologies)
+		{
+			std::unordered_set<Topology::Ptr, TopologyHasher, TopologyEqual> visitedTopologies(rkTopologies.size());
+			for (const Topology::Ptr& kpTopology : rkTopologies)
+			{
+				if (visitedTopologies.insert(kpTopology).second)
+				{
+					rUniqueTopologies.push_back(kpTopology);
+				}
+			}
+		}
+
+	protected:
+		std::unordered_set<Topology::Ptr, TopologyHasher, TopologyEqual> m_topologies;
+	};
+}
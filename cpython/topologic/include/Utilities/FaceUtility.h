@@ -18,11 +18,21 @@
 
 #include <Cell.h>
 #include <Face.h>
+#include <ProgressToken.h>
 #include <Shell.h>
 #include <Vertex.h>
 #include <Wire.h>
 
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepBuilderAPI_MakePolygon.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Tool.hxx>
+#include <IMeshTools_Parameters.hxx>
+#include <Poly_Triangulation.hxx>
+
 #include <memory>
+#include <stdexcept>
+#include <utility>
 
 namespace TopologicUtilities
 {
@@ -102,6 +112,20 @@ namespace TopologicUtilities
 
 		static TOPOLOGIC_API void Triangulate(const TopologicCore::Face::Ptr& kpFace, const double kDeflection, std::list<TopologicCore::Face::Ptr>& rTriangles);
 
+		/// <summary>
+		/// Triangulates a face with the range of a progress token, throwing if it is cancelled during the meshing
+		/// or while the triangles are made.
+		/// </summary>
+		/// <param name="kpFace"></param>
+		/// <param name="kDeflection"></param>
+		/// <param name="kpProgressToken">May be null</param>
+		/// <param name="rTriangles"></param>
+		static void Triangulate(
+			const TopologicCore::Face::Ptr& kpFace,
+			const double kDeflection,
+			const TopologicCore::ProgressToken::Ptr& kpProgressToken,
+			std::list<TopologicCore::Face::Ptr>& rTriangles);
+
 		/// <summary>
 		/// 
 		/// </summary>
@@ -157,4 +181,62 @@ namespace TopologicUtilities
 		static TOPOLOGIC_API std::shared_ptr<TopologicCore::Vertex> InternalVertex(
 			const TopologicCore::Face::Ptr kpFace, const double kTolerance = 0.0001);
 	};
+
+	inline void FaceUtility::Triangulate(
+		const TopologicCore::Face::Ptr& kpFace,
+		const double kDeflection,
+		const TopologicCore::ProgressToken::Ptr& kpProgressToken,
+		std::list<TopologicCore::Face::Ptr>& rTriangles)
+	{
+		const TopoDS_Face& rkOcctFace = kpFace->GetOcctFace();
+		IMeshTools_Parameters occtMeshParameters;
+		occtMeshParameters.Deflection = kDeflection;
+		TopologicCore::ProgressToken::ThrowIfCancelled(kpProgressToken);
+#if OCC_VERSION_HEX >= 0x070500
+		BRepMesh_IncrementalMesh occtIncrementalMesh(rkOcctFace, occtMeshParameters, TopologicCore::ProgressToken::Start(kpProgressToken));
+#else
+		BRepMesh_IncrementalMesh occtIncrementalMesh(rkOcctFace, occtMeshParameters);
+#endif
+		TopologicCore::ProgressToken::ThrowIfCancelled(kpProgressToken);
+
+		TopLoc_Location occtLocation;
+		Handle(Poly_Triangulation) pOcctTriangulation = BRep_Tool::Triangulation(rkOcctFace, occtLocation);
+		if (pOcctTriangulation.IsNull())
+		{
+			throw std::runtime_error("The face could not be triangulated.");
+		}
+
+		const gp_Trsf kOcctTransformation = occtLocation.Transformation();
+		for (int i = 1; i <= pOcctTriangulation->NbTriangles(); ++i)
+		{
+			if ((i & 0xff) == 0)
+			{
+				TopologicCore::ProgressToken::ThrowIfCancelled(kpProgressToken);
+			}
+
+			int nodeIndex1 = 0, nodeIndex2 = 0, nodeIndex3 = 0;
+			pOcctTriangulation->Triangle(i).Get(nodeIndex1, nodeIndex2, nodeIndex3);
+			if (rkOcctFace.Orientation() == TopAbs_REVERSED)
+			{
+				std::swap(nodeIndex2, nodeIndex3);
+			}
+
+			BRepBuilderAPI_MakePolygon occtMakePolygon(
+				pOcctTriangulation->Node(nodeIndex1).Transformed(kOcctTransformation),
+				pOcctTriangulation->Node(nodeIndex2).Transformed(kOcctTransformation),
+				pOcctTriangulation->Node(nodeIndex3).Transformed(kOcctTransformation),
+				Standard_True);
+			if (!occtMakePolygon.IsDone())
+			{
+				// Degenerate triangle
+				continue;
+			}
+
+			BRepBuilderAPI_MakeFace occtMakeFace(occtMakePolygon.Wire(), Standard_True);
+			if (occtMakeFace.IsDone())
+			{
+				rTriangles.push_back(std::make_shared<TopologicCore::Face>(occtMakeFace.Face()));
+			}
+		}
+	}
 }
\ No newline at end of file
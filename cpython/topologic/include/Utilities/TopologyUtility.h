@@ -22,6 +22,14 @@
 #include <Edge.h>
 #include <Vertex.h>
 
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
 namespace TopologicUtilities
 {
 	class TopologyUtility
@@ -85,5 +93,96 @@ namespace TopologicUtilities
 			const TopologicCore::Topology::Ptr& kpCoreParentTopology, 
 			const int kTypeFilter,
 			std::list<TopologicCore::Topology::Ptr>& rCoreAdjacentTopologies);
+
+		/// <summary>
+		/// Lists every pair of sub-topologies of type kTopologyType in kpParentTopology that share a sub-topology
+		/// of type kSharedTopologyType, together with the shared sub-topology. The incidence is inverted once,
+		/// so e.g. all the shared faces between the cells of a CellComplex are found in a single pass.
+		/// The three output lists are parallel: the i-th shared topology is shared by the i-th topologies in A and B.
+		/// </summary>
+		/// <param name="kpParentTopology"></param>
+		/// <param name="kTopologyType"></param>
+		/// <param name="kSharedTopologyType"></param>
+		/// <param name="rTopologiesA"></param>
+		/// <param name="rTopologiesB"></param>
+		/// <param name="rSharedTopologies"></param>
+		static void AllSharedTopologies(
+			const TopologicCore::Topology::Ptr& kpParentTopology,
+			const int kTopologyType,
+			const int kSharedTopologyType,
+			std::list<TopologicCore::Topology::Ptr>& rTopologiesA,
+			std::list<TopologicCore::Topology::Ptr>& rTopologiesB,
+			std::list<TopologicCore::Topology::Ptr>& rSharedTopologies);
 	};
+
+	inline void TopologyUtility::AllSharedTopologies(
+		const TopologicCore::Topology::Ptr& kpParentTopology,
+		const int kTopologyType,
+		const int kSharedTopologyType,
+		std::list<TopologicCore::Topology::Ptr>& rTopologiesA,
+		std::list<TopologicCore::Topology::Ptr>& rTopologiesB,
+		std::list<TopologicCore::Topology::Ptr>& rSharedTopologies)
+	{
+		if (kpParentTopology == nullptr)
+		{
+			throw std::runtime_error("The parent topology is null.");
+		}
+
+		if (kSharedTopologyType >= kTopologyType)
+		{
+			throw std::runtime_error("The shared topology type must be of a lower dimension than the topology type.");
+		}
+
+		TopAbs_ShapeEnum occtType = TopologicCore::Topology::GetOcctTopologyType((TopologicCore::TopologyType)kTopologyType);
+		TopAbs_ShapeEnum occtSharedType = TopologicCore::Topology::GetOcctTopologyType((TopologicCore::TopologyType)kSharedTopologyType);
+		const TopoDS_Shape& rkOcctParentShape = kpParentTopology->GetOcctShape();
+
+		// Index the topologies once, so that each one is wrapped at most once however many pairs it appears in.
+		TopTools_IndexedMapOfShape occtTopologies;
+		TopExp::MapShapes(rkOcctParentShape, occtType, occtTopologies);
+		std::vector<TopologicCore::Topology::Ptr> topologies(occtTopologies.Extent() + 1);
+
+		TopTools_IndexedDataMapOfShapeListOfShape occtSharedToTopologies;
+		TopExp::MapShapesAndUniqueAncestors(rkOcctParentShape, occtSharedType, occtType, occtSharedToTopologies);
+
+		std::vector<int> indices;
+		for (int i = 1; i <= occtSharedToTopologies.Extent(); ++i)
+		{
+			const TopTools_ListOfShape& rkOcctAncestors = occtSharedToTopologies(i);
+			if (rkOcctAncestors.Extent() < 2)
+			{
+				continue;
+			}
+
+			indices.clear();
+			for (TopTools_ListIteratorOfListOfShape occtAncestorIterator(rkOcctAncestors);
+				occtAncestorIterator.More();
+				occtAncestorIterator.Next())
+			{
+				int index = occtTopologies.FindIndex(occtAncestorIterator.Value());
+				if (index == 0)
+				{
+					continue;
+				}
+
+				if (topologies[index] == nullptr)
+				{
+					topologies[index] = TopologicCore::Topology::ByOcctShape(occtTopologies(index), "");
+				}
+				indices.push_back(index);
+			}
+			std::sort(indices.begin(), indices.end());
+
+			TopologicCore::Topology::Ptr pSharedTopology = TopologicCore::Topology::ByOcctShape(occtSharedToTopologies.FindKey(i), "");
+			for (size_t j = 0; j < indices.size(); ++j)
+			{
+				for (size_t k = j + 1; k < indices.size(); ++k)
+				{
+					rTopologiesA.push_back(topologies[indices[j]]);
+					rTopologiesB.push_back(topologies[indices[k]]);
+					rSharedTopologies.push_back(pSharedTopology);
+				}
+			}
+		}
+	}
 }
\ No newline at end of file
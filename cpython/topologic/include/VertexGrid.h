@@ -0,0 +1,188 @@
+// This file is part of Topologic software library.
+// Copyright(C) 2019, Cardiff University and University College London
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Utilities.h"
+
+#include <BRep_Tool.hxx>
+#include <TopoDS_TShape.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <gp_Pnt.hxx>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace TopologicCore
+{
+	/// <summary>
+	/// Uniform hash grid over a set of vertices, for lookups by distance tolerance in constant expected time.
+	/// A query visits at most 8 cells if its tolerance is up to half the cell size, and 27 if it is up to the cell size.
+	/// Vertices can be added, not removed. A grid is not synchronised: it must not be added to while it is queried.
+	/// </summary>
+	class VertexGrid
+	{
+	public:
+		typedef std::shared_ptr<VertexGrid> Ptr;
+
+	public:
+		VertexGrid(const double kCellSize)
+			: m_cellSize(kCellSize)
+		{
+		}
+
+		double CellSize() const
+		{
+			return m_cellSize;
+		}
+
+		int NumOfVertices() const
+		{
+			return (int)m_occtVertices.size();
+		}
+
+		/// <summary>
+		/// Adds a vertex and returns its index in the grid.
+		/// </summary>
+		/// <param name="rkOcctVertex"></param>
+		/// <returns></returns>
+		int Add(const TopoDS_Vertex& rkOcctVertex)
+		{
+			const int kIndex = (int)m_occtVertices.size();
+			const gp_Pnt kOcctPoint = BRep_Tool::Pnt(rkOcctVertex);
+			m_occtVertices.push_back(rkOcctVertex);
+			m_occtPoints.push_back(kOcctPoint);
+			m_indices.insert(std::make_pair(rkOcctVertex.TShape().get(), kIndex));
+			m_cells[CellKey(Coordinate(kOcctPoint.X()), Coordinate(kOcctPoint.Y()), Coordinate(kOcctPoint.Z()))].push_back(kIndex);
+			return kIndex;
+		}
+
+		bool Contains(const TopoDS_Vertex& rkOcctVertex) const
+		{
+			return m_indices.find(rkOcctVertex.TShape().get()) != m_indices.end();
+		}
+
+		const TopoDS_Vertex& OcctVertex(const int kIndex) const
+		{
+			return m_occtVertices[kIndex];
+		}
+
+		/// <summary>
+		/// Returns the index of the vertex nearest to a point within a tolerance, or -1 if there is none.
+		/// </summary>
+		/// <param name="rkOcctPoint"></param>
+		/// <param name="kTolerance"></param>
+		/// <returns></returns>
+		int FindNearest(const gp_Pnt& rkOcctPoint, const double kTolerance) const
+		{
+			int nearestIndex = -1;
+			double nearestDistance = kTolerance;
+			Visit(rkOcctPoint, kTolerance, [&](const int kIndex, const double kDistance)
+			{
+				if (kDistance < nearestDistance || (kDistance == nearestDistance && nearestIndex < 0))
+				{
+					nearestIndex = kIndex;
+					nearestDistance = kDistance;
+				}
+			});
+			return nearestIndex;
+		}
+
+		/// <summary>
+		/// Lists the indices of all the vertices within a tolerance of a point.
+		/// </summary>
+		/// <param name="rkOcctPoint"></param>
+		/// <param name="kTolerance"></param>
+		/// <param name="rIndices"></param>
+		void FindAll(const gp_Pnt& rkOcctPoint, const double kTolerance, std::vector<int>& rIndices) const
+		{
+			Visit(rkOcctPoint, kTolerance, [&](const int kIndex, const double /*kDistance*/)
+			{
+				rIndices.push_back(kIndex);
+			});
+		}
+
+	protected:
+		struct CellKey
+		{
+			CellKey(const int64_t kX, const int64_t kY, const int64_t kZ)
+				: x(kX), y(kY), z(kZ)
+			{
+			}
+
+			bool operator==(const CellKey& rkOther) const
+			{
+				return x == rkOther.x && y == rkOther.y && z == rkOther.z;
+			}
+
+			int64_t x;
+			int64_t y;
+			int64_t z;
+		};
+
+		struct CellKeyHasher
+		{
+			size_t operator()(const CellKey& rkKey) const
+			{
+				return (size_t)(rkKey.x * 73856093LL ^ rkKey.y * 19349663LL ^ rkKey.z * 83492791LL);
+			}
+		};
+
+		int64_t Coordinate(const double kValue) const
+		{
+			return (int64_t)std::floor(kValue / m_cellSize);
+		}
+
+		template <class Visitor>
+		void Visit(const gp_Pnt& rkOcctPoint, const double kTolerance, const Visitor& rkVisitor) const
+		{
+			const int64_t kMinX = Coordinate(rkOcctPoint.X() - kTolerance), kMaxX = Coordinate(rkOcctPoint.X() + kTolerance);
+			const int64_t kMinY = Coordinate(rkOcctPoint.Y() - kTolerance), kMaxY = Coordinate(rkOcctPoint.Y() + kTolerance);
+			const int64_t kMinZ = Coordinate(rkOcctPoint.Z() - kTolerance), kMaxZ = Coordinate(rkOcctPoint.Z() + kTolerance);
+			for (int64_t x = kMinX; x <= kMaxX; ++x)
+			{
+				for (int64_t y = kMinY; y <= kMaxY; ++y)
+				{
+					for (int64_t z = kMinZ; z <= kMaxZ; ++z)
+					{
+						auto cellIterator = m_cells.find(CellKey(x, y, z));
+						if (cellIterator == m_cells.end())
+						{
+							continue;
+						}
+						for (const int kIndex : cellIterator->second)
+						{
+							const double kDistance = m_occtPoints[kIndex].Distance(rkOcctPoint);
+							if (kDistance <= kTolerance)
+							{
+								rkVisitor(kIndex, kDistance);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		double m_cellSize;
+		std::vector<TopoDS_Vertex> m_occtVertices;
+		std::vector<gp_Pnt> m_occtPoints;
+		std::unordered_map<const TopoDS_TShape*, int> m_indices;
+		std::unordered_map<CellKey, std::vector<int>, CellKeyHasher> m_cells;
+	};
+}
@@ -0,0 +1,51 @@
+from topologic import Vertex, Edge, Face, Cell, CellComplex, CellUtility, Topology, TopologyUtility
+import cppyy
+
+# Checks that AllSharedTopologies finds, in one pass, the same (A, B, shared) triples as SharedTopologies queried pair by
+# pair, on a row of three cells and on a 2 x 2 block of cells.
+
+def cuboid(x, y):
+    return CellUtility.ByCuboid(x, y, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def cell_complex(centres):
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    for (x, y) in centres:
+        cells.push_back(cuboid(x, y))
+    return CellComplex.ByCells(cells)
+
+def pair_by_pair(cellComplex, sharedType):
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    cellComplex.Cells(cells)
+    cells = list(cells)
+    triples = set()
+    for i in range(len(cells)):
+        for j in range(i + 1, len(cells)):
+            shared = cppyy.gbl.std.list[Topology.Ptr]()
+            cells[i].SharedTopologies(cells[j], sharedType, shared)
+            for topology in shared:
+                triples.add((frozenset([cells[i], cells[j]]), topology))
+    return triples
+
+def all_at_once(cellComplex, sharedType):
+    topologiesA = cppyy.gbl.std.list[Topology.Ptr]()
+    topologiesB = cppyy.gbl.std.list[Topology.Ptr]()
+    sharedTopologies = cppyy.gbl.std.list[Topology.Ptr]()
+    TopologyUtility.AllSharedTopologies(cellComplex, Cell.Type(), sharedType, topologiesA, topologiesB, sharedTopologies)
+    assert topologiesA.size() == topologiesB.size() == sharedTopologies.size()
+    return set((frozenset([a, b]), shared) for (a, b, shared) in zip(topologiesA, topologiesB, sharedTopologies))
+
+row = cell_complex([(0.5, 0.5), (1.5, 0.5), (2.5, 0.5)])
+block = cell_complex([(0.5, 0.5), (1.5, 0.5), (0.5, 1.5), (1.5, 1.5)])
+for (cellComplex, numOfSharedFaces) in [(row, 2), (block, 4)]:
+    for sharedType in [Face.Type(), Edge.Type(), Vertex.Type()]:
+        assert all_at_once(cellComplex, sharedType) == pair_by_pair(cellComplex, sharedType)
+    print(str(len(all_at_once(cellComplex, Face.Type()))) + " <--- Should be " + str(numOfSharedFaces))
+    assert len(all_at_once(cellComplex, Face.Type())) == numOfSharedFaces
+
+# A shared type of the same dimension as the topologies is rejected.
+try:
+    all_at_once(row, Cell.Type())
+except Exception:
+    print("The shared type was rejected <--- Should be rejected")
+else:
+    assert False
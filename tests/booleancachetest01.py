@@ -0,0 +1,94 @@
+from topologic import Vertex, Face, Cell, CellUtility, Dictionary, Attribute, IntAttribute, BooleanOptions, BooleanCache
+import cppyy
+from cppyy.gbl.std import string
+import os
+import tempfile
+
+# Checks that a boolean with useCache is computed once for geometrically identical operands, that a hit gives the same
+# result as the boolean, with the dictionaries of the new operands, and that the results written to the disk directory
+# are read back after the memory is cleared.
+
+def cuboid(x, y):
+    return CellUtility.ByCuboid(x, y, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def summary(topology):
+    if not topology:
+        return None
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    topology.Cells(cells)
+    faces = cppyy.gbl.std.list[Face.Ptr]()
+    topology.Faces(faces)
+    vertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    topology.Vertices(vertices)
+    volume = sum(CellUtility.Volume(cell) for cell in cells)
+    return (topology.GetTypeAsString(), cells.size(), faces.size(), vertices.size(), round(volume, 6))
+
+def make_dictionary(key, value):
+    keys = cppyy.gbl.std.list[string]()
+    keys.push_back(string(key))
+    values = cppyy.gbl.std.list[Attribute.Ptr]()
+    values.push_back(IntAttribute(value))
+    return Dictionary.ByKeysValues(keys, values)
+
+def int_value(topology, key):
+    attribute = topology.GetDictionary().ValueAtKey(string(key))
+    if not attribute:
+        return None
+    return cppyy.bind_object(attribute.Value(), 'IntegerStruct').getInteger
+
+def rooms(topology):
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    topology.Cells(cells)
+    return sorted(int_value(cell, "room") for cell in cells)
+
+cache = BooleanCache.GetInstance()
+cache.Clear()
+options = BooleanOptions()
+options.useCache = True
+
+# A miss, then a hit with new operands built the same way.
+plain = summary(cuboid(0, 0).Union(cuboid(0.5, 0.5), False))
+assert summary(cuboid(0, 0).Union(cuboid(0.5, 0.5), options, False)) == plain
+print(str(cache.Size()) + " <--- Should be 1")
+assert cache.Size() == 1
+assert summary(cuboid(0, 0).Union(cuboid(0.5, 0.5), options, False)) == plain
+assert cache.Size() == 1
+
+# Another operation, or other options, is another entry.
+assert summary(cuboid(0, 0).Difference(cuboid(0.5, 0.5), options, False)) == summary(cuboid(0, 0).Difference(cuboid(0.5, 0.5), False))
+otherOptions = BooleanOptions()
+otherOptions.useCache = True
+otherOptions.fixValidOperands = False
+cuboid(0, 0).Union(cuboid(0.5, 0.5), otherOptions, False)
+print(str(cache.Size()) + " <--- Should be 3")
+assert cache.Size() == 3
+
+# A hit transfers the dictionaries of the new operands, not those of the operands the result was computed from.
+for (roomA, roomB) in [(1, 2), (3, 4)]:
+    a = cuboid(0, 0)
+    b = cuboid(3, 0)
+    a.SetDictionary(make_dictionary("room", roomA))
+    b.SetDictionary(make_dictionary("room", roomB))
+    result = a.Union(b, options, True)
+    print(str(rooms(result)) + " <--- Should be " + str([roomA, roomB]))
+    assert rooms(result) == [roomA, roomB]
+assert cache.Size() == 4
+
+# The least recently used entries are evicted beyond the capacity.
+cache.SetCapacity(2)
+assert cache.Size() == 2
+cache.SetCapacity(256)
+
+# The disk tier.
+with tempfile.TemporaryDirectory() as directory:
+    cache.Clear()
+    cache.SetDiskDirectory(directory)
+    cuboid(0, 0).Intersect(cuboid(0.5, 0.5), options, False)
+    assert len(os.listdir(directory)) > 0
+    cache.Clear()
+    result = summary(cuboid(0, 0).Intersect(cuboid(0.5, 0.5), options, False))
+    print(str(cache.Size()) + " <--- Should be 1")
+    assert cache.Size() == 1
+    assert result == summary(cuboid(0, 0).Intersect(cuboid(0.5, 0.5), False))
+    cache.SetDiskDirectory("")
+cache.Clear()
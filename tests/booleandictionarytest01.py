@@ -0,0 +1,54 @@
+from topologic import Cell, CellComplex, CellUtility, Topology, Dictionary, Attribute, IntAttribute, BooleanOptions
+import cppyy
+from cppyy.gbl.std import string
+
+# Checks that the dictionaries of cells, and of the operands themselves, survive a Union
+# with dictionary transfer, whether or not the operands are healed first.
+
+def make_dictionary(key, value):
+    keys = cppyy.gbl.std.list[string]()
+    keys.push_back(string(key))
+    values = cppyy.gbl.std.list[Attribute.Ptr]()
+    values.push_back(IntAttribute(value))
+    return Dictionary.ByKeysValues(keys, values)
+
+def int_value(topology, key):
+    attribute = topology.GetDictionary().ValueAtKey(string(key))
+    if not attribute:
+        return None
+    return cppyy.bind_object(attribute.Value(), 'IntegerStruct').getInteger
+
+def cells_of(topology):
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    topology.Cells(cells)
+    return list(cells)
+
+def cuboid(x):
+    return CellUtility.ByCuboid(x, 0, 0, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+for fixValidOperands in [True, False]:
+    options = BooleanOptions()
+    options.fixValidOperands = fixValidOperands
+
+    # Two disjoint cells: each result cell keeps its own dictionary.
+    a = cuboid(0)
+    b = cuboid(3)
+    a.SetDictionary(make_dictionary("room", 1))
+    b.SetDictionary(make_dictionary("room", 2))
+    result = a.Union(b, options, True)
+    rooms = sorted(int_value(cell, "room") for cell in cells_of(result))
+    print(str(rooms) + " <--- Should be [1, 2]")
+    assert rooms == [1, 2]
+
+    # A cell complex and an overlapping cell: the dictionary of the cell complex itself is transferred too.
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    cells.push_back(cuboid(0))
+    cells.push_back(cuboid(1))
+    cellComplex = CellComplex.ByCells(cells)
+    cellComplex.SetDictionary(make_dictionary("storey", 7))
+    for cell in cells_of(cellComplex):
+        cell.SetDictionary(make_dictionary("room", 1))
+    result = cellComplex.Union(cuboid(1.5), options, True)
+    print(str(int_value(result, "storey")) + " <--- Should be 7")
+    assert int_value(result, "storey") == 7
+    assert any(int_value(cell, "room") == 1 for cell in cells_of(result))
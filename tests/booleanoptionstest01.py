@@ -0,0 +1,59 @@
+from topologic import Vertex, Edge, Face, Cell, CellComplex, Cluster, Topology, CellUtility, BooleanOptions
+import cppyy
+
+# Checks that the booleans taking BooleanOptions give, with the default options, the same results as the plain booleans,
+# and that the options which only change how the result is computed (parallel runs, bounding boxes, a fuzzy value below
+# the modelling tolerance, non-destructive operands) leave it unchanged.
+
+def cuboid(x, y):
+    return CellUtility.ByCuboid(x, y, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def summary(topology):
+    if not topology:
+        return None
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    topology.Cells(cells)
+    faces = cppyy.gbl.std.list[Face.Ptr]()
+    topology.Faces(faces)
+    vertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    topology.Vertices(vertices)
+    volume = sum(CellUtility.Volume(cell) for cell in cells)
+    return (topology.GetTypeAsString(), cells.size(), faces.size(), vertices.size(), round(volume, 6))
+
+def cluster(topologies):
+    stlTopologies = cppyy.gbl.std.list[Topology.Ptr]()
+    for topology in topologies:
+        stlTopologies.push_back(topology)
+    return Cluster.ByTopologies(stlTopologies)
+
+operandPairs = [
+    (cuboid(0, 0), cuboid(0.5, 0.5)),
+    (cuboid(0, 0), cuboid(3, 0)),
+    (cluster([cuboid(0, 0), cuboid(5, 0)]), cuboid(0.5, 0)),
+]
+
+booleanNames = ["Union", "Difference", "Intersect", "Merge", "Impose", "Imprint", "Slice", "XOR"]
+
+options = BooleanOptions()
+for (a, b) in operandPairs:
+    for name in booleanNames:
+        plain = getattr(a, name)(b, False)
+        withOptions = getattr(a, name)(b, options, False)
+        assert summary(plain) == summary(withOptions), (name, summary(plain), summary(withOptions))
+
+union = summary(operandPairs[0][0].Union(operandPairs[0][1], options, False))
+print(str(union) + " <--- Should be a single cell of volume 1.75")
+assert union[1] == 1 and union[4] == 1.75
+
+def with_option(name, value):
+    variant = BooleanOptions()
+    setattr(variant, name, value)
+    return variant
+
+for variant in [with_option("runParallel", True), with_option("useOBB", True), with_option("fuzzyValue", 1e-9), with_option("nonDestructive", True)]:
+    for (a, b) in operandPairs:
+        for name in booleanNames:
+            withDefaults = getattr(a, name)(b, options, False)
+            withVariant = getattr(a, name)(b, variant, False)
+            assert summary(withDefaults) == summary(withVariant), (name, summary(withDefaults), summary(withVariant))
+print("The options left the results unchanged <--- Should be unchanged")
@@ -0,0 +1,83 @@
+from topologic import Vertex, Face, Cell, Cluster, Topology, CellUtility, BooleanSession
+import cppyy
+
+# Checks that every result of a BooleanSession, in any order and more than once, is the same as the plain boolean of its
+# operands, and that a selection of the split parts gives the expected cells.
+
+def cuboid(x, y):
+    return CellUtility.ByCuboid(x, y, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def summary(topology):
+    if not topology:
+        return None
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    topology.Cells(cells)
+    faces = cppyy.gbl.std.list[Face.Ptr]()
+    topology.Faces(faces)
+    vertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    topology.Vertices(vertices)
+    volume = sum(CellUtility.Volume(cell) for cell in cells)
+    return (topology.GetTypeAsString(), cells.size(), faces.size(), vertices.size(), round(volume, 6))
+
+def cluster(topologies):
+    stlTopologies = cppyy.gbl.std.list[Topology.Ptr]()
+    for topology in topologies:
+        stlTopologies.push_back(topology)
+    return Cluster.ByTopologies(stlTopologies)
+
+def int_list(values):
+    stlValues = cppyy.gbl.std.list[int]()
+    for value in values:
+        stlValues.push_back(value)
+    return stlValues
+
+operandPairs = [
+    (cuboid(0, 0), cuboid(0.5, 0.5)),
+    (cuboid(0, 0), cuboid(3, 0)),
+    (cluster([cuboid(0, 0), cuboid(5, 0)]), cuboid(0.5, 0)),
+]
+
+names = ["Union", "Difference", "Intersect", "Merge", "Impose", "Imprint", "Slice", "XOR"]
+for (a, b) in operandPairs:
+    session = BooleanSession(a, b)
+    for name in names + list(reversed(names)):
+        plain = getattr(a, name)(b, False)
+        fromSession = getattr(session, name)(False)
+        assert summary(plain) == summary(fromSession), (name, summary(plain), summary(fromSession))
+
+# A cube and a cube overlapping a quarter of it.
+(a, b) = operandPairs[0]
+session = BooleanSession(a, b)
+arguments = cppyy.gbl.std.list[Topology.Ptr]()
+session.Arguments(arguments)
+print(str(arguments.size()) + " <--- Should be 2")
+assert arguments.size() == 2
+print(str(session.NumOfArgumentsA()) + " <--- Should be 1")
+assert session.NumOfArgumentsA() == 1
+
+# The part of A outside B, then the parts of A and B fused into one material.
+session.AddToSelection(int_list([0]), int_list([1]))
+aOnly = summary(session.Selection(False))
+print(str(aOnly[4]) + " <--- Should be 0.75")
+assert aOnly[1] == 1 and aOnly[4] == 0.75
+session.ClearSelection()
+session.AddToSelection(int_list([0]), int_list([]), 1)
+session.AddToSelection(int_list([1]), int_list([]), 1)
+fused = summary(session.Selection(False))
+print(str(fused[4]) + " <--- Should be 1.75")
+assert fused[1] == 1 and fused[4] == 1.75
+
+try:
+    session.AddToSelection(int_list([2]), int_list([]))
+except Exception:
+    print("The argument index was rejected <--- Should be rejected")
+else:
+    assert False
+
+# A session needs two topologies.
+try:
+    BooleanSession(a, cppyy.nullptr)
+except Exception:
+    print("The null operand was rejected <--- Should be rejected")
+else:
+    assert False
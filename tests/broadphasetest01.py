@@ -0,0 +1,72 @@
+from topologic import Cell, Cluster, Topology, CellUtility, Dictionary, Attribute, IntAttribute, BooleanOptions
+import cppyy
+from cppyy.gbl.std import string
+
+# Checks that the broad phase, which leaves the members of a Cluster that are far from the other operand out of the
+# intersection, gives the same cells as the full boolean, and that the members it leaves out keep their dictionaries.
+
+def cuboid(x, y):
+    return CellUtility.ByCuboid(x, y, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def cells_of(topology):
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    if topology:
+        topology.Cells(cells)
+    return list(cells)
+
+def summary(topology):
+    cells = cells_of(topology)
+    volumes = sorted(round(CellUtility.Volume(cell), 6) for cell in cells)
+    centres = sorted((round(cell.CenterOfMass().X(), 6), round(cell.CenterOfMass().Y(), 6)) for cell in cells)
+    return (volumes, centres)
+
+def cluster(topologies):
+    stlTopologies = cppyy.gbl.std.list[Topology.Ptr]()
+    for topology in topologies:
+        stlTopologies.push_back(topology)
+    return Cluster.ByTopologies(stlTopologies)
+
+def make_dictionary(key, value):
+    keys = cppyy.gbl.std.list[string]()
+    keys.push_back(string(key))
+    values = cppyy.gbl.std.list[Attribute.Ptr]()
+    values.push_back(IntAttribute(value))
+    return Dictionary.ByKeysValues(keys, values)
+
+def int_value(topology, key):
+    attribute = topology.GetDictionary().ValueAtKey(string(key))
+    if not attribute:
+        return None
+    return cppyy.bind_object(attribute.Value(), 'IntegerStruct').getInteger
+
+fullOptions = BooleanOptions()
+broadPhaseOptions = BooleanOptions()
+broadPhaseOptions.broadPhase = True
+
+farCube = cuboid(10, 0)
+farCube.SetDictionary(make_dictionary("room", 3))
+members = cluster([cuboid(0, 0), cuboid(5, 0), farCube])
+operandPairs = [
+    (members, cuboid(0.5, 0)),
+    (cuboid(0.5, 0), members),
+    (members, cuboid(20, 0)),
+    (members, cluster([cuboid(0.5, 0), cuboid(5.5, 0), cuboid(-20, 0)])),
+]
+
+for (a, b) in operandPairs:
+    for name in ["Union", "Difference", "Intersect", "Merge", "Impose", "Imprint", "Slice", "XOR"]:
+        full = getattr(a, name)(b, fullOptions, False)
+        broadPhase = getattr(a, name)(b, broadPhaseOptions, False)
+        assert summary(full) == summary(broadPhase), (name, summary(full), summary(broadPhase))
+
+# Only the first member overlaps the other operand; the far cube is left out, and keeps its dictionary.
+result = members.Union(cuboid(0.5, 0), broadPhaseOptions, True)
+print(str(len(cells_of(result))) + " <--- Should be 3")
+assert len(cells_of(result)) == 3
+rooms = [int_value(cell, "room") for cell in cells_of(result) if round(cell.CenterOfMass().X(), 6) == 10.0]
+print(str(rooms) + " <--- Should be [3]")
+assert rooms == [3]
+
+# Intersect drops the members that are left out.
+print(str(summary(members.Intersect(cuboid(0.5, 0), broadPhaseOptions, False))) + " <--- Should be ([0.5], [(0.25, 0.0)])")
+assert summary(members.Intersect(cuboid(0.5, 0), broadPhaseOptions, False)) == ([0.5], [(0.25, 0.0)])
@@ -0,0 +1,59 @@
+from topologic import Vertex, Edge, Wire, Graph
+import cppyy
+
+# Checks that the enumeration of the paths between opposite corners of a 3 x 3 grid on the graph index finds the same
+# paths in serial and in parallel as the compiled AllPaths, and that it honours the maximum number of paths, the
+# maximum length of a path and a callback which stops it.
+
+def make_grid(n):
+    vertices = [Vertex.ByCoordinates(i, j, 0) for j in range(n) for i in range(n)]
+    stlVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    for vertex in vertices:
+        stlVertices.push_back(vertex)
+    stlEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    for j in range(n):
+        for i in range(n):
+            if i + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[j * n + i], vertices[j * n + i + 1]))
+            if j + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[j * n + i], vertices[(j + 1) * n + i]))
+    return Graph.ByVerticesEdges(stlVertices, stlEdges), vertices
+
+def id_paths(graph, start, end, maxLength, maxNumOfPaths, runsParallel):
+    paths = cppyy.gbl.std.vector[cppyy.gbl.std.vector['int']]()
+    graph.AllPaths(start, end, maxLength, maxNumOfPaths, runsParallel, paths)
+    return sorted(tuple(path) for path in paths)
+
+grid, gridVertices = make_grid(3)
+start = grid.VertexId(gridVertices[0], 0.0001)
+end = grid.VertexId(gridVertices[8], 0.0001)
+
+compiledPaths = cppyy.gbl.std.list[Wire.Ptr]()
+grid.AllPaths(gridVertices[0], gridVertices[8], False, 0, compiledPaths)
+serialPaths = id_paths(grid, start, end, 0, 0, False)
+parallelPaths = id_paths(grid, start, end, 0, 0, True)
+print(str(len(serialPaths)) + " <--- Should be 12")
+assert len(serialPaths) == len(parallelPaths) == compiledPaths.size() == 12
+assert serialPaths == parallelPaths
+assert len(set(serialPaths)) == len(serialPaths)
+assert all(path[0] == start and path[-1] == end for path in serialPaths)
+
+# At most 5 paths, and only the 6 shortest paths with at most 4 edges.
+for runsParallel in [False, True]:
+    print(str(len(id_paths(grid, start, end, 0, 5, runsParallel))) + " <--- Should be 5")
+    assert len(id_paths(grid, start, end, 0, 5, runsParallel)) == 5
+    shortPaths = id_paths(grid, start, end, 4, 0, runsParallel)
+    print(str(len(shortPaths)) + " <--- Should be 6")
+    assert len(shortPaths) == 6
+    assert all(len(path) == 5 for path in shortPaths)
+    assert id_paths(grid, start, end, 3, 0, runsParallel) == []
+
+# A callback which returns False on the third path stops the enumeration after it.
+for runsParallel in [False, True]:
+    passedPaths = []
+    def callback(path):
+        passedPaths.append(tuple(path))
+        return len(passedPaths) < 3
+    numOfPaths = grid.AllPaths(start, end, 0, 0, runsParallel, callback)
+    print(str(numOfPaths) + " <--- Should be 3")
+    assert numOfPaths == len(passedPaths) == 3
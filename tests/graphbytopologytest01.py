@@ -0,0 +1,81 @@
+from topologic import Vertex, Edge, Wire, Face, Shell, Cell, CellComplex, CellUtility, Aperture, Graph, ProgressToken
+import cppyy
+import itertools
+
+# Checks that the parallel ByTopology (the overload taking a progress token) builds the same graph as the compiled
+# ByTopology, on a cell complex with apertures on an internal and on an exterior face, and on a shell with apertures on
+# an internal and on an exterior edge, and that it raises once the token is cancelled.
+
+def rounded(vertex):
+    return (round(vertex.X(), 6), round(vertex.Y(), 6), round(vertex.Z(), 6))
+
+def signature(graph):
+    vertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    graph.Vertices(vertices)
+    edges = cppyy.gbl.std.list[Edge.Ptr]()
+    graph.Edges(edges)
+    return (sorted(rounded(v) for v in vertices),
+            sorted(tuple(sorted([rounded(e.StartVertex()), rounded(e.EndVertex())])) for e in edges))
+
+def rectangle(points):
+    vertices = [Vertex.ByCoordinates(x, y, z) for (x, y, z) in points]
+    edges = cppyy.gbl.std.list[Edge.Ptr]()
+    for i in range(len(vertices)):
+        edges.push_back(Edge.ByStartVertexEndVertex(vertices[i], vertices[(i + 1) % len(vertices)]))
+    return Face.ByExternalBoundary(Wire.ByEdges(edges))
+
+def face_at(topology, x):
+    faces = cppyy.gbl.std.list[Face.Ptr]()
+    topology.Faces(faces)
+    return [f for f in faces if abs(f.CenterOfMass().X() - x) < 0.0001][0]
+
+def edge_at(topology, x, y):
+    edges = cppyy.gbl.std.list[Edge.Ptr]()
+    topology.Edges(edges)
+    return [e for e in edges if abs(e.CenterOfMass().X() - x) < 0.0001 and abs(e.CenterOfMass().Y() - y) < 0.0001][0]
+
+def check(topology):
+    for flags in itertools.product([False, True], repeat=5):
+        compiled = Graph.ByTopology(topology, *flags, False, 0.0001)
+        parallel = Graph.ByTopology(topology, *flags, False, 0.0001, token)
+        assert signature(compiled) == signature(parallel), (topology.GetTypeAsString(), flags)
+
+token = cppyy.gbl.std.make_shared[ProgressToken]()
+
+cells = cppyy.gbl.std.list[Cell.Ptr]()
+cells.push_back(CellUtility.ByCuboid(0.5, 0.5, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0))
+cells.push_back(CellUtility.ByCuboid(1.5, 0.5, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0))
+cellComplex = CellComplex.ByCells(cells)
+
+# A door on the internal face at x = 1 and a window on the exterior face at x = 0.
+Aperture.ByTopologyContext(rectangle([(1, 0.25, 0), (1, 0.75, 0), (1, 0.75, 0.8), (1, 0.25, 0.8)]), face_at(cellComplex, 1.0))
+Aperture.ByTopologyContext(rectangle([(0, 0.25, 0.3), (0, 0.75, 0.3), (0, 0.75, 0.8), (0, 0.25, 0.8)]), face_at(cellComplex, 0.0))
+
+check(cellComplex)
+vertices, edges = signature(Graph.ByTopology(cellComplex, True, True, True, True, True, False, 0.0001, token))
+print(str(len(vertices)) + " vertices and " + str(len(edges)) + " edges <--- Should match the compiled ByTopology")
+
+# An L-shaped shell of three unit squares in the plane z = 0.
+faces = cppyy.gbl.std.list[Face.Ptr]()
+faces.push_back(rectangle([(0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0)]))
+faces.push_back(rectangle([(1, 0, 0), (2, 0, 0), (2, 1, 0), (1, 1, 0)]))
+faces.push_back(rectangle([(0, 1, 0), (1, 1, 0), (1, 2, 0), (0, 2, 0)]))
+shell = Shell.ByFaces(faces, 0.0001)
+
+# An opening on the internal edge at x = 1 and one on the exterior edge at y = 0.
+Aperture.ByTopologyContext(Edge.ByStartVertexEndVertex(Vertex.ByCoordinates(1, 0.25, 0), Vertex.ByCoordinates(1, 0.75, 0)), edge_at(shell, 1.0, 0.5))
+Aperture.ByTopologyContext(Edge.ByStartVertexEndVertex(Vertex.ByCoordinates(0.25, 0, 0), Vertex.ByCoordinates(0.75, 0, 0)), edge_at(shell, 0.5, 0.0))
+
+check(shell)
+vertices, edges = signature(Graph.ByTopology(shell, True, True, True, True, True, False, 0.0001, token))
+print(str(len(vertices)) + " vertices and " + str(len(edges)) + " edges <--- Should match the compiled ByTopology")
+
+# A cancelled token.
+token.Cancel()
+for topology in [cellComplex, shell]:
+    try:
+        Graph.ByTopology(topology, True, True, True, True, True, False, 0.0001, token)
+    except Exception:
+        print("ByTopology raised <--- Should have raised")
+    else:
+        assert False, topology.GetTypeAsString()
@@ -0,0 +1,59 @@
+from topologic import Vertex, Edge, Graph, CentralityOptions, Dictionary, Attribute, DoubleAttribute
+import cppyy
+from cppyy.gbl.std import string
+
+# Checks the betweenness centrality against values counted by hand, topologically and with edge costs, including on a
+# cycle whose opposite vertices are joined by two paths of equal cost that sum to different doubles.
+
+def make_dictionary(key, value):
+    keys = cppyy.gbl.std.list[string]()
+    keys.push_back(string(key))
+    values = cppyy.gbl.std.list[Attribute.Ptr]()
+    values.push_back(DoubleAttribute(value))
+    return Dictionary.ByKeysValues(keys, values)
+
+def make_graph(points, pairs, costs=None):
+    vertices = [Vertex.ByCoordinates(x, y, z) for (x, y, z) in points]
+    stlVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    for vertex in vertices:
+        stlVertices.push_back(vertex)
+    stlEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    for (k, (i, j)) in enumerate(pairs):
+        edge = Edge.ByStartVertexEndVertex(vertices[i], vertices[j])
+        if costs is not None:
+            edge.SetDictionary(make_dictionary("cost", costs[k]))
+        stlEdges.push_back(edge)
+    graph = Graph.ByVerticesEdges(stlVertices, stlEdges)
+    # The ids follow the index, not the order of the points.
+    ids = [graph.VertexId(vertex, 0.0001) for vertex in vertices]
+    return graph, vertices, ids
+
+# Betweenness on a path of 5 vertices and on a star with 4 leaves, each unordered pair counted once.
+path, pathVertices, pathIds = make_graph([(i, 0, 0) for i in range(5)], [(i, i + 1) for i in range(4)])
+betweenness = cppyy.gbl.std.vector['double']()
+path.Centrality(cppyy.gbl.TopologicCore.CENTRALITY_BETWEENNESS, CentralityOptions(), betweenness)
+pathBetweenness = [betweenness[pathIds[i]] for i in range(5)]
+print(str(pathBetweenness) + " <--- Should be [0.0, 3.0, 4.0, 3.0, 0.0]")
+assert pathBetweenness == [0.0, 3.0, 4.0, 3.0, 0.0]
+
+star, starVertices, starIds = make_graph([(0, 0, 0), (1, 0, 0), (-1, 0, 0), (0, 1, 0), (0, -1, 0)], [(0, i) for i in range(1, 5)])
+options = CentralityOptions()
+options.isTopological = False
+options.edgeKey = "length"
+star.Centrality(cppyy.gbl.TopologicCore.CENTRALITY_BETWEENNESS, options, betweenness)
+print(str(betweenness[starIds[0]]) + " <--- Should be 6.0")
+assert betweenness[starIds[0]] == 6.0
+assert all(betweenness[starIds[i]] == 0.0 for i in range(1, 5))
+
+
+# A cycle of 6 vertices with costs 0.1, 0.2, 0.3, 0.1, 0.2, 0.3: each pair of opposite vertices is joined by two paths of
+# cost 0.6, e.g. 0.1 + 0.2 + 0.3 and 0.3 + 0.2 + 0.1, which differ in the last bit, so every vertex has a betweenness of 2.
+points = [(1, 0, 0), (0.5, 0.87, 0), (-0.5, 0.87, 0), (-1, 0, 0), (-0.5, -0.87, 0), (0.5, -0.87, 0)]
+cycle, cycleVertices, cycleIds = make_graph(points, [(i, (i + 1) % 6) for i in range(6)], [0.1, 0.2, 0.3, 0.1, 0.2, 0.3])
+options = CentralityOptions()
+options.isTopological = False
+options.edgeKey = "cost"
+cycle.Centrality(cppyy.gbl.TopologicCore.CENTRALITY_BETWEENNESS, options, betweenness)
+cycleBetweenness = [round(betweenness[cycleIds[i]], 6) for i in range(6)]
+print(str(cycleBetweenness) + " <--- Should be [2.0, 2.0, 2.0, 2.0, 2.0, 2.0]")
+assert cycleBetweenness == [2.0] * 6
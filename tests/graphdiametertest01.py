@@ -0,0 +1,65 @@
+from topologic import Vertex, Edge, Graph
+import cppyy
+
+# Checks that the exact diameter found by iFUB agrees with the compiled Diameter(), that the approximate one is a lower
+# bound, and that Eccentricities agrees with Eccentricity, on a grid, on a path and on a graph of two components.
+
+def make_graph(points, pairs):
+    vertices = [Vertex.ByCoordinates(x, y, z) for (x, y, z) in points]
+    stlVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    for vertex in vertices:
+        stlVertices.push_back(vertex)
+    stlEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    for (i, j) in pairs:
+        stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[i], vertices[j]))
+    graph = Graph.ByVerticesEdges(stlVertices, stlEdges)
+    # The ids follow the index, not the order of the points.
+    ids = [graph.VertexId(vertex, 0.0001) for vertex in vertices]
+    return graph, vertices, ids
+
+def make_grid(n):
+    points = [(i, j, 0) for j in range(n) for i in range(n)]
+    pairs = []
+    for j in range(n):
+        for i in range(n):
+            if i + 1 < n:
+                pairs.append((j * n + i, j * n + i + 1))
+            if j + 1 < n:
+                pairs.append((j * n + i, (j + 1) * n + i))
+    return make_graph(points, pairs)
+
+def check(graph, vertices, ids, isConnected=True):
+    # The compiled queries are only compared on connected graphs.
+    if isConnected:
+        assert graph.Diameter(False) == graph.Diameter()
+    assert graph.Diameter(True) <= graph.Diameter(False)
+    eccentricities = cppyy.gbl.std.vector['int']()
+    graph.Eccentricities(eccentricities)
+    assert eccentricities.size() == len(vertices)
+    for (vertex, id) in zip(vertices, ids):
+        assert eccentricities[id] == graph.Eccentricity(id)
+        if isConnected:
+            assert eccentricities[id] == graph.Eccentricity(vertex)
+    assert max(eccentricities) == graph.Diameter(False)
+
+grid, gridVertices, gridIds = make_grid(5)
+check(grid, gridVertices, gridIds)
+print(str(grid.Diameter(False)) + " <--- Should be 8")
+assert grid.Diameter(False) == 8
+
+path, pathVertices, pathIds = make_graph([(i, 0, 0) for i in range(7)], [(i, i + 1) for i in range(6)])
+check(path, pathVertices, pathIds)
+print(str(path.Diameter(True)) + " <--- Should be 6")
+assert path.Diameter(True) == 6
+eccentricities = cppyy.gbl.std.vector['int']()
+path.Eccentricities(eccentricities)
+print(str([eccentricities[id] for id in pathIds]) + " <--- Should be [6, 5, 4, 3, 4, 5, 6]")
+assert [eccentricities[id] for id in pathIds] == [6, 5, 4, 3, 4, 5, 6]
+
+# A path of 3 edges and a triangle: the diameter is the largest over the components.
+twoComponents, twoComponentsVertices, twoComponentsIds = make_graph(
+    [(i, 0, 0) for i in range(4)] + [(0, 5, 0), (1, 5, 0), (0, 6, 0)],
+    [(0, 1), (1, 2), (2, 3), (4, 5), (5, 6), (6, 4)])
+check(twoComponents, twoComponentsVertices, twoComponentsIds, False)
+print(str(twoComponents.Diameter(False)) + " <--- Should be 3")
+assert twoComponents.Diameter(False) == 3
@@ -0,0 +1,65 @@
+from topologic import Vertex, Edge, Graph
+import cppyy
+
+# Checks that the distance matrix of a 4 x 4 grid agrees with the topological distances of its index, and that a
+# maximum distance and a subset of sources are honoured.
+
+def make_graph(points, pairs):
+    vertices = [Vertex.ByCoordinates(x, y, z) for (x, y, z) in points]
+    stlVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    for vertex in vertices:
+        stlVertices.push_back(vertex)
+    stlEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    for (i, j) in pairs:
+        stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[i], vertices[j]))
+    graph = Graph.ByVerticesEdges(stlVertices, stlEdges)
+    # The ids follow the index, not the order of the points.
+    ids = [graph.VertexId(vertex, 0.0001) for vertex in vertices]
+    return graph, vertices, ids
+
+def make_grid(n):
+    points = [(i, j, 0) for j in range(n) for i in range(n)]
+    pairs = []
+    for j in range(n):
+        for i in range(n):
+            if i + 1 < n:
+                pairs.append((j * n + i, j * n + i + 1))
+            if j + 1 < n:
+                pairs.append((j * n + i, (j + 1) * n + i))
+    return make_graph(points, pairs)
+
+grid, gridVertices, gridIds = make_grid(4)
+sources = cppyy.gbl.std.vector['int']()
+for i in range(len(gridVertices)):
+    sources.push_back(i)
+distances = cppyy.gbl.std.vector[cppyy.gbl.std.vector['double']]()
+predecessors = cppyy.gbl.std.vector[cppyy.gbl.std.vector['int']]()
+grid.DistanceMatrix(sources, "", "", True, -1.0, distances, predecessors)
+gridIndex = grid.Index()
+for i in range(len(gridVertices)):
+    for j in range(len(gridVertices)):
+        assert distances[i][j] == gridIndex.TopologicalDistance(i, j)
+print(str(distances[gridIds[0]][gridIds[15]]) + " <--- Should be 6.0")
+assert distances[gridIds[0]][gridIds[15]] == 6.0
+
+# The predecessors step back along a shortest path, one edge at a time.
+for i in range(len(gridVertices)):
+    for j in range(len(gridVertices)):
+        if i == j:
+            assert predecessors[i][j] == -1
+        else:
+            assert distances[i][predecessors[i][j]] == distances[i][j] - 1
+            assert gridIndex.ContainsEdge(predecessors[i][j], j)
+
+# Two sources, and vertices further than 2 edges left unreached.
+someSources = cppyy.gbl.std.vector['int']()
+someSources.push_back(gridIds[0])
+someSources.push_back(gridIds[5])
+grid.DistanceMatrix(someSources, "", "", True, 2.0, distances, predecessors)
+print(str(distances.size()) + " <--- Should be 2")
+assert distances.size() == predecessors.size() == 2
+for (row, source) in enumerate(someSources):
+    for j in range(len(gridVertices)):
+        distance = gridIndex.TopologicalDistance(source, j)
+        assert distances[row][j] == (distance if distance <= 2 else -1.0)
+        assert (predecessors[row][j] == -1) == (distance == 0 or distance > 2)
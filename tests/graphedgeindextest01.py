@@ -0,0 +1,67 @@
+from topologic import Vertex, Edge, Topology, Graph
+import cppyy
+
+# Checks that the edge index of the GraphIndex of a 4 x 4 grid finds the edge between two vertices in either order, and
+# the same edge as the compiled Graph.Edge, that the incident edges of a vertex touch it, and that edges built from
+# copies of the vertices of the graph are still indexed.
+
+def make_grid(n, copiesEndpoints):
+    vertices = [Vertex.ByCoordinates(i, j, 0) for j in range(n) for i in range(n)]
+    stlVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    for vertex in vertices:
+        stlVertices.push_back(vertex)
+    endpoints = [Vertex.ByCoordinates(i, j, 0) for j in range(n) for i in range(n)] if copiesEndpoints else vertices
+    stlEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    for j in range(n):
+        for i in range(n):
+            if i + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(endpoints[j * n + i], endpoints[j * n + i + 1]))
+            if j + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(endpoints[j * n + i], endpoints[(j + 1) * n + i]))
+    return Graph.ByVerticesEdges(stlVertices, stlEdges), vertices
+
+def rounded(vertex):
+    return (round(vertex.X(), 6), round(vertex.Y(), 6), round(vertex.Z(), 6))
+
+def point(index, id):
+    occtPoint = index.OcctPoint(id)
+    return (round(occtPoint.X(), 6), round(occtPoint.Y(), 6), round(occtPoint.Z(), 6))
+
+def endpoints(occtEdge):
+    vertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    Topology.ByOcctShape(occtEdge, "").Vertices(vertices)
+    return sorted(rounded(vertex) for vertex in vertices)
+
+for copiesEndpoints in [False, True]:
+    grid, gridVertices = make_grid(4, copiesEndpoints)
+    index = grid.Index()
+    compiledEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    grid.Edges(compiledEdges)
+    print(str(index.NumOfEdges()) + " <--- Should be 24")
+    assert index.NumOfEdges() == compiledEdges.size() == 24
+
+    ids = [grid.VertexId(vertex, 0.0001) for vertex in gridVertices]
+    for (i, vertex1) in enumerate(gridVertices):
+        for (j, vertex2) in enumerate(gridVertices):
+            edgeIndex = index.EdgeIndex(ids[i], ids[j])
+            assert edgeIndex == index.EdgeIndex(ids[j], ids[i])
+            compiledEdge = grid.Edge(vertex1, vertex2, 0.0001)
+            if not compiledEdge:
+                assert edgeIndex == -1 and not index.ContainsEdge(ids[i], ids[j]), (i, j)
+                continue
+            assert edgeIndex >= 0 and index.ContainsEdge(ids[i], ids[j]), (i, j)
+            assert index.OcctEdge(edgeIndex).IsSame(compiledEdge.GetOcctEdge())
+            assert endpoints(index.OcctEdge(edgeIndex)) == sorted([rounded(vertex1), rounded(vertex2)])
+
+    # Each vertex has one incident edge per neighbour, and each of them touches it.
+    for id in ids:
+        edgeIndices = cppyy.gbl.std.vector['int']()
+        index.IncidentEdgeIndices(id, edgeIndices)
+        assert edgeIndices.size() == index.Degree(id)
+        assert len(set(edgeIndices)) == edgeIndices.size()
+        for edgeIndex in edgeIndices:
+            assert point(index, id) in endpoints(index.OcctEdge(edgeIndex))
+
+    # Opposite corners are not adjacent.
+    print(str(index.EdgeIndex(ids[0], ids[15])) + " <--- Should be -1")
+    assert index.EdgeIndex(ids[0], ids[15]) == -1
@@ -0,0 +1,80 @@
+from topologic import Vertex, Edge, Graph
+import cppyy
+
+# Checks the adjacency of the GraphIndex of a 4 x 4 grid against the compiled graph queries, that its checked accessors
+# reject ids out of range, and that an index held across an edit of the graph stays as it was.
+
+def make_grid(n):
+    vertices = [Vertex.ByCoordinates(i, j, 0) for j in range(n) for i in range(n)]
+    stlVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    for vertex in vertices:
+        stlVertices.push_back(vertex)
+    stlEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    for j in range(n):
+        for i in range(n):
+            if i + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[j * n + i], vertices[j * n + i + 1]))
+            if j + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[j * n + i], vertices[(j + 1) * n + i]))
+    return Graph.ByVerticesEdges(stlVertices, stlEdges), vertices
+
+def rounded(vertex):
+    return (round(vertex.X(), 6), round(vertex.Y(), 6), round(vertex.Z(), 6))
+
+def point(index, id):
+    occtPoint = index.OcctPoint(id)
+    return (round(occtPoint.X(), 6), round(occtPoint.Y(), 6), round(occtPoint.Z(), 6))
+
+def raises(function):
+    try:
+        function()
+    except Exception:
+        return True
+    return False
+
+grid, gridVertices = make_grid(4)
+index = grid.Index()
+compiledEdges = cppyy.gbl.std.list[Edge.Ptr]()
+grid.Edges(compiledEdges)
+print(str(index.NumOfVertices()) + " vertices and " + str(index.NumOfEdges()) + " edges <--- Should be 16 vertices and 24 edges")
+assert index.NumOfVertices() == 16
+assert index.NumOfEdges() == compiledEdges.size() == 24
+
+graphVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+grid.Vertices(graphVertices)
+for vertex in graphVertices:
+    id = index.Id(vertex.GetOcctVertex())
+    assert id == grid.VertexId(vertex, 0.0001)
+    assert point(index, id) == rounded(vertex)
+    assert index.Degree(id) == grid.VertexDegree(vertex)
+
+    adjacentIds = cppyy.gbl.std.vector['int']()
+    index.AdjacentIds(id, adjacentIds)
+    adjacentVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    grid.AdjacentVertices(vertex, adjacentVertices)
+    assert sorted(point(index, adjacentId) for adjacentId in adjacentIds) == sorted(rounded(v) for v in adjacentVertices)
+
+    for other in gridVertices:
+        assert index.TopologicalDistance(id, grid.VertexId(other, 0.0001)) == grid.TopologicalDistance(vertex, other)
+
+# A vertex which is not in the graph has no id, and the checked accessors reject ids out of range.
+assert index.Id(Vertex.ByCoordinates(0, 0, 0).GetOcctVertex()) == -1
+for id in [-1, 16]:
+    assert raises(lambda: index.CheckId(id))
+    assert raises(lambda: index.AdjacentIds(id, cppyy.gbl.std.vector['int']()))
+    assert raises(lambda: index.IncidentEdgeIndices(id, cppyy.gbl.std.vector['int']()))
+    assert raises(lambda: index.TopologicalDistance(0, id))
+print("The ids out of range were rejected <--- Should be rejected")
+
+# An edit makes a new index; the one held before it is unchanged.
+distancesBefore = [index.TopologicalDistance(0, id) for id in range(16)]
+isolatedVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+isolatedVertices.push_back(Vertex.ByCoordinates(10, 10, 0))
+grid.AddVertices(isolatedVertices, 0.0001)
+print(str(grid.Index().NumOfVertices()) + " <--- Should be 17")
+assert grid.Index().NumOfVertices() == 17
+assert index.NumOfVertices() == 16
+assert [index.TopologicalDistance(0, id) for id in range(16)] == distancesBefore
+newId = grid.VertexId(isolatedVertices.front(), 0.0001)
+assert grid.Index().Degree(newId) == 0
+assert grid.Index().TopologicalDistance(newId, grid.VertexId(gridVertices[0], 0.0001)) == -1
@@ -0,0 +1,45 @@
+from topologic import Vertex, Edge, Wire, Graph
+import cppyy
+
+# Checks that on a 3 x 3 grid the shortest paths between opposite corners on the graph index are the 6 monotone paths
+# the compiled ShortestPaths finds, as many as NumOfShortestPaths counts, and that KShortestPaths finds them first and
+# then a longer one.
+
+def make_grid(n):
+    vertices = [Vertex.ByCoordinates(i, j, 0) for j in range(n) for i in range(n)]
+    stlVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    for vertex in vertices:
+        stlVertices.push_back(vertex)
+    stlEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    for j in range(n):
+        for i in range(n):
+            if i + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[j * n + i], vertices[j * n + i + 1]))
+            if j + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[j * n + i], vertices[(j + 1) * n + i]))
+    return Graph.ByVerticesEdges(stlVertices, stlEdges), vertices
+
+grid, gridVertices = make_grid(3)
+start = grid.VertexId(gridVertices[0], 0.0001)
+end = grid.VertexId(gridVertices[8], 0.0001)
+
+# The shortest paths, enumerated and counted.
+shortestPaths = cppyy.gbl.std.vector[cppyy.gbl.std.vector['int']]()
+cost = grid.ShortestPaths(start, end, "", "", 0, shortestPaths)
+compiledPaths = cppyy.gbl.std.list[Wire.Ptr]()
+grid.ShortestPaths(gridVertices[0], gridVertices[8], "", "", False, 0, compiledPaths)
+print(str(shortestPaths.size()) + " paths of cost " + str(cost) + " <--- Should be 6 paths of cost 4.0")
+assert cost == 4.0
+assert shortestPaths.size() == grid.NumOfShortestPaths(start, end, "", "") == compiledPaths.size() == 6
+assert len(set(tuple(path) for path in shortestPaths)) == 6
+assert all(len(path) == 5 and path[0] == start and path[len(path) - 1] == end for path in shortestPaths)
+
+# KShortestPaths: the 6 monotone corner-to-corner paths of 4 edges come first, then one of 6.
+paths = cppyy.gbl.std.vector[cppyy.gbl.std.vector['int']]()
+costs = cppyy.gbl.std.vector['double']()
+grid.KShortestPaths(start, end, "", "", 7, paths, costs)
+print(str(list(costs)) + " <--- Should be [4.0, 4.0, 4.0, 4.0, 4.0, 4.0, 6.0]")
+assert list(costs) == [4.0] * 6 + [6.0]
+assert len(set(tuple(path) for path in paths)) == 7
+assert all(path[0] == start and path[len(path) - 1] == end for path in paths)
+assert set(tuple(paths[i]) for i in range(6)) == set(tuple(path) for path in shortestPaths)
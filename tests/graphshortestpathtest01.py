@@ -0,0 +1,73 @@
+from topologic import Vertex, Edge, Graph, EdgeUtility, Dictionary, Attribute, DoubleAttribute
+import cppyy
+from cppyy.gbl.std import string
+import random
+
+# Checks that A* and Dijkstra's algorithm on the graph index find paths of the same cost, and that with the "length" key
+# this is the length of the path found by the compiled ShortestPath, on a jittered 6 x 6 grid with diagonals. The costs
+# from an edge dictionary, for which A* scales its heuristic by the lowest cost per unit length, are checked too.
+
+def make_dictionary(key, value):
+    keys = cppyy.gbl.std.list[string]()
+    keys.push_back(string(key))
+    values = cppyy.gbl.std.list[Attribute.Ptr]()
+    values.push_back(DoubleAttribute(value))
+    return Dictionary.ByKeysValues(keys, values)
+
+def wire_length(wire):
+    edges = cppyy.gbl.std.list[Edge.Ptr]()
+    wire.Edges(edges)
+    return sum(EdgeUtility.Length(edge) for edge in edges)
+
+n = 6
+generator = random.Random(1)
+vertices = [Vertex.ByCoordinates(i + generator.uniform(-0.3, 0.3), j + generator.uniform(-0.3, 0.3), 0) for j in range(n) for i in range(n)]
+pairs = []
+for j in range(n):
+    for i in range(n):
+        if i + 1 < n:
+            pairs.append((j * n + i, j * n + i + 1))
+        if j + 1 < n:
+            pairs.append((j * n + i, (j + 1) * n + i))
+        if i + 1 < n and j + 1 < n and generator.random() < 0.5:
+            pairs.append((j * n + i, (j + 1) * n + i + 1))
+
+# Each edge costs between 1 and 3 times its length.
+stlVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+for vertex in vertices:
+    stlVertices.push_back(vertex)
+stlEdges = cppyy.gbl.std.list[Edge.Ptr]()
+for (i, j) in pairs:
+    edge = Edge.ByStartVertexEndVertex(vertices[i], vertices[j])
+    edge.SetDictionary(make_dictionary("cost", EdgeUtility.Length(edge) * generator.uniform(1, 3)))
+    stlEdges.push_back(edge)
+graph = Graph.ByVerticesEdges(stlVertices, stlEdges)
+ids = [graph.VertexId(vertex, 0.0001) for vertex in vertices]
+
+path = cppyy.gbl.std.vector['int']()
+for (start, end) in [(0, n * n - 1), (n - 1, n * (n - 1)), (7, 28), (3, 3)]:
+    for edgeKey in ["length", "cost"]:
+        dijkstraCost = graph.ShortestPath(ids[start], ids[end], "", edgeKey, False, path)
+        aStarCost = graph.ShortestPath(ids[start], ids[end], "", edgeKey, True, path)
+        assert abs(dijkstraCost - aStarCost) <= 1e-9 * max(1.0, dijkstraCost), (start, end, edgeKey, dijkstraCost, aStarCost)
+        assert path[0] == ids[start] and path[len(path) - 1] == ids[end]
+
+    if start != end:
+        lengthCost = graph.ShortestPath(ids[start], ids[end], "", "length", True, path)
+        compiledLength = wire_length(graph.ShortestPath(vertices[start], vertices[end], "", "length"))
+        assert abs(lengthCost - compiledLength) <= 1e-6, (start, end, lengthCost, compiledLength)
+        assert abs(wire_length(graph.Path(path)) - lengthCost) <= 1e-6
+
+print(str(round(graph.ShortestPath(ids[3], ids[3], "", "length", True, path), 6)) + " <--- Should be 0.0")
+
+# An unreachable vertex has no path.
+isolatedVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+isolatedVertices.push_back(Vertex.ByCoordinates(20, 20, 0))
+graph.AddVertices(isolatedVertices, 0.0001)
+# The edit rebuilds the index, so the ids are looked up again.
+startId = graph.VertexId(vertices[0], 0.0001)
+isolatedId = graph.VertexId(isolatedVertices.front(), 0.0001)
+for usesAStar in [False, True]:
+    print(str(graph.ShortestPath(startId, isolatedId, "", "length", usesAStar, path)) + " <--- Should be -1.0")
+    assert graph.ShortestPath(startId, isolatedId, "", "length", usesAStar, path) == -1.0
+    assert path.size() == 0
@@ -0,0 +1,81 @@
+from topologic import Vertex, Edge, Graph
+import cppyy
+
+# Checks that AddVertices merges the vertices coincident with a vertex of the graph, or with one added before them, as
+# the compiled AddVertices does, and that VertexId and VertexIdsAtCoordinates find the vertices within a tolerance
+# through the vertex grid, including after vertices are added and when the tolerance changes.
+
+def make_grid(n):
+    vertices = [Vertex.ByCoordinates(i, j, 0) for j in range(n) for i in range(n)]
+    stlVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    for vertex in vertices:
+        stlVertices.push_back(vertex)
+    stlEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    for j in range(n):
+        for i in range(n):
+            if i + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[j * n + i], vertices[j * n + i + 1]))
+            if j + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[j * n + i], vertices[(j + 1) * n + i]))
+    return Graph.ByVerticesEdges(stlVertices, stlEdges)
+
+def rounded(vertex):
+    return (round(vertex.X(), 6), round(vertex.Y(), 6), round(vertex.Z(), 6))
+
+def stl_vertices(points):
+    vertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    for (x, y, z) in points:
+        vertices.push_back(Vertex.ByCoordinates(x, y, z))
+    return vertices
+
+def graph_points(graph):
+    vertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    graph.Vertices(vertices)
+    return sorted(rounded(vertex) for vertex in vertices)
+
+def point(graph, id):
+    occtPoint = graph.Index().OcctPoint(id)
+    return (round(occtPoint.X(), 6), round(occtPoint.Y(), 6), round(occtPoint.Z(), 6))
+
+# A copy of a corner, a new vertex, a copy of the new vertex, and a far vertex.
+newPoints = [(1e-5, 0, 0), (0.5, 0.5, 0), (0.5, 0.5 + 1e-5, 0), (10, 0, 0)]
+grid = make_grid(3)
+compiledGrid = make_grid(3)
+newVertices = stl_vertices(newPoints)
+graphVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+grid.AddVertices(newVertices, 0.0001, graphVertices)
+# The compiled AddVertices is only given vertices which are not coincident with each other.
+compiledGrid.AddVertices(stl_vertices([newPoints[0], newPoints[1], newPoints[3]]), 0.0001)
+print(str(len(graph_points(grid))) + " <--- Should be 11")
+assert len(graph_points(grid)) == 11
+assert graph_points(grid) == graph_points(compiledGrid)
+
+# Each vertex is mapped to the vertex of the graph it was merged with, or to itself.
+graphVertices = list(graphVertices)
+newVertices = list(newVertices)
+assert rounded(graphVertices[0]) == (0.0, 0.0, 0.0)
+assert graphVertices[1].IsSame(newVertices[1])
+assert graphVertices[2].IsSame(newVertices[1])
+assert graphVertices[3].IsSame(newVertices[3])
+
+# VertexId within the tolerance, and not beyond it.
+assert point(grid, grid.VertexId(Vertex.ByCoordinates(1 + 5e-5, 1, 0), 0.0001)) == (1.0, 1.0, 0.0)
+assert grid.VertexId(Vertex.ByCoordinates(1 + 5e-5, 1, 0), 0.00001) == -1
+print(str(point(grid, grid.VertexId(Vertex.ByCoordinates(2.4, 0, 0), 0.5))) + " <--- Should be (2.0, 0.0, 0.0)")
+assert point(grid, grid.VertexId(Vertex.ByCoordinates(2.4, 0, 0), 0.5)) == (2.0, 0.0, 0.0)
+
+# The new vertex and the four corners around it are within 0.75 of it.
+ids = cppyy.gbl.std.vector['int']()
+grid.VertexIdsAtCoordinates(0.5, 0.5, 0, 0.75, ids)
+print(str(ids.size()) + " <--- Should be 5")
+assert sorted(point(grid, id) for id in ids) == [(0.0, 0.0, 0.0), (0.0, 1.0, 0.0), (0.5, 0.5, 0.0), (1.0, 0.0, 0.0), (1.0, 1.0, 0.0)]
+ids.clear()
+grid.VertexIdsAtCoordinates(5, 5, 0, 0.75, ids)
+assert ids.size() == 0
+
+# Many vertices added one at a time, half of them copies of the other half.
+for i in range(200):
+    grid.AddVertices(stl_vertices([(20 + (i % 100), 20, 0)]), 0.0001, cppyy.gbl.std.list[Vertex.Ptr]())
+print(str(len(graph_points(grid))) + " <--- Should be 111")
+assert len(graph_points(grid)) == 111
+assert point(grid, grid.VertexId(Vertex.ByCoordinates(57, 20, 0), 0.0001)) == (57.0, 20.0, 0.0)
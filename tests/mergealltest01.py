@@ -0,0 +1,47 @@
+from topologic import Cell, CellUtility, Topology, BooleanOptions
+import cppyy
+
+# Checks that UnionAll and MergeAll, which run a single cells builder on all the topologies, give the same cells as
+# folding Union and Merge over the list, and that they skip null entries.
+
+def cuboid(x, y):
+    return CellUtility.ByCuboid(x, y, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def summary(topology):
+    if not topology:
+        return None
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    topology.Cells(cells)
+    volume = sum(CellUtility.Volume(cell) for cell in cells)
+    return (cells.size(), round(volume, 6))
+
+def stl_list(topologies):
+    stlTopologies = cppyy.gbl.std.list[Topology.Ptr]()
+    for topology in topologies:
+        stlTopologies.push_back(topology)
+    return stlTopologies
+
+def fold(name, topologies):
+    result = topologies[0]
+    for topology in topologies[1:]:
+        result = getattr(result, name)(topology, False)
+    return result
+
+options = BooleanOptions()
+row = [cuboid(0, 0), cuboid(0.5, 0), cuboid(1, 0)]
+block = [cuboid(0, 0), cuboid(0.5, 0.5), cuboid(5, 0), cuboid(5.5, 0)]
+for topologies in [row, block]:
+    assert summary(Topology.UnionAll(stl_list(topologies), options, False)) == summary(fold("Union", topologies))
+    assert summary(Topology.MergeAll(stl_list(topologies), options, False)) == summary(fold("Merge", topologies))
+
+# The row of three overlapping cubes is one cell once united, and 4 cells once merged.
+print(str(summary(Topology.UnionAll(stl_list(row), options, False))) + " <--- Should be (1, 2.0)")
+assert summary(Topology.UnionAll(stl_list(row), options, False)) == (1, 2.0)
+print(str(summary(Topology.MergeAll(stl_list(row), options, False))) + " <--- Should be (4, 2.0)")
+assert summary(Topology.MergeAll(stl_list(row), options, False)) == (4, 2.0)
+
+# Null entries are skipped; a list of nulls gives null.
+withNulls = stl_list([cppyy.nullptr] + row + [cppyy.nullptr])
+assert summary(Topology.UnionAll(withNulls, options, False)) == (1, 2.0)
+print(str(summary(Topology.UnionAll(stl_list([cppyy.nullptr]), options, False))) + " <--- Should be None")
+assert summary(Topology.UnionAll(stl_list([cppyy.nullptr]), options, False)) is None
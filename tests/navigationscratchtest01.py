@@ -0,0 +1,42 @@
+from topologic import Vertex, Edge, Face, Cell, CellComplex, CellUtility
+import cppyy
+
+# Checks that the pooled navigation, which leases its maps from NavigationScratch, gives the same results when it is
+# called many times in a row, so that nothing is left over in the reused maps from one call to the next.
+
+def cuboid(x):
+    return CellUtility.ByCuboid(x, 0.5, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def members(topology, subclass):
+    members = cppyy.gbl.std.list[subclass.Ptr]()
+    topology.PooledDownwardNavigation[subclass](members)
+    return list(members)
+
+def ancestors(topology, host, subclass):
+    ancestors = cppyy.gbl.std.list[subclass.Ptr]()
+    topology.PooledUpwardNavigation[subclass](host.GetOcctShape(), ancestors)
+    return list(ancestors)
+
+cells = cppyy.gbl.std.list[Cell.Ptr]()
+cells.push_back(cuboid(0.5))
+cells.push_back(cuboid(1.5))
+cellComplex = CellComplex.ByCells(cells)
+faces = members(cellComplex, Face)
+edgesOfFaces = [set(members(face, Edge)) for face in faces]
+
+numOfFacesPerEdge = {}
+for repetition in range(3):
+    for edge in members(cellComplex, Edge):
+        edgeFaces = ancestors(edge, cellComplex, Face)
+        # No duplicates, and exactly the faces having the edge.
+        assert len(edgeFaces) == len(set(edgeFaces))
+        assert set(edgeFaces) == set(face for (face, edges) in zip(faces, edgesOfFaces) if edge in edges)
+        numOfFacesPerEdge[len(edgeFaces)] = numOfFacesPerEdge.get(len(edgeFaces), 0) + 1
+
+# Per repetition: the 4 edges around the shared face have 3 faces, the 16 others 2.
+print(str(sorted(numOfFacesPerEdge.items())) + " <--- Should be [(2, 48), (3, 12)]")
+assert sorted(numOfFacesPerEdge.items()) == [(2, 48), (3, 12)]
+
+# A vertex outside the host has no ancestors in it.
+print(str(len(ancestors(Vertex.ByCoordinates(5, 5, 5), cellComplex, Edge))) + " <--- Should be 0")
+assert len(ancestors(Vertex.ByCoordinates(5, 5, 5), cellComplex, Edge)) == 0
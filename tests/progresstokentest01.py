@@ -0,0 +1,103 @@
+from topologic import Vertex, Edge, Face, Cell, Cluster, Topology, CellUtility, Graph, BooleanOptions, CentralityOptions, ProgressToken
+import cppyy
+import time
+
+# Checks that a progress token which is never cancelled leaves the booleans unchanged, and that once it is cancelled,
+# directly or by its time limit, the booleans and the graph queries taking it raise instead of returning a result.
+
+def cuboid(x, y):
+    return CellUtility.ByCuboid(x, y, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def summary(topology):
+    if not topology:
+        return None
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    topology.Cells(cells)
+    faces = cppyy.gbl.std.list[Face.Ptr]()
+    topology.Faces(faces)
+    vertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    topology.Vertices(vertices)
+    volume = sum(CellUtility.Volume(cell) for cell in cells)
+    return (topology.GetTypeAsString(), cells.size(), faces.size(), vertices.size(), round(volume, 6))
+
+def cluster(topologies):
+    stlTopologies = cppyy.gbl.std.list[Topology.Ptr]()
+    for topology in topologies:
+        stlTopologies.push_back(topology)
+    return Cluster.ByTopologies(stlTopologies)
+
+def make_grid(n):
+    vertices = [Vertex.ByCoordinates(i, j, 0) for j in range(n) for i in range(n)]
+    stlVertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    for vertex in vertices:
+        stlVertices.push_back(vertex)
+    stlEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    for j in range(n):
+        for i in range(n):
+            if i + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[j * n + i], vertices[j * n + i + 1]))
+            if j + 1 < n:
+                stlEdges.push_back(Edge.ByStartVertexEndVertex(vertices[j * n + i], vertices[(j + 1) * n + i]))
+    return Graph.ByVerticesEdges(stlVertices, stlEdges), vertices
+
+def raises(function):
+    try:
+        function()
+    except Exception:
+        return True
+    return False
+
+a = cuboid(0, 0)
+b = cuboid(0.5, 0.5)
+names = ["Union", "Difference", "Intersect", "Merge", "Impose", "Imprint", "Slice", "XOR"]
+
+# A token that is never cancelled, with a callback.
+token = cppyy.gbl.std.make_shared[ProgressToken]()
+progresses = []
+token.SetCallback(lambda progress: progresses.append(progress))
+options = BooleanOptions()
+options.progressToken = token
+for name in names:
+    assert summary(getattr(a, name)(b, options, False)) == summary(getattr(a, name)(b, False)), name
+assert all(0.0 <= progress <= 1.0 for progress in progresses)
+assert 0.0 <= token.Progress() <= 1.0
+print(str(token.IsCancelled()) + " <--- Should be False")
+assert not token.IsCancelled()
+
+# A cancelled token.
+token.Cancel()
+print(str(token.IsCancelled()) + " <--- Should be True")
+assert token.IsCancelled()
+for name in names:
+    assert raises(lambda: getattr(a, name)(b, options, False)), name
+assert raises(lambda: cluster([a, b]).SelfMerge(options, 1))
+assert raises(lambda: CellUtility.ByCuboid(0, 0, 50, 1, 1, 100, 0, 0, 1, 1, 0, 0, 0, 1, 0).Slice(0, 0, 0, 0, 0, 1, 1, options, False))
+
+# The graph queries poll the token as they go, so the grid is large enough for the shortest path to poll it.
+grid, gridVertices = make_grid(40)
+start = grid.VertexId(gridVertices[0], 0.0001)
+end = grid.VertexId(gridVertices[len(gridVertices) - 1], 0.0001)
+path = cppyy.gbl.std.vector['int']()
+print(str(grid.ShortestPath(start, end, "", "", False, path)) + " <--- Should be 78.0")
+assert grid.ShortestPath(start, end, "", "", False, path) == 78.0
+assert raises(lambda: grid.ShortestPath(start, end, "", "", False, path, token))
+assert raises(lambda: grid.Diameter(False, token))
+assert raises(lambda: grid.Eccentricities(cppyy.gbl.std.vector['int'](), token))
+sources = cppyy.gbl.std.vector['int']()
+sources.push_back(start)
+assert raises(lambda: grid.DistanceMatrix(sources, "", "", True, -1.0, cppyy.gbl.std.vector[cppyy.gbl.std.vector['double']](), cppyy.gbl.std.vector[cppyy.gbl.std.vector['int']](), token))
+centralityOptions = CentralityOptions()
+centralityOptions.progressToken = token
+assert raises(lambda: grid.Centrality(cppyy.gbl.TopologicCore.CENTRALITY_CLOSENESS, centralityOptions, cppyy.gbl.std.vector['double']()))
+print("The cancelled operations raised <--- Should have raised")
+
+# A time limit cancels the token once it is reached; none does not.
+limitedToken = cppyy.gbl.std.make_shared[ProgressToken]()
+limitedToken.SetTimeLimit(0.001)
+time.sleep(0.01)
+print(str(limitedToken.IsCancelled()) + " <--- Should be True")
+assert limitedToken.IsCancelled()
+unlimitedToken = cppyy.gbl.std.make_shared[ProgressToken]()
+unlimitedToken.SetTimeLimit(0)
+time.sleep(0.01)
+assert not unlimitedToken.IsCancelled()
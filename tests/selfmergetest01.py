@@ -0,0 +1,36 @@
+from topologic import Cell, Cluster, Topology, CellUtility, BooleanOptions
+import cppyy
+
+# Checks that SelfMerge split into partitions gives the same cells as SelfMerge in one go, on 64 overlapping cubes: four
+# separate rows, where no cube touches another partition, and one long row, whose partitions meet at three interfaces.
+
+def cuboid(x):
+    return CellUtility.ByCuboid(x, 0.5, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def cluster(topologies):
+    stlTopologies = cppyy.gbl.std.list[Topology.Ptr]()
+    for topology in topologies:
+        stlTopologies.push_back(topology)
+    return Cluster.ByTopologies(stlTopologies)
+
+def summary(topology):
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    topology.Cells(cells)
+    volume = sum(CellUtility.Volume(cell) for cell in cells)
+    centres = sorted(round(cell.CenterOfMass().X(), 6) for cell in cells)
+    return (cells.size(), round(volume, 6), centres)
+
+# Each row of 16 cubes, 0.5 apart, is cut into 17 cells of 0.5 by the cube faces.
+separateRows = cluster([cuboid(100 * row + 0.5 * i) for row in range(4) for i in range(16)])
+longRow = cluster([cuboid(0.5 * i) for i in range(64)])
+
+options = BooleanOptions()
+for (members, numOfCells, volume) in [(separateRows, 68, 34.0), (longRow, 65, 32.5)]:
+    inOneGo = summary(members.SelfMerge(options, 1))
+    inPartitions = summary(members.SelfMerge(options, 4))
+    print(str(inPartitions[:2]) + " <--- Should be " + str((numOfCells, volume)))
+    assert inPartitions[:2] == (numOfCells, volume)
+    assert inPartitions == inOneGo
+
+    # The partitions are merged non-destructively, so the members are unchanged.
+    assert summary(members)[:2] == (64, 64.0)
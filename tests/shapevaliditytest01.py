@@ -0,0 +1,67 @@
+from topologic import Vertex, Face, Cell, CellComplex, Cluster, Topology, CellUtility, BooleanOptions, ShapeValidityCache
+import cppyy
+
+# Checks that the booleans which skip the healing of the operands the ShapeValidityCache finds valid give the same
+# results as those which heal every operand, and that the cache finds the operands valid, before and after a boolean.
+
+def cuboid(x, y):
+    return CellUtility.ByCuboid(x, y, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def summary(topology):
+    if not topology:
+        return None
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    topology.Cells(cells)
+    faces = cppyy.gbl.std.list[Face.Ptr]()
+    topology.Faces(faces)
+    vertices = cppyy.gbl.std.list[Vertex.Ptr]()
+    topology.Vertices(vertices)
+    volume = sum(CellUtility.Volume(cell) for cell in cells)
+    return (topology.GetTypeAsString(), cells.size(), faces.size(), vertices.size(), round(volume, 6))
+
+def cluster(topologies):
+    stlTopologies = cppyy.gbl.std.list[Topology.Ptr]()
+    for topology in topologies:
+        stlTopologies.push_back(topology)
+    return Cluster.ByTopologies(stlTopologies)
+
+def cell_complex(topologies):
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    for topology in topologies:
+        cells.push_back(topology)
+    return CellComplex.ByCells(cells)
+
+operandPairs = [
+    (cuboid(0, 0), cuboid(0.5, 0.5)),
+    (cuboid(0, 0), cuboid(3, 0)),
+    (cluster([cuboid(0, 0), cuboid(5, 0)]), cuboid(0.5, 0)),
+    (cell_complex([cuboid(0, 0), cuboid(1, 0)]), cuboid(1, 0.5)),
+]
+
+validityCache = ShapeValidityCache.GetInstance()
+validityCache.Clear()
+for (a, b) in operandPairs:
+    assert validityCache.IsValid(a.GetOcctShape()) and validityCache.IsValid(b.GetOcctShape())
+
+healing = BooleanOptions()
+notHealing = BooleanOptions()
+notHealing.fixValidOperands = False
+for (a, b) in operandPairs:
+    for name in ["Union", "Difference", "Intersect", "Merge", "Impose", "Imprint", "Slice", "XOR"]:
+        healed = getattr(a, name)(b, healing, False)
+        notHealed = getattr(a, name)(b, notHealing, False)
+        assert summary(healed) == summary(notHealed), (name, summary(healed), summary(notHealed))
+
+# The operands are still valid, from the cache and once checked again.
+for (a, b) in operandPairs:
+    assert validityCache.IsValid(a.GetOcctShape()) and validityCache.IsValid(b.GetOcctShape())
+validityCache.Clear()
+for (a, b) in operandPairs:
+    validityCache.Invalidate(a.GetOcctShape())
+    assert validityCache.IsValid(a.GetOcctShape()) and validityCache.IsValid(b.GetOcctShape())
+
+union = operandPairs[0][0].Union(operandPairs[0][1], notHealing, False)
+print(str(validityCache.IsValid(union.GetOcctShape())) + " <--- Should be True")
+assert validityCache.IsValid(union.GetOcctShape())
+print(str(summary(union)[4]) + " <--- Should be 1.75")
+assert summary(union)[4] == 1.75
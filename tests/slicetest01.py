@@ -0,0 +1,75 @@
+from topologic import Vertex, Edge, Face, Cell, CellUtility, Topology, Dictionary, Attribute, IntAttribute, BooleanOptions
+import cppyy
+from cppyy.gbl.std import string
+
+# Checks that slicing a 1 x 1 x 3 box by several tools in one run gives the same cells as slicing it by one tool after
+# another, that slicing it by parallel planes 1 apart cuts it into 3 storeys, and that Divide adds the slices as contents.
+
+def make_dictionary(key, value):
+    keys = cppyy.gbl.std.list[string]()
+    keys.push_back(string(key))
+    values = cppyy.gbl.std.list[Attribute.Ptr]()
+    values.push_back(IntAttribute(value))
+    return Dictionary.ByKeysValues(keys, values)
+
+def int_value(topology, key):
+    attribute = topology.GetDictionary().ValueAtKey(string(key))
+    if not attribute:
+        return None
+    return cppyy.bind_object(attribute.Value(), 'IntegerStruct').getInteger
+
+def horizontal_square(z):
+    vertices = [Vertex.ByCoordinates(x, y, z) for (x, y) in [(-1, -1), (2, -1), (2, 2), (-1, 2)]]
+    edges = cppyy.gbl.std.list[Edge.Ptr]()
+    for i in range(4):
+        edges.push_back(Edge.ByStartVertexEndVertex(vertices[i], vertices[(i + 1) % 4]))
+    return Face.ByEdges(edges)
+
+def storeys(topology):
+    cells = cppyy.gbl.std.list[Cell.Ptr]()
+    topology.Cells(cells)
+    return sorted((round(cell.CenterOfMass().Z(), 6), round(CellUtility.Volume(cell), 6)) for cell in cells)
+
+box = CellUtility.ByCuboid(0.5, 0.5, 1.5, 1, 1, 3, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+box.SetDictionary(make_dictionary("building", 1))
+options = BooleanOptions()
+threeStoreys = [(0.5, 1.0), (1.5, 1.0), (2.5, 1.0)]
+
+# Two tools in one run, and one after the other.
+tools = cppyy.gbl.std.list[Topology.Ptr]()
+tools.push_back(horizontal_square(1))
+tools.push_back(horizontal_square(2))
+inOneRun = box.Slice(tools, options, False)
+oneAfterTheOther = box.Slice(horizontal_square(1), False).Slice(horizontal_square(2), False)
+print(str(storeys(inOneRun)) + " <--- Should be " + str(threeStoreys))
+assert storeys(inOneRun) == threeStoreys
+assert storeys(oneAfterTheOther) == threeStoreys
+
+# Planes 1 apart: those on the bottom and top faces are left out.
+byPlanes = box.Slice(0, 0, 0, 0, 0, 1, 1, options, True)
+assert storeys(byPlanes) == threeStoreys
+assert int_value(byPlanes, "building") == 1
+
+# A spacing larger than the box uses no plane.
+unsliced = box.Slice(0, 0, 0, 0, 0, 1, 10, options, True)
+print(str(storeys(unsliced)) + " <--- Should be [(1.5, 3.0)]")
+assert storeys(unsliced) == [(1.5, 3.0)]
+print(str(int_value(unsliced, "building")) + " <--- Should be 1")
+assert int_value(unsliced, "building") == 1
+
+# Too many planes, and degenerate planes, are rejected.
+for (normal, spacing) in [((0, 0, 1), 1e-6), ((0, 0, 1), 0), ((0, 0, 0), 1)]:
+    try:
+        box.Slice(0, 0, 0, normal[0], normal[1], normal[2], spacing, options, False)
+    except Exception:
+        print("The planes were rejected <--- Should be rejected")
+    else:
+        assert False
+
+# Divide keeps the box and adds the storeys as its contents.
+for divided in [box.Divide(tools, options, False), box.Divide(0, 0, 0, 0, 0, 1, 1, options, False)]:
+    assert storeys(divided) == [(1.5, 3.0)]
+    contents = cppyy.gbl.std.list[Topology.Ptr]()
+    divided.Contents(contents)
+    print(str(sorted(storeys(content)[0] for content in contents)) + " <--- Should be " + str(threeStoreys))
+    assert sorted(storeys(content)[0] for content in contents) == threeStoreys
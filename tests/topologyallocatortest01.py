@@ -0,0 +1,48 @@
+from topologic import Vertex, Edge, Face, Cell, CellComplex, CellUtility, TopologyArena
+import cppyy
+
+# Checks that PooledNavigate, whose wrappers come from the TopologyPool or from an open TopologyArena, finds the same
+# sub-topologies and ancestors as the compiled navigation, and that wrappers outliving their arena scope stay valid.
+
+def cuboid(x):
+    return CellUtility.ByCuboid(x, 0.5, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def pooled(topology, subclass):
+    members = cppyy.gbl.std.list[subclass.Ptr]()
+    topology.PooledNavigate[subclass](members)
+    return list(members)
+
+cells = cppyy.gbl.std.list[Cell.Ptr]()
+cells.push_back(cuboid(0.5))
+cells.push_back(cuboid(1.5))
+cellComplex = CellComplex.ByCells(cells)
+
+def check():
+    # Downward, from the cell complex.
+    for (subclass, navigate) in [(Vertex, cellComplex.Vertices), (Edge, cellComplex.Edges), (Face, cellComplex.Faces), (Cell, cellComplex.Cells)]:
+        compiled = cppyy.gbl.std.list[subclass.Ptr]()
+        navigate(compiled)
+        assert set(pooled(cellComplex, subclass)) == set(compiled)
+        assert len(pooled(cellComplex, subclass)) == compiled.size()
+
+    # Upward, from each face to its cells.
+    faces = cppyy.gbl.std.list[Face.Ptr]()
+    cellComplex.Faces(faces)
+    for face in faces:
+        compiled = cppyy.gbl.std.list[Cell.Ptr]()
+        face.Cells(compiled)
+        assert set(pooled(face, Cell)) == set(compiled)
+
+check()
+
+scope = TopologyArena.Scope()
+check()
+escapedFaces = pooled(cellComplex, Face)
+del scope
+
+# The faces allocated in the arena outlive its scope.
+sumOfHeights = sum(face.CenterOfMass().Z() for face in escapedFaces)
+print(str(len(escapedFaces)) + " <--- Should be 11")
+assert len(escapedFaces) == 11
+print(str(round(sumOfHeights, 6)) + " <--- Should be 5.5")
+assert round(sumOfHeights, 6) == 5.5
@@ -0,0 +1,64 @@
+from topologic import Face, Cell, CellComplex, CellUtility, Topology, TopologyFilter
+import cppyy
+
+# Checks the predicates of TopologyFilter on a unit cube and on a complex of two unit cubes, and that Apply skips
+# null entries like Topology::Filter.
+
+def cuboid(x):
+    return CellUtility.ByCuboid(x, 0.5, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+
+def select(topologyFilter, topology):
+    selected = cppyy.gbl.std.list[Topology.Ptr]()
+    topologyFilter.Select(topology, selected)
+    return list(selected)
+
+cube = cuboid(0.5)
+cells = cppyy.gbl.std.list[Cell.Ptr]()
+cells.push_back(cuboid(0.5))
+cells.push_back(cuboid(1.5))
+cellComplex = CellComplex.ByCells(cells)
+
+# External faces have one cell, the internal face two.
+externalFaces = select(TopologyFilter(Face.Type()).NumOfAncestors(cellComplex, Cell.Type(), 1, 1), cellComplex)
+internalFaces = select(TopologyFilter(Face.Type()).NumOfAncestors(cellComplex, Cell.Type(), 2, 2), cellComplex)
+print(str(len(externalFaces)) + " <--- Should be 10")
+assert len(externalFaces) == 10
+print(str(len(internalFaces)) + " <--- Should be 1")
+assert len(internalFaces) == 1
+print(str(round(internalFaces[0].CenterOfMass().X(), 6)) + " <--- Should be 1.0")
+assert round(internalFaces[0].CenterOfMass().X(), 6) == 1.0
+
+# Only faces have an area; the cube itself is rejected.
+print(str(len(select(TopologyFilter().Area(0.5, 1.5), cube))) + " <--- Should be 6")
+assert len(select(TopologyFilter().Area(0.5, 1.5), cube)) == 6
+assert len(select(TopologyFilter(Face.Type()).Area(1.5, 2.5), cube)) == 0
+
+# The south-facing face.
+southFaces = select(TopologyFilter(Face.Type()).Normal(0, -1, 0, 45), cube)
+print(str(len(southFaces)) + " <--- Should be 1")
+assert len(southFaces) == 1
+print(str(round(southFaces[0].CenterOfMass().Y(), 6)) + " <--- Should be 0.0")
+assert round(southFaces[0].CenterOfMass().Y(), 6) == 0.0
+try:
+    TopologyFilter(Face.Type()).Normal(0, 0, 0, 45)
+except Exception:
+    print("The zero direction was rejected <--- Should be rejected")
+else:
+    assert False
+
+# A predicate on the wrapped topology, after an OCCT predicate.
+topFaces = select(TopologyFilter(Face.Type()).Area(0.5, 1.5).WhereTopology(lambda topology: topology.CenterOfMass().Z() > 0.9), cube)
+print(str(len(topFaces)) + " <--- Should be 1")
+assert len(topFaces) == 1
+
+# Apply skips null entries and keeps the order of the others.
+faces = select(TopologyFilter(Face.Type()), cube)
+topologies = cppyy.gbl.std.list[Topology.Ptr]()
+topologies.push_back(cppyy.nullptr)
+for face in faces:
+    topologies.push_back(face)
+    topologies.push_back(cppyy.nullptr)
+filtered = cppyy.gbl.std.list[Topology.Ptr]()
+TopologyFilter(Face.Type()).Area(0.5, 1.5).Apply(topologies, filtered)
+print(str(filtered.size()) + " <--- Should be 6")
+assert list(filtered) == faces
@@ -0,0 +1,62 @@
+from topologic import Vertex, Edge, Face, CellUtility, Topology, TopologySet, TopologyMap
+import cppyy
+import ctypes
+
+# Checks that TopologySet, TopologyMap and TopologySet.Unique identify the wrappers of the same sub-topology found through
+# different navigations, and that Python sets of topologies do the same.
+
+cube = CellUtility.ByCuboid(0.5, 0.5, 0.5, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0)
+faces = cppyy.gbl.std.list[Face.Ptr]()
+cube.Faces(faces)
+
+# Each of the 12 edges is found once from each of its 2 faces, as a distinct wrapper.
+edges = cppyy.gbl.std.list[Topology.Ptr]()
+for face in faces:
+    faceEdges = cppyy.gbl.std.list[Edge.Ptr]()
+    face.Edges(faceEdges)
+    for edge in faceEdges:
+        edges.push_back(edge)
+print(str(edges.size()) + " <--- Should be 24")
+assert edges.size() == 24
+
+topologySet = TopologySet(edges)
+print(str(topologySet.Size()) + " <--- Should be 12")
+assert topologySet.Size() == 12
+assert not topologySet.AddTopology(edges.front())
+assert topologySet.RemoveTopology(edges.front())
+assert not topologySet.Contains(edges.front())
+assert not topologySet.RemoveTopology(edges.front())
+assert topologySet.AddTopology(edges.front())
+assert not topologySet.Contains(Vertex.ByCoordinates(0, 0, 0))
+
+# Unique keeps the first occurrence and the order.
+uniqueEdges = cppyy.gbl.std.list[Topology.Ptr]()
+TopologySet.Unique(edges, uniqueEdges)
+print(str(uniqueEdges.size()) + " <--- Should be 12")
+assert uniqueEdges.size() == 12
+firstOccurrences = []
+for edge in edges:
+    if not any(edge.IsSame(uniqueEdge) for uniqueEdge in firstOccurrences):
+        firstOccurrences.append(edge)
+assert all(a.IsSame(b) for (a, b) in zip(uniqueEdges, firstOccurrences))
+
+# Counting the faces of each edge.
+numOfFaces = TopologyMap[int]()
+for edge in edges:
+    count = ctypes.c_int(0)
+    numOfFaces.Find(edge, count)
+    numOfFaces.Set(edge, count.value + 1)
+print(str(numOfFaces.Size()) + " <--- Should be 12")
+assert numOfFaces.Size() == 12
+for edge in uniqueEdges:
+    count = ctypes.c_int(0)
+    assert numOfFaces.Find(edge, count)
+    assert count.value == 2
+assert numOfFaces.Remove(edges.front())
+assert not numOfFaces.Contains(edges.front())
+assert numOfFaces.Size() == 11
+
+# Python sets and dictionaries use the same identity.
+print(str(len(set(edges))) + " <--- Should be 12")
+assert len(set(edges)) == 12
+assert set(edges) == set(uniqueEdges)